@@ -1,4 +1,5 @@
 #include "Blending.hpp"
+#include "Core/Marco.hpp"
 namespace RealSix
 {
     bool IsInHierarchy(const Pose &pose, uint32_t parent, uint32_t search)
@@ -15,7 +16,7 @@ namespace RealSix
         return false;
     }
 
-    Pose Blend(const Pose &a, const Pose &b, float t, int root)
+    REALSIX_TARGET_CLONES Pose Blend(const Pose &a, const Pose &b, float t, int root)
     {
         Pose result = a;
         for (uint32_t i = 0; i < a.BoneSize(); ++i)
@@ -34,7 +35,7 @@ namespace RealSix
         clip.Sample(result, clip.GetStartTime());
         return result;
     }
-    Pose AddAdditivePose(const Pose &inPose, const Pose &addPose, const Pose &additiveBasePose, int blendRoot)
+    REALSIX_TARGET_CLONES Pose AddAdditivePose(const Pose &inPose, const Pose &addPose, const Pose &additiveBasePose, int blendRoot)
     {
         Pose resultPose = inPose;
 
@@ -1,5 +1,8 @@
 #include "Pose.hpp"
 #include "Math/Quaternion.hpp"
+#include "Core/Marco.hpp"
+#include "Core/Memory.hpp"
+#include <cassert>
 
 namespace RealSix
 {
@@ -58,7 +61,7 @@ namespace RealSix
         mBones[index] = std::make_tuple(std::get<0>(mBones[index]), transform);
     }
 
-    Transform3f Pose::GetGlobalTransform(uint32_t index) const
+    REALSIX_TARGET_CLONES Transform3f Pose::GetGlobalTransform(uint32_t index) const
     {
         auto result = std::get<1>(mBones[index]);
         for (int p = std::get<0>(mBones[index]); p >= 0; p = std::get<0>(mBones[p]))
@@ -72,26 +75,59 @@ namespace RealSix
 
     std::vector<Matrix4f> Pose::GetMatrixPalette() const
     {
-        std::vector<Matrix4f> result;
+        std::vector<Matrix4f> result(BoneSize());
+        GetMatrixPalette(result);
+        return result;
+    }
+
+    REALSIX_TARGET_CLONES void Pose::GetMatrixPalette(std::span<Matrix4f> out) const
+    {
+        assert(out.size() >= BoneSize());
         for (uint32_t i = 0; i < BoneSize(); ++i)
         {
             Transform3f t = GetGlobalTransform(i);
-            result.emplace_back(Transform3f::ToMatrix4(t));
+            out[i] = Transform3f::ToMatrix4(t);
         }
-        return result;
     }
 
     std::vector<DualQuaternionf> Pose::GetDualQuaternionPalette() const
     {
-        std::vector<DualQuaternionf> result;
+        std::vector<DualQuaternionf> result(BoneSize());
+        GetDualQuaternionPalette(result);
+        return result;
+    }
+
+    REALSIX_TARGET_CLONES void Pose::GetDualQuaternionPalette(std::span<DualQuaternionf> out) const
+    {
+        // Every bone reuses the global dual quaternion of its parent instead of walking up to the root,
+        // the chain only holds the ancestors not resolved yet when a child comes before its parent
+        uint32_t size = BoneSize();
+        assert(out.size() >= size);
 
-        for (uint32_t i = 0; i < BoneSize(); ++i)
-            result.emplace_back(GetGlobalDualQuaternion(i));
+        ScratchScope scratch;
+        ScratchVector<uint8_t> resolved(size, 0, scratch.GetAllocator<uint8_t>());
+        ScratchVector<uint32_t> chain(scratch.GetAllocator<uint32_t>());
 
-        return result;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            for (int p = i; p >= 0 && !resolved[p]; p = std::get<0>(mBones[p]))
+                chain.emplace_back(p);
+
+            while (!chain.empty())
+            {
+                uint32_t bone = chain.back();
+                chain.pop_back();
+
+                int parent = std::get<0>(mBones[bone]);
+                out[bone] = Transform3f::ToDualQuaternion(std::get<1>(mBones[bone]));
+                if (parent >= 0)
+                    out[bone] = out[bone] * out[parent];
+                resolved[bone] = 1;
+            }
+        }
     }
 
-    DualQuaternionf Pose::GetGlobalDualQuaternion(uint32_t index) const
+    REALSIX_TARGET_CLONES DualQuaternionf Pose::GetGlobalDualQuaternion(uint32_t index) const
     {
         DualQuaternionf result = Transform3f::ToDualQuaternion(std::get<1>(mBones[index]));
         for (int p = std::get<0>(mBones[index]); p >= 0; p = std::get<0>(mBones[p]))
@@ -2,6 +2,7 @@
 #include "Math/Transform.hpp"
 #include "Math/Matrix4.hpp"
 #include "Math/DualQuaternion.hpp"
+#include <span>
 #include <vector>
 #include <tuple>
 
@@ -29,8 +30,12 @@ namespace RealSix
         Transform3f operator[](uint32_t index);
 
         std::vector<Matrix4f> GetMatrixPalette() const;
+        // Fills BoneSize() entries of out, e.g. FrameAllocator::GetInstance().AllocateArray<Matrix4f>(pose.BoneSize())
+        // for a palette uploaded this frame without a heap allocation
+        void GetMatrixPalette(std::span<Matrix4f> out) const;
 
         std::vector<DualQuaternionf> GetDualQuaternionPalette() const;
+        void GetDualQuaternionPalette(std::span<DualQuaternionf> out) const;
 
         DualQuaternionf GetGlobalDualQuaternion(uint32_t index) const;
 
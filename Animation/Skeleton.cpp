@@ -71,7 +71,7 @@ namespace RealSix
         for (uint32_t i = 0; i < size; ++i)
         {
             Transform3f world = mBindPose.GetGlobalTransform(i);
-            mInverseBindPoseMatrix4Form[i] = Matrix4f::Inverse(Transform3f::ToMatrix4(world));
+            mInverseBindPoseMatrix4Form[i] = Matrix4f::InverseAffine(Transform3f::ToMatrix4(world));
         }
     }
 
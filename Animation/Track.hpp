@@ -164,8 +164,8 @@ namespace RealSix
     template <typename T, int32_t N>
     inline T Track<T, N>::Hermite(float time, const T &p1, const T &s1, const T &p2, const T &s2)
     {
-        float timeSquare = Math::Pow(time,2);
-        float timeCubic = Math::Pow(time,3);
+        float timeSquare = time * time;
+        float timeCubic = timeSquare * time;
         T tmp_p2 = p2;
         Neighborhood(p1, tmp_p2);
         float h1 = 2.0f * timeCubic - 3.0f * timeSquare + 1.0f;
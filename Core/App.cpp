@@ -1,7 +1,9 @@
 #include "App.hpp"
 #include "Core/Logger.hpp"
 #include "Core/Config.hpp"
+#include "Core/JobSystem.hpp"
 #include "Platform/PlatformInfo.hpp"
+#include "Script/FiberScheduler.hpp"
 
 namespace RealSix
 {
@@ -52,6 +54,7 @@ namespace RealSix
 	void App::Init()
 	{
 		PlatformInfo::GetInstance().Init();
+		JobSystem::GetInstance().Init(AppConfig::GetInstance().GetJobWorkerCount().value_or(JobSystem::GetDefaultWorkerCount()));
 
 		mWindow.reset(Window::Create());
 		mWindow->Show();
@@ -63,6 +66,7 @@ namespace RealSix
 
 	void App::Tick()
 	{
+		Script::FiberScheduler::GetInstance().Tick();
 	}
 
 	void App::Render()
@@ -80,12 +84,14 @@ namespace RealSix
 
 	void App::CleanUp()
 	{
+		JobSystem::GetInstance().Shutdown();
 		PlatformInfo::GetInstance().CleanUp();
 	}
 
 	void App::PreTick()
 	{
 		mInputSystem->PreTick(mWindow.get());
+		JobSystem::GetInstance().RunMainThreadJobs();
 
 		if (AppConfig::GetInstance().IsRefreshOnlyWindowIsActive() && GetWindow()->HasEvent(Window::Event::MIN))
 			mState = AppState::PAUSE;
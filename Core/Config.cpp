@@ -13,6 +13,17 @@ namespace RealSix
         return mRefreshOnlyWindowIsActive;
     }
 
+    AppConfig &AppConfig::SetJobWorkerCount(uint32_t count)
+    {
+        mJobWorkerCount = count;
+        return *this;
+    }
+
+    std::optional<uint32_t> AppConfig::GetJobWorkerCount() const
+    {
+        return mJobWorkerCount;
+    }
+
     GfxConfig &GfxConfig::SetBackend(GfxBackend backend)
     {
         mBackend = backend;
@@ -116,6 +127,72 @@ namespace RealSix
         return mSerializeBinaryFilePath;
     }
 
+    ScriptConfig &ScriptConfig::SetExecuteBinaryChunk(bool toggle)
+    {
+        mIsExecuteBinaryChunk = toggle;
+        return *this;
+    }
+
+    bool ScriptConfig::IsExecuteBinaryChunk() const
+    {
+        return mIsExecuteBinaryChunk;
+    }
+
+    ScriptConfig &ScriptConfig::SetProfile(bool toggle)
+    {
+        mIsProfile = toggle;
+        return *this;
+    }
+
+    bool ScriptConfig::IsProfile() const
+    {
+        return mIsProfile;
+    }
+
+    ScriptConfig &ScriptConfig::SetProfileFilePath(StringView path)
+    {
+        mProfileFilePath = path;
+        return *this;
+    }
+
+    StringView ScriptConfig::GetProfileFilePath() const
+    {
+        return mProfileFilePath;
+    }
+
+    ScriptConfig &ScriptConfig::SetProfileSampleInterval(uint32_t instructionCount)
+    {
+        mProfileSampleInterval = instructionCount;
+        return *this;
+    }
+
+    uint32_t ScriptConfig::GetProfileSampleInterval() const
+    {
+        return mProfileSampleInterval;
+    }
+
+    ScriptConfig &ScriptConfig::SetCheckpointBudget(uint64_t checkpointCount)
+    {
+        mCheckpointBudget = checkpointCount;
+        return *this;
+    }
+
+    uint64_t ScriptConfig::GetCheckpointBudget() const
+    {
+        return mCheckpointBudget;
+    }
+
+    ScriptConfig &ScriptConfig::SetTimeBudget(double milliseconds)
+    {
+        mTimeBudget = milliseconds;
+        return *this;
+    }
+
+    double ScriptConfig::GetTimeBudget() const
+    {
+        return mTimeBudget;
+    }
+
     String ScriptConfig::ToFullPath(StringView filePath)
     {
         std::filesystem::path filesysPath = filePath.GetRawData();
@@ -1,4 +1,5 @@
 #pragma once
+#include <optional>
 #include "Core/Common.hpp"
 #include "Core/Marco.hpp"
 namespace RealSix
@@ -8,9 +9,14 @@ namespace RealSix
     public:
         AppConfig &SetRefreshOnlyWindowIsActive(bool isActive);
         bool IsRefreshOnlyWindowIsActive();
+        // Worker threads of the job system, unset for one per logical core besides the main thread. With 0 the
+        // main thread runs every job
+        AppConfig &SetJobWorkerCount(uint32_t count);
+        std::optional<uint32_t> GetJobWorkerCount() const;
 
     private:
         bool mRefreshOnlyWindowIsActive{true};
+        std::optional<uint32_t> mJobWorkerCount;
     };
 
     enum class GfxBackend : uint8_t
@@ -87,6 +93,26 @@ namespace RealSix
         ScriptConfig &SetSerializeBinaryFilePath(StringView path);
         StringView GetSerializeBinaryFilePath() const;
 
+        ScriptConfig &SetExecuteBinaryChunk(bool toggle);
+        bool IsExecuteBinaryChunk() const;
+
+        ScriptConfig &SetProfile(bool toggle);
+        bool IsProfile() const;
+
+        ScriptConfig &SetProfileFilePath(StringView path);
+        StringView GetProfileFilePath() const;
+
+        ScriptConfig &SetProfileSampleInterval(uint32_t instructionCount);
+        uint32_t GetProfileSampleInterval() const;
+
+        // Execution budget of one VM::Run or VM::Continue call, 0 for no limit. It is checked at loop back-edges and
+        // calls, a script using it up is suspended there and continues on the next VM::Continue
+        ScriptConfig &SetCheckpointBudget(uint64_t checkpointCount);
+        uint64_t GetCheckpointBudget() const;
+
+        ScriptConfig &SetTimeBudget(double milliseconds);
+        double GetTimeBudget() const;
+
         String ToFullPath(StringView filePath);
 
     private:
@@ -97,6 +123,15 @@ namespace RealSix
         bool mIsSerializeBinaryChunk{false};
         StringView mSerializeBinaryFilePath;
 
+        bool mIsExecuteBinaryChunk{false};
+
+        bool mIsProfile{false};
+        StringView mProfileFilePath;
+        uint32_t mProfileSampleInterval{1000};
+
+        uint64_t mCheckpointBudget{0};
+        double mTimeBudget{0.0};
+
 #ifndef NDEBUG
     public:
         ScriptConfig &SetDebugGC(bool toggle);
@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+namespace RealSix
+{
+    // Sorted array map for small tables that are built once and then read or iterated: one allocation,
+    // no per node overhead and contiguous iteration in key order. Lookups are a binary search, prefer
+    // HashMap where lookups dominate. Inserting and erasing shift the tail, and like std::vector any
+    // insertion invalidates iterators and references. Keys must not be modified through the iterators
+    template <typename Key, typename Value, typename Compare = std::less<Key>, typename Container = std::vector<std::pair<Key, Value>>>
+    class FlatMap
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using size_type = size_t;
+        using iterator = typename Container::iterator;
+        using const_iterator = typename Container::const_iterator;
+
+        FlatMap() = default;
+
+        FlatMap(std::initializer_list<value_type> values)
+        {
+            for (const auto &value : values)
+                insert(value);
+        }
+
+        iterator begin() { return mElements.begin(); }
+        const_iterator begin() const { return mElements.begin(); }
+        iterator end() { return mElements.end(); }
+        const_iterator end() const { return mElements.end(); }
+
+        bool empty() const { return mElements.empty(); }
+        size_t size() const { return mElements.size(); }
+        void reserve(size_t count) { mElements.reserve(count); }
+        void clear() { mElements.clear(); }
+
+        iterator lower_bound(const Key &key)
+        {
+            return mElements.begin() + LowerBoundIndex(key);
+        }
+
+        const_iterator lower_bound(const Key &key) const
+        {
+            return mElements.begin() + LowerBoundIndex(key);
+        }
+
+        iterator find(const Key &key)
+        {
+            auto iter = lower_bound(key);
+            return iter != end() && !Compare{}(key, iter->first) ? iter : end();
+        }
+
+        const_iterator find(const Key &key) const
+        {
+            auto iter = lower_bound(key);
+            return iter != end() && !Compare{}(key, iter->first) ? iter : end();
+        }
+
+        bool contains(const Key &key) const
+        {
+            return find(key) != end();
+        }
+
+        size_t count(const Key &key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        Value &at(const Key &key)
+        {
+            auto iter = find(key);
+            assert(iter != end());
+            return iter->second;
+        }
+
+        const Value &at(const Key &key) const
+        {
+            auto iter = find(key);
+            assert(iter != end());
+            return iter->second;
+        }
+
+        Value &operator[](const Key &key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+        {
+            auto iter = lower_bound(key);
+            if (iter != end() && !Compare{}(key, iter->first))
+                return {iter, false};
+            return {mElements.emplace(iter, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true};
+        }
+
+        std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Args &&...args)
+        {
+            value_type value(std::forward<Args>(args)...);
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        template <typename V>
+        std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value)
+        {
+            auto result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+                result.first->second = std::forward<V>(value);
+            return result;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return mElements.erase(pos);
+        }
+
+        size_t erase(const Key &key)
+        {
+            auto iter = find(key);
+            if (iter == end())
+                return 0;
+            mElements.erase(iter);
+            return 1;
+        }
+
+        friend bool operator==(const FlatMap &lhs, const FlatMap &rhs)
+        {
+            return lhs.mElements == rhs.mElements;
+        }
+
+    private:
+        // Halves the range without a data dependent branch so the compiler emits conditional moves,
+        // random lookups in small tables would mispredict half of the std::lower_bound branches
+        size_t LowerBoundIndex(const Key &key) const
+        {
+            size_t first = 0;
+            size_t length = mElements.size();
+            while (length > 0)
+            {
+                const size_t half = length / 2;
+                first = Compare{}(mElements[first + half].first, key) ? first + length - half : first;
+                length = half;
+            }
+            return first;
+        }
+
+        Container mElements;
+    };
+}
@@ -0,0 +1,386 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+namespace RealSix
+{
+    // Open addressing hash map with linear probing in a power of two table of inline pairs, erase
+    // shifts the following entries back so there are no tombstones. Lookups touch one or two cache
+    // lines instead of the bucket list of std::unordered_map. Rehashing moves the entries, so unlike
+    // std::unordered_map any insertion or erase invalidates iterators, references and pointers.
+    // Keys must not be modified through the iterators
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class HashMap
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using size_type = size_t;
+
+        template <bool IsConst>
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = HashMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IsConst, const value_type *, value_type *>;
+            using reference = std::conditional_t<IsConst, const value_type &, value_type &>;
+            using Owner = std::conditional_t<IsConst, const HashMap, HashMap>;
+
+            Iterator() = default;
+            Iterator(Owner *owner, size_t index)
+                : mOwner(owner), mIndex(index)
+            {
+                SkipEmpty();
+            }
+
+            operator Iterator<true>() const
+                requires(!IsConst)
+            {
+                return Iterator<true>(mOwner, mIndex);
+            }
+
+            reference operator*() const { return mOwner->mSlots[mIndex]; }
+            pointer operator->() const { return &mOwner->mSlots[mIndex]; }
+
+            Iterator &operator++()
+            {
+                ++mIndex;
+                SkipEmpty();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator result = *this;
+                ++(*this);
+                return result;
+            }
+
+            friend bool operator==(const Iterator &lhs, const Iterator &rhs) { return lhs.mIndex == rhs.mIndex; }
+            friend bool operator!=(const Iterator &lhs, const Iterator &rhs) { return lhs.mIndex != rhs.mIndex; }
+
+        private:
+            friend class HashMap;
+
+            void SkipEmpty()
+            {
+                while (mIndex < mOwner->mCapacity && !mOwner->mUsed[mIndex])
+                    ++mIndex;
+            }
+
+            Owner *mOwner{nullptr};
+            size_t mIndex{0};
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        HashMap() = default;
+
+        explicit HashMap(size_t count)
+        {
+            reserve(count);
+        }
+
+        HashMap(std::initializer_list<value_type> values)
+        {
+            reserve(values.size());
+            for (const auto &value : values)
+                insert(value);
+        }
+
+        HashMap(const HashMap &other)
+        {
+            reserve(other.size());
+            for (const auto &element : other)
+                insert(element);
+        }
+
+        HashMap(HashMap &&other) noexcept
+        {
+            Swap(other);
+        }
+
+        ~HashMap()
+        {
+            clear();
+            Deallocate();
+        }
+
+        HashMap &operator=(const HashMap &other)
+        {
+            if (this != &other)
+            {
+                HashMap copy(other);
+                Swap(copy);
+            }
+            return *this;
+        }
+
+        HashMap &operator=(HashMap &&other) noexcept
+        {
+            if (this != &other)
+            {
+                HashMap moved(std::move(other));
+                Swap(moved);
+            }
+            return *this;
+        }
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        iterator end() { return iterator(this, mCapacity); }
+        const_iterator end() const { return const_iterator(this, mCapacity); }
+
+        bool empty() const { return mSize == 0; }
+        size_t size() const { return mSize; }
+        size_t bucket_count() const { return mCapacity; }
+
+        void clear()
+        {
+            for (size_t i = 0; i < mCapacity; ++i)
+            {
+                if (mUsed[i])
+                {
+                    std::destroy_at(mSlots + i);
+                    mUsed[i] = false;
+                }
+            }
+            mSize = 0;
+        }
+
+        // Makes room for count entries without rehashing
+        void reserve(size_t count)
+        {
+            size_t capacity = MIN_CAPACITY;
+            while (capacity * MAX_LOAD_NUMERATOR < count * MAX_LOAD_DENOMINATOR)
+                capacity *= 2;
+            if (capacity > mCapacity)
+                Rehash(capacity);
+        }
+
+        iterator find(const Key &key)
+        {
+            return iterator(this, FindIndex(key));
+        }
+
+        const_iterator find(const Key &key) const
+        {
+            return const_iterator(this, FindIndex(key));
+        }
+
+        bool contains(const Key &key) const
+        {
+            return FindIndex(key) != mCapacity;
+        }
+
+        size_t count(const Key &key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        Value &at(const Key &key)
+        {
+            const size_t index = FindIndex(key);
+            assert(index != mCapacity);
+            return mSlots[index].second;
+        }
+
+        const Value &at(const Key &key) const
+        {
+            const size_t index = FindIndex(key);
+            assert(index != mCapacity);
+            return mSlots[index].second;
+        }
+
+        Value &operator[](const Key &key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        template <typename K, typename... Args>
+        std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+        {
+            size_t index = 0;
+            if (mCapacity != 0)
+            {
+                index = HomeIndex(key);
+                while (mUsed[index])
+                {
+                    if (KeyEqual{}(mSlots[index].first, key))
+                        return {iterator(this, index), false};
+                    index = (index + 1) & (mCapacity - 1);
+                }
+            }
+
+            if ((mSize + 1) * MAX_LOAD_DENOMINATOR > mCapacity * MAX_LOAD_NUMERATOR)
+            {
+                // Build the entry before growing, key and args may refer into the storage Rehash frees
+                value_type value(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+                Rehash(mCapacity == 0 ? MIN_CAPACITY : mCapacity * 2);
+                index = HomeIndex(value.first);
+                while (mUsed[index])
+                    index = (index + 1) & (mCapacity - 1);
+                ::new (static_cast<void *>(mSlots + index)) value_type(std::move(value));
+            }
+            else
+                ::new (static_cast<void *>(mSlots + index)) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+
+            mUsed[index] = true;
+            ++mSize;
+            return {iterator(this, index), true};
+        }
+
+        std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Args &&...args)
+        {
+            value_type value(std::forward<Args>(args)...);
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        template <typename V>
+        std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value)
+        {
+            auto result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+                result.first->second = std::forward<V>(value);
+            return result;
+        }
+
+        size_t erase(const Key &key)
+        {
+            const size_t index = FindIndex(key);
+            if (index == mCapacity)
+                return 0;
+            EraseIndex(index);
+            return 1;
+        }
+
+        void erase(const_iterator pos)
+        {
+            assert(pos.mIndex < mCapacity && mUsed[pos.mIndex]);
+            EraseIndex(pos.mIndex);
+        }
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 8;
+        // Rehash beyond 3/4 full, linear probing degrades quickly past that
+        static constexpr size_t MAX_LOAD_NUMERATOR = 3;
+        static constexpr size_t MAX_LOAD_DENOMINATOR = 4;
+
+        // Fibonacci hashing, spreads the identity std::hash of integers over the whole table
+        size_t HomeIndex(const Key &key) const
+        {
+            return static_cast<size_t>((static_cast<uint64_t>(Hash{}(key)) * 0x9e3779b97f4a7c15ull) >> mShift);
+        }
+
+        size_t FindIndex(const Key &key) const
+        {
+            if (mSize == 0)
+                return mCapacity;
+            size_t index = HomeIndex(key);
+            while (mUsed[index])
+            {
+                if (KeyEqual{}(mSlots[index].first, key))
+                    return index;
+                index = (index + 1) & (mCapacity - 1);
+            }
+            return mCapacity;
+        }
+
+        // Backward shift deletion: pulls later entries of the probe run into the hole unless that
+        // would move them in front of their home slot
+        void EraseIndex(size_t hole)
+        {
+            std::destroy_at(mSlots + hole);
+            mUsed[hole] = false;
+            --mSize;
+
+            const size_t mask = mCapacity - 1;
+            for (size_t index = (hole + 1) & mask; mUsed[index]; index = (index + 1) & mask)
+            {
+                const size_t home = HomeIndex(mSlots[index].first);
+                if (((index - home) & mask) < ((index - hole) & mask))
+                    continue;
+                ::new (static_cast<void *>(mSlots + hole)) value_type(std::move(mSlots[index]));
+                mUsed[hole] = true;
+                std::destroy_at(mSlots + index);
+                mUsed[index] = false;
+                hole = index;
+            }
+        }
+
+        void Rehash(size_t newCapacity)
+        {
+            value_type *oldSlots = mSlots;
+            bool *oldUsed = mUsed;
+            const size_t oldCapacity = mCapacity;
+
+            mSlots = static_cast<value_type *>(::operator new(newCapacity * sizeof(value_type), std::align_val_t{alignof(value_type)}));
+            mUsed = new bool[newCapacity]();
+            mCapacity = newCapacity;
+            mShift = 64;
+            for (size_t capacity = newCapacity; capacity > 1; capacity >>= 1)
+                --mShift;
+
+            for (size_t i = 0; i < oldCapacity; ++i)
+            {
+                if (!oldUsed[i])
+                    continue;
+                size_t index = HomeIndex(oldSlots[i].first);
+                while (mUsed[index])
+                    index = (index + 1) & (mCapacity - 1);
+                ::new (static_cast<void *>(mSlots + index)) value_type(std::move(oldSlots[i]));
+                mUsed[index] = true;
+                std::destroy_at(oldSlots + i);
+            }
+
+            if (oldSlots)
+                ::operator delete(static_cast<void *>(oldSlots), std::align_val_t{alignof(value_type)});
+            delete[] oldUsed;
+        }
+
+        void Deallocate()
+        {
+            if (mSlots)
+                ::operator delete(static_cast<void *>(mSlots), std::align_val_t{alignof(value_type)});
+            delete[] mUsed;
+            mSlots = nullptr;
+            mUsed = nullptr;
+            mCapacity = 0;
+        }
+
+        void Swap(HashMap &other) noexcept
+        {
+            std::swap(mSlots, other.mSlots);
+            std::swap(mUsed, other.mUsed);
+            std::swap(mCapacity, other.mCapacity);
+            std::swap(mSize, other.mSize);
+            std::swap(mShift, other.mShift);
+        }
+
+        value_type *mSlots{nullptr};
+        bool *mUsed{nullptr};
+        size_t mCapacity{0};
+        size_t mSize{0};
+        uint32_t mShift{64};
+    };
+}
@@ -0,0 +1,358 @@
+#include "JobSystem.hpp"
+#include <cassert>
+#include <thread>
+namespace RealSix
+{
+    namespace Detail
+    {
+        struct Job
+        {
+            std::function<void()> function;
+            JobCounter *counter{nullptr};
+            bool mainThread{false};
+        };
+
+        // Chase-Lev work stealing deque with the C11 orderings of Le et al., "Correct and Efficient
+        // Work-Stealing for Weak Memory Models". Fixed capacity, the owner falls back to the injection
+        // queue when it is full
+        class JobDeque
+        {
+        public:
+            static constexpr int64_t CAPACITY = 4096;
+
+            // Owner only
+            bool Push(Job *job)
+            {
+                const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+                const int64_t top = mTop.load(std::memory_order_acquire);
+                if (bottom - top >= CAPACITY)
+                    return false;
+                mBuffer[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+                // A release store instead of the paper's release fence, same guarantee and visible to ThreadSanitizer
+                mBottom.store(bottom + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Owner only, newest job first
+            Job *Pop()
+            {
+                const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+                mBottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = mTop.load(std::memory_order_relaxed);
+
+                if (top > bottom)
+                {
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                Job *job = mBuffer[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+                if (top == bottom)
+                {
+                    // Last job, race the thieves for it
+                    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        job = nullptr;
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+                return job;
+            }
+
+            // Any thread, oldest job first
+            Job *Steal()
+            {
+                int64_t top = mTop.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t bottom = mBottom.load(std::memory_order_acquire);
+                if (top >= bottom)
+                    return nullptr;
+
+                Job *job = mBuffer[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+                if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+                return job;
+            }
+
+        private:
+            alignas(64) std::atomic<int64_t> mTop{0};
+            alignas(64) std::atomic<int64_t> mBottom{0};
+            alignas(64) std::atomic<Job *> mBuffer[CAPACITY]{};
+        };
+
+        struct JobWorker
+        {
+            JobDeque deque;
+            std::thread thread;
+        };
+    }
+
+    namespace
+    {
+        constexpr uint32_t NO_WORKER = UINT32_MAX;
+        // Rounds of searching before an idle worker goes to sleep
+        constexpr uint32_t IDLE_SPIN_COUNT = 64;
+
+        thread_local uint32_t tWorkerIndex = NO_WORKER;
+    }
+
+    JobSystem::JobSystem() = default;
+
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    uint32_t JobSystem::GetDefaultWorkerCount()
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    }
+
+    void JobSystem::Init(uint32_t workerCount)
+    {
+        assert(mWorkers.empty());
+
+        mStop.store(false, std::memory_order_relaxed);
+        for (uint32_t i = 0; i <= workerCount; ++i)
+            mWorkers.emplace_back(std::make_unique<Detail::JobWorker>());
+
+        // Every deque exists before the first worker starts stealing
+        tWorkerIndex = 0;
+        for (uint32_t i = 1; i <= workerCount; ++i)
+            mWorkers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (mWorkers.empty())
+            return;
+
+        mStop.store(true, std::memory_order_release);
+        mSignal.fetch_add(1, std::memory_order_release);
+        mSignal.notify_all();
+        for (auto &worker : mWorkers)
+            if (worker->thread.joinable())
+                worker->thread.join();
+
+        for (auto &worker : mWorkers)
+            while (Detail::Job *job = worker->deque.Pop())
+                delete job;
+        mWorkers.clear();
+        tWorkerIndex = NO_WORKER;
+
+        for (Detail::Job *job : mInjectedJobs)
+            delete job;
+        mInjectedJobs.clear();
+        for (Detail::Job *job : mMainThreadJobs)
+            delete job;
+        mMainThreadJobs.clear();
+
+        std::vector<JobCounter *> parkedCounters;
+        {
+            std::lock_guard<std::mutex> lock(mParkedMutex);
+            parkedCounters.swap(mParkedCounters);
+        }
+        for (JobCounter *counter : parkedCounters)
+        {
+            std::lock_guard<std::mutex> lock(counter->mMutex);
+            for (Detail::Job *job : counter->mWaiters)
+                delete job;
+            counter->mWaiters.clear();
+        }
+    }
+
+    uint32_t JobSystem::GetThreadCount() const
+    {
+        return std::max<uint32_t>(static_cast<uint32_t>(mWorkers.size()), 1);
+    }
+
+    bool JobSystem::IsMainThread() const
+    {
+        return tWorkerIndex == 0;
+    }
+
+    void JobSystem::Schedule(std::function<void()> job, JobCounter *counter, JobCounter *dependency)
+    {
+        if (counter)
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        Enqueue(new Detail::Job{std::move(job), counter, false}, dependency);
+    }
+
+    void JobSystem::ScheduleOnMainThread(std::function<void()> job, JobCounter *counter, JobCounter *dependency)
+    {
+        if (counter)
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        Enqueue(new Detail::Job{std::move(job), counter, true}, dependency);
+    }
+
+    void JobSystem::Wait(JobCounter &counter)
+    {
+        while (counter.mValue.load(std::memory_order_acquire) != 0)
+        {
+            // Before Init the waiting thread is the only one there is
+            Detail::Job *job = IsMainThread() || mWorkers.empty() ? PopMainThreadJob() : nullptr;
+            if (!job)
+                job = FindJob();
+
+            if (job)
+                Execute(job);
+            else
+                std::this_thread::yield();
+        }
+
+        // The last Finish drops the counter to zero under the lock, wait for it to let go before the counter may die
+        std::lock_guard<std::mutex> lock(counter.mMutex);
+    }
+
+    void JobSystem::RunMainThreadJobs()
+    {
+        while (Detail::Job *job = PopMainThreadJob())
+            Execute(job);
+    }
+
+    size_t JobSystem::GetBatchSize(size_t count, size_t minBatchSize) const
+    {
+        const size_t threadCount = GetThreadCount();
+        if (threadCount == 1)
+            return count;
+        const size_t batchCount = threadCount * BATCHES_PER_THREAD;
+        return std::max({(count + batchCount - 1) / batchCount, minBatchSize, size_t{1}});
+    }
+
+    void JobSystem::Submit(Detail::Job *job)
+    {
+        if (job->mainThread)
+        {
+            std::lock_guard<std::mutex> lock(mMainThreadMutex);
+            mMainThreadJobs.emplace_back(job);
+            return;
+        }
+
+        if (tWorkerIndex == NO_WORKER || !mWorkers[tWorkerIndex]->deque.Push(job))
+        {
+            std::lock_guard<std::mutex> lock(mInjectedMutex);
+            mInjectedJobs.emplace_back(job);
+        }
+
+        mSignal.fetch_add(1, std::memory_order_release);
+        mSignal.notify_one();
+    }
+
+    void JobSystem::Enqueue(Detail::Job *job, JobCounter *dependency)
+    {
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->mMutex);
+            if (dependency->mValue.load(std::memory_order_acquire) != 0)
+            {
+                if (dependency->mWaiters.empty())
+                {
+                    std::lock_guard<std::mutex> parkedLock(mParkedMutex);
+                    mParkedCounters.emplace_back(dependency);
+                }
+                dependency->mWaiters.emplace_back(job);
+                return;
+            }
+        }
+        Submit(job);
+    }
+
+    void JobSystem::Execute(Detail::Job *job)
+    {
+        job->function();
+        if (job->counter)
+            Finish(*job->counter);
+        delete job;
+    }
+
+    // Decrements that leave the counter above zero need no lock. The one reaching zero takes the lock, so
+    // a dependent job is either released here or sees zero in Enqueue, and Wait can tell when it is done
+    void JobSystem::Finish(JobCounter &counter)
+    {
+        uint32_t value = counter.mValue.load(std::memory_order_relaxed);
+        while (value > 1)
+        {
+            if (counter.mValue.compare_exchange_weak(value, value - 1, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+
+        std::vector<Detail::Job *> released;
+        {
+            std::lock_guard<std::mutex> lock(counter.mMutex);
+            if (counter.mValue.fetch_sub(1, std::memory_order_acq_rel) == 1 && !counter.mWaiters.empty())
+            {
+                released.swap(counter.mWaiters);
+                std::lock_guard<std::mutex> parkedLock(mParkedMutex);
+                std::erase(mParkedCounters, &counter);
+            }
+        }
+        for (Detail::Job *job : released)
+            Submit(job);
+    }
+
+    // Own deque first, then the injection queue, then the other deques starting after our own
+    Detail::Job *JobSystem::FindJob()
+    {
+        if (tWorkerIndex != NO_WORKER)
+        {
+            if (Detail::Job *job = mWorkers[tWorkerIndex]->deque.Pop())
+                return job;
+        }
+
+        if (Detail::Job *job = PopInjectedJob())
+            return job;
+
+        const size_t workerCount = mWorkers.size();
+        const size_t first = tWorkerIndex == NO_WORKER ? 0 : tWorkerIndex + 1;
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            const size_t victim = (first + i) % workerCount;
+            if (victim == tWorkerIndex)
+                continue;
+            if (Detail::Job *job = mWorkers[victim]->deque.Steal())
+                return job;
+        }
+        return nullptr;
+    }
+
+    Detail::Job *JobSystem::PopMainThreadJob()
+    {
+        std::lock_guard<std::mutex> lock(mMainThreadMutex);
+        if (mMainThreadJobs.empty())
+            return nullptr;
+        // First in first out, main thread work such as uploads usually expects submission order
+        Detail::Job *job = mMainThreadJobs.front();
+        mMainThreadJobs.erase(mMainThreadJobs.begin());
+        return job;
+    }
+
+    Detail::Job *JobSystem::PopInjectedJob()
+    {
+        std::lock_guard<std::mutex> lock(mInjectedMutex);
+        if (mInjectedJobs.empty())
+            return nullptr;
+        Detail::Job *job = mInjectedJobs.back();
+        mInjectedJobs.pop_back();
+        return job;
+    }
+
+    // The signal is read before searching, so a job submitted after a fruitless search changes it and the
+    // wait returns at once instead of missing the wake up
+    void JobSystem::WorkerLoop(uint32_t index)
+    {
+        tWorkerIndex = index;
+        uint32_t idleRounds = 0;
+        while (!mStop.load(std::memory_order_acquire))
+        {
+            const uint32_t signal = mSignal.load(std::memory_order_acquire);
+            if (Detail::Job *job = FindJob())
+            {
+                Execute(job);
+                idleRounds = 0;
+            }
+            else if (++idleRounds < IDLE_SPIN_COUNT)
+                std::this_thread::yield();
+            else
+                mSignal.wait(signal, std::memory_order_acquire);
+        }
+    }
+}
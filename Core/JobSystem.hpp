@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "Core/Common.hpp"
+#include "Core/Marco.hpp"
+namespace RealSix
+{
+    namespace Detail
+    {
+        struct Job;
+        struct JobWorker;
+    }
+
+    // Number of scheduled jobs not finished yet. Jobs scheduled with a dependency on a counter start once
+    // it drops to zero, several jobs signalling the same counter make it a join over all of them.
+    // Wait on a counter before destroying it, finishing jobs may still touch it until Wait returns
+    class REALSIX_API JobCounter : public NonCopyable
+    {
+    public:
+        JobCounter() = default;
+        ~JobCounter() override = default;
+
+        bool IsDone() const { return mValue.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> mValue{0};
+        std::mutex mMutex;
+        std::vector<Detail::Job *> mWaiters; // jobs depending on this counter
+    };
+
+    // Fixed pool of worker threads, each with a Chase-Lev deque: the owner pushes and pops at the bottom
+    // without locks, idle workers steal the oldest job from the top of the others. The thread calling Init
+    // becomes the main thread and helps with jobs whenever it waits. Without Init every job runs on the
+    // thread waiting for it, so code using the job system stays correct in tools and tests
+    class REALSIX_API JobSystem : public Singleton<JobSystem>
+    {
+    public:
+        // ParallelFor splits the range into about this many batches per thread so stealing can even out uneven batches
+        static constexpr size_t BATCHES_PER_THREAD = 4;
+
+        JobSystem();
+        ~JobSystem() override;
+
+        // One worker per logical core besides the main thread
+        static uint32_t GetDefaultWorkerCount();
+
+        // With 0 workers the main thread runs every job itself whenever it waits
+        void Init(uint32_t workerCount = GetDefaultWorkerCount());
+        // Stops the workers, jobs not started by then are dropped, including those still waiting on a dependency
+        void Shutdown();
+
+        // Worker threads plus the main thread
+        uint32_t GetThreadCount() const;
+        bool IsMainThread() const;
+
+        // The counter is incremented now and decremented once the job finished. With a dependency the
+        // job only starts once the dependency counter is zero
+        void Schedule(std::function<void()> job, JobCounter *counter = nullptr, JobCounter *dependency = nullptr);
+        // For work touching main thread only state such as the window or the GPU device, run by
+        // RunMainThreadJobs or while the main thread waits
+        void ScheduleOnMainThread(std::function<void()> job, JobCounter *counter = nullptr, JobCounter *dependency = nullptr);
+
+        // Runs other jobs until the counter is zero
+        void Wait(JobCounter &counter);
+        // Called by App once a frame
+        void RunMainThreadJobs();
+
+        // Calls fn(begin, end) for batches of the range, or fn(index) for every index, and returns once all
+        // are done. The caller runs the first batch itself
+        template <typename Fn>
+        void ParallelFor(size_t count, Fn &&fn, size_t minBatchSize = 1);
+
+    private:
+        size_t GetBatchSize(size_t count, size_t minBatchSize) const;
+
+        void Submit(Detail::Job *job);
+        void Enqueue(Detail::Job *job, JobCounter *dependency);
+        void Execute(Detail::Job *job);
+        void Finish(JobCounter &counter);
+
+        Detail::Job *FindJob();
+        Detail::Job *PopMainThreadJob();
+        Detail::Job *PopInjectedJob();
+        void WorkerLoop(uint32_t index);
+
+        std::vector<std::unique_ptr<Detail::JobWorker>> mWorkers; // index 0 is the main thread
+        std::atomic<bool> mStop{false};
+        std::atomic<uint32_t> mSignal{0}; // bumped for every new job, idle workers wait on it
+
+        std::mutex mInjectedMutex;
+        std::vector<Detail::Job *> mInjectedJobs; // from threads outside the pool or a full deque
+
+        std::mutex mMainThreadMutex;
+        std::vector<Detail::Job *> mMainThreadJobs;
+
+        std::mutex mParkedMutex;
+        std::vector<JobCounter *> mParkedCounters; // counters with waiting jobs, so Shutdown can free them
+    };
+
+    template <typename Fn>
+    void JobSystem::ParallelFor(size_t count, Fn &&fn, size_t minBatchSize)
+    {
+        if (count == 0)
+            return;
+
+        const size_t batchSize = GetBatchSize(count, minBatchSize);
+        const size_t batchCount = (count + batchSize - 1) / batchSize;
+
+        auto runBatch = [&](size_t batch)
+        {
+            const size_t begin = batch * batchSize;
+            const size_t end = std::min(begin + batchSize, count);
+            if constexpr (std::is_invocable_v<Fn &, size_t, size_t>)
+                fn(begin, end);
+            else
+                for (size_t i = begin; i < end; ++i)
+                    fn(i);
+        };
+
+        if (batchCount == 1)
+        {
+            runBatch(0);
+            return;
+        }
+
+        // Two words of capture stay in the small buffer of std::function, only the job itself is allocated
+        JobCounter counter;
+        for (size_t batch = 1; batch < batchCount; ++batch)
+            Schedule([&runBatch, batch]()
+                     { runBatch(batch); }, &counter);
+        runBatch(0);
+        Wait(counter);
+    }
+}
@@ -16,6 +16,14 @@
 #define REALSIX_API
 #endif
 
+// Compiles the function once per x86-64 feature level and lets the loader pick the variant matching the CPU.
+// For hot loops over inline math that can not use an explicit kernel table like BatchMath
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__)
+#define REALSIX_TARGET_CLONES __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+#define REALSIX_TARGET_CLONES
+#endif
+
 #define SAFE_DELETE(x)   \
     do                   \
     {                    \
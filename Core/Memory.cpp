@@ -0,0 +1,236 @@
+#include "Memory.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+namespace RealSix
+{
+    namespace
+    {
+        // Every block starts on a cache line, every allocation on at least BASE_ALIGNMENT
+        constexpr size_t BLOCK_ALIGNMENT = 64;
+        constexpr size_t BASE_ALIGNMENT = 16;
+
+        uintptr_t AlignUp(uintptr_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        std::byte *AllocateBlock(size_t size)
+        {
+            return static_cast<std::byte *>(::operator new(size, std::align_val_t{BLOCK_ALIGNMENT}));
+        }
+
+        void FreeBlock(std::byte *data)
+        {
+            ::operator delete(data, std::align_val_t{BLOCK_ALIGNMENT});
+        }
+    }
+
+    LinearAllocator::LinearAllocator(size_t blockSize)
+        : mBlockSize(blockSize)
+    {
+    }
+
+    LinearAllocator::~LinearAllocator()
+    {
+        for (auto &block : mBlocks)
+            FreeBlock(block.data);
+    }
+
+    void *LinearAllocator::Allocate(size_t size, size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        alignment = std::max(alignment, BASE_ALIGNMENT);
+
+        while (true)
+        {
+            if (mBlockIndex < mBlocks.size())
+            {
+                const uintptr_t base = reinterpret_cast<uintptr_t>(mBlocks[mBlockIndex].data);
+                const size_t offset = AlignUp(base + mOffset, alignment) - base;
+                if (offset + size <= mBlocks[mBlockIndex].size)
+                {
+                    mOffset = offset + size;
+                    return mBlocks[mBlockIndex].data + offset;
+                }
+            }
+
+            // Blocks after the current one are left over from before a Rewind, reuse the next if it fits
+            if (mBlockIndex + 1 < mBlocks.size() && size + alignment <= mBlocks[mBlockIndex + 1].size)
+                ++mBlockIndex;
+            else
+            {
+                AddBlock(size + alignment);
+                mBlockIndex = mBlocks.size() == 1 ? 0 : mBlockIndex + 1;
+            }
+            mOffset = 0;
+        }
+    }
+
+    void LinearAllocator::Deallocate(void *ptr, size_t size)
+    {
+        if (mBlockIndex < mBlocks.size() && static_cast<std::byte *>(ptr) + size == mBlocks[mBlockIndex].data + mOffset)
+            mOffset -= size;
+    }
+
+    LinearAllocator::Marker LinearAllocator::GetMarker() const
+    {
+        return Marker{mBlockIndex, mOffset};
+    }
+
+    void LinearAllocator::Rewind(const Marker &marker)
+    {
+        assert(marker.block < mBlockIndex || (marker.block == mBlockIndex && marker.offset <= mOffset));
+        mBlockIndex = marker.block;
+        mOffset = marker.offset;
+    }
+
+    void LinearAllocator::Reset()
+    {
+        if (mBlocks.size() > 1)
+        {
+            size_t capacity = GetCapacity();
+            for (auto &block : mBlocks)
+                FreeBlock(block.data);
+            mBlocks.clear();
+            mBlocks.push_back(Block{AllocateBlock(capacity), capacity});
+        }
+        mBlockIndex = 0;
+        mOffset = 0;
+    }
+
+    size_t LinearAllocator::GetUsedBytes() const
+    {
+        size_t result = mOffset;
+        for (size_t i = 0; i < mBlockIndex && i < mBlocks.size(); ++i)
+            result += mBlocks[i].size;
+        return result;
+    }
+
+    size_t LinearAllocator::GetCapacity() const
+    {
+        size_t result = 0;
+        for (const auto &block : mBlocks)
+            result += block.size;
+        return result;
+    }
+
+    // Inserted right after the current block so the blocks kept for after a Rewind stay in order
+    void LinearAllocator::AddBlock(size_t minSize)
+    {
+        const size_t size = std::max(mBlockSize, AlignUp(minSize, BLOCK_ALIGNMENT));
+        const size_t position = mBlocks.empty() ? 0 : mBlockIndex + 1;
+        mBlocks.insert(mBlocks.begin() + position, Block{AllocateBlock(size), size});
+    }
+
+    FrameAllocator::FrameAllocator(size_t blockSize)
+        : mBlockSize(blockSize)
+    {
+        for (auto &frame : mFrames)
+        {
+            frame.blocks = CreateBlock(mBlockSize);
+            frame.current.store(frame.blocks, std::memory_order_relaxed);
+        }
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        for (auto &frame : mFrames)
+        {
+            for (Block *block = frame.blocks; block;)
+            {
+                Block *next = block->next;
+                FreeBlock(block->data);
+                delete block;
+                block = next;
+            }
+        }
+    }
+
+    void FrameAllocator::BeginFrame()
+    {
+        ++mFrameIndex;
+        Release(mFrames[mFrameIndex % FRAME_COUNT]);
+    }
+
+    // The offset is claimed with one fetch_add, padded so any alignment fits in the claimed range.
+    // A thread overshooting the block grows the frame under the lock and tries again
+    void *FrameAllocator::Allocate(size_t size, size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        const size_t padded = AlignUp(size, BASE_ALIGNMENT) + (alignment > BASE_ALIGNMENT ? alignment - BASE_ALIGNMENT : 0);
+
+        Frame &frame = mFrames[mFrameIndex % FRAME_COUNT];
+        while (true)
+        {
+            Block *block = frame.current.load(std::memory_order_acquire);
+            const size_t offset = block->offset.fetch_add(padded, std::memory_order_relaxed);
+            if (offset + padded <= block->size)
+                return reinterpret_cast<void *>(AlignUp(reinterpret_cast<uintptr_t>(block->data + offset), alignment));
+            Grow(frame, block, padded);
+        }
+    }
+
+    size_t FrameAllocator::GetUsedBytes() const
+    {
+        size_t result = 0;
+        for (Block *block = mFrames[mFrameIndex % FRAME_COUNT].blocks; block; block = block->next)
+            result += std::min(block->offset.load(std::memory_order_relaxed), block->size);
+        return result;
+    }
+
+    size_t FrameAllocator::GetCapacity() const
+    {
+        size_t result = 0;
+        for (const auto &frame : mFrames)
+            for (Block *block = frame.blocks; block; block = block->next)
+                result += block->size;
+        return result;
+    }
+
+    FrameAllocator::Block *FrameAllocator::CreateBlock(size_t size)
+    {
+        Block *block = new Block;
+        block->size = size;
+        block->data = AllocateBlock(size);
+        return block;
+    }
+
+    void FrameAllocator::Grow(Frame &frame, Block *full, size_t minSize)
+    {
+        std::lock_guard<std::mutex> lock(mGrowMutex);
+        if (frame.current.load(std::memory_order_relaxed) != full)
+            return;
+
+        Block *block = CreateBlock(std::max(mBlockSize, AlignUp(minSize, BLOCK_ALIGNMENT)));
+        block->next = frame.blocks;
+        frame.blocks = block;
+        frame.current.store(block, std::memory_order_release);
+    }
+
+    // A frame that needed several blocks gets one block of their total size, sized for its peak
+    void FrameAllocator::Release(Frame &frame)
+    {
+        if (frame.blocks->next)
+        {
+            size_t capacity = 0;
+            for (Block *block = frame.blocks; block;)
+            {
+                Block *next = block->next;
+                capacity += block->size;
+                FreeBlock(block->data);
+                delete block;
+                block = next;
+            }
+            frame.blocks = CreateBlock(capacity);
+            frame.current.store(frame.blocks, std::memory_order_relaxed);
+        }
+        frame.blocks->offset.store(0, std::memory_order_relaxed);
+    }
+
+    LinearAllocator &ScratchArena::Get()
+    {
+        thread_local LinearAllocator arena;
+        return arena;
+    }
+}
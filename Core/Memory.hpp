@@ -0,0 +1,211 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "Core/Common.hpp"
+#include "Core/Marco.hpp"
+namespace RealSix
+{
+    // Bump allocator over a list of blocks for one thread. Deallocate only gives memory back for
+    // the latest allocation, everything else is released at once by Rewind or Reset
+    class REALSIX_API LinearAllocator : public NonCopyable
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+        };
+
+        explicit LinearAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE);
+        ~LinearAllocator() override;
+
+        void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        void Deallocate(void *ptr, size_t size);
+
+        // Default constructed elements, only for types that do not need their destructor run
+        template <typename T>
+        std::span<T> AllocateArray(size_t count);
+
+        Marker GetMarker() const;
+        void Rewind(const Marker &marker);
+        // Releases everything and merges the blocks into one, so a steady workload settles on a single block
+        void Reset();
+
+        size_t GetUsedBytes() const;
+        size_t GetCapacity() const;
+
+    private:
+        struct Block
+        {
+            std::byte *data;
+            size_t size;
+        };
+
+        void AddBlock(size_t minSize);
+
+        std::vector<Block> mBlocks;
+        size_t mBlockIndex{0};
+        size_t mOffset{0};
+        size_t mBlockSize;
+    };
+
+    // Memory that lives for the frame it was allocated in and the next one, long enough for data
+    // handed to the GPU or to jobs finishing a frame late. BeginFrame releases the older frame, so
+    // transient per frame allocations are a pointer bump and never reach the heap in steady state.
+    // Allocate may be called from any thread, BeginFrame only while no other thread allocates
+    class REALSIX_API FrameAllocator : public Singleton<FrameAllocator>
+    {
+    public:
+        static constexpr size_t FRAME_COUNT = 2;
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+        FrameAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE);
+        ~FrameAllocator() override;
+
+        // Called by Renderer::BeginFrame
+        void BeginFrame();
+
+        void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        void Deallocate(void *, size_t) {}
+
+        template <typename T>
+        std::span<T> AllocateArray(size_t count);
+
+        uint64_t GetFrameIndex() const { return mFrameIndex; }
+        // Statistics, exact only while no other thread allocates
+        size_t GetUsedBytes() const;
+        size_t GetCapacity() const;
+
+    private:
+        struct Block
+        {
+            std::byte *data;
+            size_t size;
+            std::atomic<size_t> offset{0};
+            Block *next{nullptr};
+        };
+
+        struct Frame
+        {
+            std::atomic<Block *> current{nullptr};
+            Block *blocks{nullptr}; // every block of the frame, newest first
+        };
+
+        Block *CreateBlock(size_t size);
+        void Grow(Frame &frame, Block *full, size_t minSize);
+        void Release(Frame &frame);
+
+        Frame mFrames[FRAME_COUNT];
+        uint64_t mFrameIndex{0};
+        size_t mBlockSize;
+        std::mutex mGrowMutex;
+    };
+
+    // The LinearAllocator of the calling thread for temporaries of one function, take a ScratchScope
+    // around their use so the memory goes back when the scope ends
+    class REALSIX_API ScratchArena
+    {
+    public:
+        static LinearAllocator &Get();
+    };
+
+    // std allocator over a LinearAllocator or the FrameAllocator, for std containers of transient data.
+    // The container must not outlive the arena memory: its ScratchScope or the next frame
+    template <typename T, typename Arena>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(Arena &arena) noexcept
+            : mArena(&arena)
+        {
+        }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U, Arena> &other) noexcept
+            : mArena(other.GetArena())
+        {
+        }
+
+        T *allocate(size_t count)
+        {
+            return static_cast<T *>(mArena->Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *ptr, size_t count) noexcept
+        {
+            mArena->Deallocate(ptr, count * sizeof(T));
+        }
+
+        Arena *GetArena() const { return mArena; }
+
+        template <typename U>
+        friend bool operator==(const ArenaAllocator &lhs, const ArenaAllocator<U, Arena> &rhs)
+        {
+            return lhs.GetArena() == rhs.GetArena();
+        }
+
+    private:
+        Arena *mArena;
+    };
+
+    template <typename T>
+    using ScratchVector = std::vector<T, ArenaAllocator<T, LinearAllocator>>;
+    template <typename T>
+    using FrameVector = std::vector<T, ArenaAllocator<T, FrameAllocator>>;
+
+    // Rewinds the thread's scratch arena to where it was on construction. Declare it before the
+    // containers using it so they are destroyed first
+    class ScratchScope : public NonCopyable
+    {
+    public:
+        ScratchScope()
+            : mArena(ScratchArena::Get()), mMarker(mArena.GetMarker())
+        {
+        }
+
+        ~ScratchScope() override
+        {
+            mArena.Rewind(mMarker);
+        }
+
+        LinearAllocator &GetArena() { return mArena; }
+
+        template <typename T>
+        ArenaAllocator<T, LinearAllocator> GetAllocator()
+        {
+            return ArenaAllocator<T, LinearAllocator>(mArena);
+        }
+
+    private:
+        LinearAllocator &mArena;
+        LinearAllocator::Marker mMarker;
+    };
+
+    template <typename T>
+    std::span<T> LinearAllocator::AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+        T *data = static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(data, count);
+        return {data, count};
+    }
+
+    template <typename T>
+    std::span<T> FrameAllocator::AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+        T *data = static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(data, count);
+        return {data, count};
+    }
+}
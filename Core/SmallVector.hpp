@@ -0,0 +1,360 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+namespace RealSix
+{
+    // std::vector replacement keeping its first N elements inside the object, so small lists built
+    // every frame never touch the heap. Grows onto the heap past N. Same interface as std::vector
+    // for the parts the engine uses, iterators are plain pointers and moving it invalidates them
+    template <typename T, size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector needs at least one inline element, use std::vector otherwise");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        SmallVector() = default;
+
+        SmallVector(size_t count, const T &value)
+        {
+            assign(count, value);
+        }
+
+        explicit SmallVector(size_t count)
+        {
+            resize(count);
+        }
+
+        SmallVector(std::initializer_list<T> values)
+        {
+            assign(values.begin(), values.end());
+        }
+
+        template <typename InputIt>
+            requires(!std::is_integral_v<InputIt>)
+        SmallVector(InputIt first, InputIt last)
+        {
+            assign(first, last);
+        }
+
+        SmallVector(const SmallVector &other)
+        {
+            assign(other.begin(), other.end());
+        }
+
+        SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            MoveFrom(std::move(other));
+        }
+
+        ~SmallVector()
+        {
+            clear();
+            Deallocate();
+        }
+
+        SmallVector &operator=(const SmallVector &other)
+        {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other)
+            {
+                clear();
+                Deallocate();
+                MoveFrom(std::move(other));
+            }
+            return *this;
+        }
+
+        SmallVector &operator=(std::initializer_list<T> values)
+        {
+            assign(values.begin(), values.end());
+            return *this;
+        }
+
+        void assign(size_t count, const T &value)
+        {
+            clear();
+            reserve(count);
+            std::uninitialized_fill_n(mData, count, value);
+            mSize = count;
+        }
+
+        template <typename InputIt>
+            requires(!std::is_integral_v<InputIt>)
+        void assign(InputIt first, InputIt last)
+        {
+            clear();
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            {
+                reserve(static_cast<size_t>(std::distance(first, last)));
+                mSize = static_cast<size_t>(std::uninitialized_copy(first, last, mData) - mData);
+            }
+            else
+            {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+        }
+
+        T &operator[](size_t index)
+        {
+            assert(index < mSize);
+            return mData[index];
+        }
+
+        const T &operator[](size_t index) const
+        {
+            assert(index < mSize);
+            return mData[index];
+        }
+
+        T &front() { return (*this)[0]; }
+        const T &front() const { return (*this)[0]; }
+        T &back() { return (*this)[mSize - 1]; }
+        const T &back() const { return (*this)[mSize - 1]; }
+
+        T *data() { return mData; }
+        const T *data() const { return mData; }
+
+        iterator begin() { return mData; }
+        const_iterator begin() const { return mData; }
+        const_iterator cbegin() const { return mData; }
+        iterator end() { return mData + mSize; }
+        const_iterator end() const { return mData + mSize; }
+        const_iterator cend() const { return mData + mSize; }
+
+        bool empty() const { return mSize == 0; }
+        size_t size() const { return mSize; }
+        size_t capacity() const { return mCapacity; }
+        // Whether the elements still live in the inline storage
+        bool is_inline() const { return mData == InlineData(); }
+
+        void reserve(size_t newCapacity)
+        {
+            if (newCapacity > mCapacity)
+                Reallocate(newCapacity);
+        }
+
+        void shrink_to_fit()
+        {
+            if (!is_inline() && mSize <= N)
+                Reallocate(N);
+            else if (mSize < mCapacity)
+                Reallocate(mSize);
+        }
+
+        void clear()
+        {
+            std::destroy_n(mData, mSize);
+            mSize = 0;
+        }
+
+        void resize(size_t count)
+        {
+            if (count < mSize)
+                std::destroy(mData + count, mData + mSize);
+            else
+            {
+                reserve(count);
+                std::uninitialized_value_construct(mData + mSize, mData + count);
+            }
+            mSize = count;
+        }
+
+        void resize(size_t count, const T &value)
+        {
+            if (count < mSize)
+                std::destroy(mData + count, mData + mSize);
+            else
+            {
+                reserve(count);
+                std::uninitialized_fill(mData + mSize, mData + count, value);
+            }
+            mSize = count;
+        }
+
+        void push_back(const T &value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        T &emplace_back(Args &&...args)
+        {
+            if (mSize == mCapacity)
+                return GrowAndEmplaceBack(std::forward<Args>(args)...);
+            T *result = ::new (static_cast<void *>(mData + mSize)) T(std::forward<Args>(args)...);
+            ++mSize;
+            return *result;
+        }
+
+        void pop_back()
+        {
+            assert(mSize > 0);
+            std::destroy_at(mData + --mSize);
+        }
+
+        iterator insert(const_iterator pos, const T &value)
+        {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T &&value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        template <typename... Args>
+        iterator emplace(const_iterator pos, Args &&...args)
+        {
+            const size_t index = static_cast<size_t>(pos - mData);
+            assert(index <= mSize);
+            // Built first, args may refer to an element that is about to move
+            T value(std::forward<Args>(args)...);
+            if (index == mSize)
+            {
+                emplace_back(std::move(value));
+                return mData + index;
+            }
+            emplace_back(std::move(back()));
+            std::move_backward(mData + index, mData + mSize - 2, mData + mSize - 1);
+            mData[index] = std::move(value);
+            return mData + index;
+        }
+
+        template <typename InputIt>
+            requires(!std::is_integral_v<InputIt>)
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            const size_t index = static_cast<size_t>(pos - mData);
+            assert(index <= mSize);
+            const size_t oldSize = mSize;
+            for (; first != last; ++first)
+                emplace_back(*first);
+            std::rotate(mData + index, mData + oldSize, mData + mSize);
+            return mData + index;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            T *begin = mData + (first - mData);
+            T *end = mData + (last - mData);
+            assert(begin <= end && end <= mData + mSize);
+            if (begin != end)
+            {
+                T *newEnd = std::move(end, mData + mSize, begin);
+                std::destroy(newEnd, mData + mSize);
+                mSize = static_cast<size_t>(newEnd - mData);
+            }
+            return begin;
+        }
+
+        friend bool operator==(const SmallVector &lhs, const SmallVector &rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator!=(const SmallVector &lhs, const SmallVector &rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        T *InlineData()
+        {
+            return std::launder(reinterpret_cast<T *>(mInline));
+        }
+
+        const T *InlineData() const
+        {
+            return std::launder(reinterpret_cast<const T *>(mInline));
+        }
+
+        void Deallocate()
+        {
+            if (!is_inline())
+                ::operator delete(static_cast<void *>(mData), std::align_val_t{alignof(T)});
+            mData = InlineData();
+            mCapacity = N;
+        }
+
+        void Reallocate(size_t newCapacity)
+        {
+            T *newData = newCapacity <= N ? InlineData() : static_cast<T *>(::operator new(newCapacity * sizeof(T), std::align_val_t{alignof(T)}));
+            if (newData == mData)
+                return;
+            std::uninitialized_move(mData, mData + mSize, newData);
+            std::destroy_n(mData, mSize);
+            if (!is_inline())
+                ::operator delete(static_cast<void *>(mData), std::align_val_t{alignof(T)});
+            mData = newData;
+            mCapacity = std::max(newCapacity, N);
+        }
+
+        template <typename... Args>
+        T &GrowAndEmplaceBack(Args &&...args)
+        {
+            // Built before the move, args may refer to an element of this vector
+            T value(std::forward<Args>(args)...);
+            Reallocate(mCapacity * 2);
+            T *result = ::new (static_cast<void *>(mData + mSize)) T(std::move(value));
+            ++mSize;
+            return *result;
+        }
+
+        void MoveFrom(SmallVector &&other)
+        {
+            if (other.is_inline())
+            {
+                std::uninitialized_move(other.mData, other.mData + other.mSize, mData);
+                mSize = other.mSize;
+                other.clear();
+            }
+            else
+            {
+                mData = other.mData;
+                mSize = other.mSize;
+                mCapacity = other.mCapacity;
+                other.mData = other.InlineData();
+                other.mSize = 0;
+                other.mCapacity = N;
+            }
+        }
+
+        T *mData{InlineData()};
+        size_t mSize{0};
+        size_t mCapacity{N};
+        alignas(T) std::byte mInline[sizeof(T) * N];
+    };
+}
@@ -3,38 +3,44 @@
 namespace RealSix
 {
     String::String(std::string_view str)
-        : mString(str), mHash(HashString(mString))
+        : mString(str)
     {
     }
 
     String::String(StringView str)
-        : mString(str.CString()), mHash(str.GetHash())
+        : mString(str.GetRawData())
     {
     }
 
     String::String(const std::string &str)
-        : mString(str), mHash(HashString(mString))
+        : mString(str)
+    {
+    }
+
+    String::String(std::string &&str) noexcept
+        : mString(std::move(str))
     {
     }
 
     String::String(const char *str)
-        : mString(str), mHash(HashString(mString))
+        : mString(str)
     {
     }
 
     String::String(size_t count, char ch)
-        : mString(count, ch), mHash(HashString(mString))
+        : mString(count, ch)
     {
     }
 
     String::String(const String &other)
-        : mString(other.mString), mHash(other.mHash)
+        : mString(other.mString), mHash(other.mHash), mIsHashValid(other.mIsHashValid)
     {
     }
 
     String::String(String &&other) noexcept
-        : mString(other.mString), mHash(other.mHash)
+        : mString(std::move(other.mString)), mHash(other.mHash), mIsHashValid(other.mIsHashValid)
     {
+        other.mIsHashValid = false;
     }
 
     bool String::Empty() const
@@ -70,12 +76,14 @@ namespace RealSix
     String &String::Append(const String &str, size_t idx, size_t count)
     {
         mString.append(str.GetRawData(), idx, count);
+        mIsHashValid = false;
         return *this;
     }
 
     String &String::Append(size_t idx, char ch)
     {
         mString.append(idx, ch);
+        mIsHashValid = false;
         return *this;
     }
 
@@ -84,7 +92,7 @@ namespace RealSix
         return index >= mString.size();
     }
 
-    String String::SubStr(size_t offset, size_t len)
+    String String::SubStr(size_t offset, size_t len) const
     {
         return mString.substr(offset, len);
     }
@@ -92,31 +100,35 @@ namespace RealSix
     String &String::Replace(size_t pos, size_t len, const String &str)
     {
         mString.replace(pos, len, str.GetRawData());
+        mIsHashValid = false;
         return *this;
     }
 
     String &String::Erase(size_t index)
     {
         mString.erase(mString.begin() + index);
+        mIsHashValid = false;
         return *this;
     }
 
     String &String::Insert(size_t index, const String &data)
     {
-        std::string newData = data.GetRawData();
-        mString.insert(mString.begin() + index, newData.begin(), newData.end());
+        mString.insert(index, data.GetRawData());
+        mIsHashValid = false;
         return *this;
     }
 
     String &String::Insert(size_t index, size_t count, char ch)
     {
         mString.insert(index, count, ch);
+        mIsHashValid = false;
         return *this;
     }
 
     void String::Clear()
     {
         mString.clear();
+        mIsHashValid = false;
     }
 
     const std::string &String::GetRawData() const
@@ -131,6 +143,11 @@ namespace RealSix
 
     uint64_t String::GetHash() const
     {
+        if (!mIsHashValid)
+        {
+            mHash = HashString(mString);
+            mIsHashValid = true;
+        }
         return mHash;
     }
 
@@ -148,27 +165,30 @@ namespace RealSix
     {
         mString = other.mString;
         mHash = other.mHash;
+        mIsHashValid = other.mIsHashValid;
         return *this;
     }
 
-    String &String::operator=(String &&other)
+    String &String::operator=(String &&other) noexcept
     {
-        mString = other.mString;
+        mString = std::move(other.mString);
         mHash = other.mHash;
+        mIsHashValid = other.mIsHashValid;
+        other.mIsHashValid = false;
         return *this;
     }
 
     String &String::operator=(StringView other)
     {
         mString = other.GetRawData();
-        mHash = other.GetHash();
+        mIsHashValid = false;
         return *this;
     }
 
     String &String::operator=(const char *other)
     {
         mString = other;
-        mHash = HashString(mString);
+        mIsHashValid = false;
         return *this;
     }
 
@@ -180,12 +200,14 @@ namespace RealSix
     String &String::operator+=(const String &other)
     {
         mString += other.mString;
-        mHash = HashString(mString);
+        mIsHashValid = false;
         return *this;
     }
 
     char &String::operator[](size_t index)
     {
+        // The caller may write through the reference
+        mIsHashValid = false;
         return mString[index];
     }
 
@@ -206,17 +228,22 @@ namespace RealSix
 
     bool String::operator==(const String &other) const
     {
-        return mHash == other.mHash;
+        if (mIsHashValid && other.mIsHashValid && mHash != other.mHash)
+            return false;
+        return mString == other.mString;
     }
 
     bool String::operator!=(const String &other) const
     {
-        return mHash != other.mHash;
+        return !(*this == other);
     }
 
     String operator+(const String &lhs, const String &rhs)
     {
-        return String(lhs.GetRawData() + rhs.GetRawData());
+        std::string result;
+        result.reserve(lhs.Size() + rhs.Size());
+        result.append(lhs.GetRawData()).append(rhs.GetRawData());
+        return String(std::move(result));
     }
 
     String operator+(const char *lhs, const String &rhs)
@@ -235,7 +262,7 @@ namespace RealSix
 
     bool operator==(const String &lhs, const StringView &rhs)
     {
-        return lhs.GetHash() == rhs.GetHash();
+        return std::string_view(lhs.GetRawData()) == rhs.GetRawData();
     }
 
     bool operator==(const String &lhs, const char *rhs)
@@ -250,30 +277,30 @@ namespace RealSix
     }
 
     StringView::StringView(std::string_view str)
-        : mStringView(str), mHash(HashString(mStringView))
+        : mStringView(str)
     {
     }
     StringView::StringView(const std::string &str)
-        : mStringView(str), mHash(HashString(mStringView))
+        : mStringView(str)
     {
     }
     StringView::StringView(const String &str)
-        : mStringView(str.GetRawData()), mHash(str.GetHash())
+        : mStringView(str.GetRawData())
     {
     }
 
     StringView::StringView(const char *str)
-        : mStringView(str), mHash(HashString(mStringView))
+        : mStringView(str)
     {
     }
 
     StringView::StringView(StringView &&other)
-        : mStringView(other.mStringView), mHash(other.mHash)
+        : mStringView(other.mStringView), mHash(other.mHash), mIsHashValid(other.mIsHashValid)
     {
     }
 
     StringView::StringView(const StringView &other)
-        : mStringView(other.mStringView), mHash(other.mHash)
+        : mStringView(other.mStringView), mHash(other.mHash), mIsHashValid(other.mIsHashValid)
     {
     }
 
@@ -289,6 +316,11 @@ namespace RealSix
 
     uint64_t StringView::GetHash() const
     {
+        if (!mIsHashValid)
+        {
+            mHash = HashString(mStringView);
+            mIsHashValid = true;
+        }
         return mHash;
     }
 
@@ -311,23 +343,25 @@ namespace RealSix
     {
         this->mStringView = other.mStringView;
         this->mHash = other.mHash;
+        this->mIsHashValid = other.mIsHashValid;
         return *this;
     }
     StringView &StringView::operator=(StringView &&other)
     {
         this->mStringView = other.mStringView;
         this->mHash = other.mHash;
+        this->mIsHashValid = other.mIsHashValid;
         return *this;
     }
 
     bool StringView::operator==(StringView other) const
     {
-        return mHash == other.mHash;
+        return mStringView == other.mStringView;
     }
 
     bool StringView::operator!=(StringView other) const
     {
-        return mHash != other.mHash;
+        return mStringView != other.mStringView;
     }
 
     const char &StringView::operator[](size_t index) const
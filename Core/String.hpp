@@ -30,6 +30,7 @@ namespace RealSix
 		String(std::string_view str);
 		String(StringView str);
 		String(const std::string &str);
+		String(std::string &&str) noexcept;
 		String(const char *str);
 		String(size_t count, char ch);
 		String(const String &other);
@@ -47,7 +48,7 @@ namespace RealSix
 		String &Append(size_t idx, char ch);
 
 		bool IsAtLast(size_t index) const;
-		String SubStr(size_t offset, size_t len = std::string::npos);
+		String SubStr(size_t offset, size_t len = std::string::npos) const;
 
 		String &Replace(size_t pos, size_t len, const String &str);
 
@@ -65,7 +66,7 @@ namespace RealSix
 		int64_t ToInt64() const;
 
 		String &operator=(const String &other);
-		String &operator=(String &&other);
+		String &operator=(String &&other) noexcept;
 		String &operator=(StringView other);
 		String &operator=(const char *other);
 		bool operator<(const String &other) const;
@@ -80,7 +81,9 @@ namespace RealSix
 
 	private:
 		std::string mString{""};
-		uint64_t mHash{0};
+		// Hashing is deferred to the first GetHash() and dropped by every mutation
+		mutable uint64_t mHash{0};
+		mutable bool mIsHashValid{false};
 	};
 
 	class REALSIX_API StringView
@@ -113,7 +116,8 @@ namespace RealSix
 
 	private:
 		std::string_view mStringView{};
-		uint64_t mHash{0};
+		mutable uint64_t mHash{0};
+		mutable bool mIsHashValid{false};
 	};
 
 	String operator+(const String &lhs, const String &rhs);
@@ -133,7 +137,7 @@ namespace std
 	{
 		inline std::size_t operator()(RealSix::StringView v) const
 		{
-			return std::hash<std::string_view>()(v.GetRawData()) ^ std::hash<int64_t>()(v.GetHash());
+			return v.GetHash();
 		}
 	};
 
@@ -142,7 +146,7 @@ namespace std
 	{
 		inline std::size_t operator()(const RealSix::String &v) const
 		{
-			return std::hash<std::string>()(v.GetRawData()) ^ std::hash<int64_t>()(v.GetHash());
+			return v.GetHash();
 		}
 	};
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Gfx/IGfxCommon.hpp"
 #include "Gfx/IGfxShader.hpp"
+#include "Core/SmallVector.hpp"
 namespace RealSix
 {
     struct GfxVertexAttribute
@@ -18,7 +19,7 @@ namespace RealSix
         uint32_t bindingPoint;
         size_t size;
         GfxVertexInputType vertexInputType;
-        std::vector<GfxVertexAttribute> attribs;
+        SmallVector<GfxVertexAttribute, 8> attribs;
 
         static GfxVertexInputBinding Default()
         {
@@ -4,6 +4,7 @@
 #include "GfxVulkanBuffer.hpp"
 #include "GfxVulkanTexture.hpp"
 #include "String.hpp"
+#include "Core/Memory.hpp"
 #include "Resource/FileSystem.hpp"
 #include "Resource/FileSystem.hpp"
 namespace RealSix
@@ -215,7 +216,8 @@ namespace RealSix
             {
                 if (CheckDescriptorWriteValid())
                 {
-                    auto writeList = GetWriteList();
+                    ScratchScope scratch;
+                    auto writeList = GetWriteList(scratch);
                     vkUpdateDescriptorSets(mDevice->GetLogicDevice(), static_cast<uint32_t>(writeList.size()), writeList.data(), 0, nullptr);
                 }
                 mIsDirty = false;
@@ -330,9 +332,11 @@ namespace RealSix
             return mDescriptorPool;
         }
 
-        std::vector<VkWriteDescriptorSet> GetWriteList()
+        // Only valid until the scratch scope ends, the writes are consumed by vkUpdateDescriptorSets right away
+        ScratchVector<VkWriteDescriptorSet> GetWriteList(ScratchScope &scratch)
         {
-            std::vector<VkWriteDescriptorSet> result;
+            ScratchVector<VkWriteDescriptorSet> result(scratch.GetAllocator<VkWriteDescriptorSet>());
+            result.reserve(mWriteMap.size());
             for (auto [k, v] : mWriteMap)
             {
                 result.emplace_back(v);
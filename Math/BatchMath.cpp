@@ -0,0 +1,274 @@
+#include "BatchMath.hpp"
+#include <cassert>
+#include <cmath>
+#include "Platform/CpuProbe.hpp"
+namespace RealSix
+{
+	namespace
+	{
+		struct ScalarLanes
+		{
+			using Type = float;
+			using Mask = bool;
+			static constexpr size_t WIDTH = 1;
+
+			static Type Load(const float *src) { return *src; }
+			static void Store(float *dst, Type value) { *dst = value; }
+			static Type Splat(float value) { return value; }
+			static Type Add(Type left, Type right) { return left + right; }
+			static Type Sub(Type left, Type right) { return left - right; }
+			static Type Mul(Type left, Type right) { return left * right; }
+			static Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+			static Type Div(Type left, Type right) { return left / right; }
+			static Type Sqrt(Type value) { return std::sqrt(value); }
+			static Type Abs(Type value) { return std::fabs(value); }
+			static Mask Less(Type left, Type right) { return left < right; }
+			static Mask Greater(Type left, Type right) { return left > right; }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return mask ? ifTrue : ifFalse; }
+		};
+	}
+}
+#include "BatchMathKernels.inl"
+namespace RealSix
+{
+	namespace
+	{
+		bool IsCpuSupported(BatchMathPath path)
+		{
+			const CpuFeatures &features = CpuProbe::GetFeatures();
+			switch (path)
+			{
+			case BatchMathPath::SCALAR:
+				return true;
+			case BatchMathPath::SSE4:
+				return features.sse41 && GetSSE4BatchMathKernels() != nullptr;
+			case BatchMathPath::AVX2:
+				return features.avx2 && features.fma && GetAVX2BatchMathKernels() != nullptr;
+			case BatchMathPath::AVX512:
+				return features.avx512f && GetAVX512BatchMathKernels() != nullptr;
+			default:
+				return false;
+			}
+		}
+
+		const BatchMathKernels *GetKernels(BatchMathPath path)
+		{
+			switch (path)
+			{
+			case BatchMathPath::SSE4:
+				return GetSSE4BatchMathKernels();
+			case BatchMathPath::AVX2:
+				return GetAVX2BatchMathKernels();
+			case BatchMathPath::AVX512:
+				return GetAVX512BatchMathKernels();
+			default:
+				return GetBatchMathKernels<ScalarLanes>();
+			}
+		}
+
+		struct BatchMathDispatch
+		{
+			BatchMathPath path;
+			const BatchMathKernels *kernels;
+		};
+
+		BatchMathDispatch &GetDispatch()
+		{
+			static BatchMathDispatch dispatch = []()
+			{
+				BatchMathPath path = BatchMathPath::SCALAR;
+				if (IsCpuSupported(BatchMathPath::AVX512))
+					path = BatchMathPath::AVX512;
+				else if (IsCpuSupported(BatchMathPath::AVX2))
+					path = BatchMathPath::AVX2;
+				else if (IsCpuSupported(BatchMathPath::SSE4))
+					path = BatchMathPath::SSE4;
+				return BatchMathDispatch{path, GetKernels(path)};
+			}();
+			return dispatch;
+		}
+
+		template <typename Args>
+		void Run(size_t (*BatchMathKernels::*kernel)(const Args &, size_t, size_t), const Args &args, size_t count)
+		{
+			size_t done = (GetDispatch().kernels->*kernel)(args, 0, count);
+			(GetBatchMathKernels<ScalarLanes>()->*kernel)(args, done, count);
+		}
+
+		template <typename T>
+		bool IsValid(const QuaternionStream<T> &stream)
+		{
+			return stream.y.size() == stream.Size() && stream.z.size() == stream.Size() && stream.w.size() == stream.Size();
+		}
+
+		template <typename T>
+		bool IsValid(const DualQuaternionStream<T> &stream)
+		{
+			return IsValid(stream.real) && IsValid(stream.dual) && stream.dual.Size() == stream.Size();
+		}
+
+		template <typename T>
+		void Unpack(const QuaternionStream<T> &stream, T **components)
+		{
+			components[0] = stream.x.data();
+			components[1] = stream.y.data();
+			components[2] = stream.z.data();
+			components[3] = stream.w.data();
+		}
+
+		template <typename T>
+		void Unpack(const DualQuaternionStream<T> &stream, T **components)
+		{
+			Unpack(stream.real, components);
+			Unpack(stream.dual, components + 4);
+		}
+
+		BatchBlendArgs MakeBlendArgs(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, const float *factors, bool sharedFactor, const QuaternionfStream &out)
+		{
+			assert(IsValid(a) && IsValid(b) && IsValid(out) && b.Size() == a.Size() && out.Size() == a.Size());
+
+			BatchBlendArgs args;
+			Unpack(a, args.a);
+			Unpack(b, args.b);
+			args.factors = factors;
+			args.sharedFactor = sharedFactor;
+			Unpack(out, args.out);
+			return args;
+		}
+
+		void TransformStream(const Matrix4f &matrix, const ConstVector3fStream &in, const Vector3fStream &out, float w)
+		{
+			assert(in.y.size() == in.Size() && in.z.size() == in.Size());
+			assert(out.x.size() == in.Size() && out.y.size() == in.Size() && out.z.size() == in.Size());
+
+			BatchTransformArgs args{matrix.elements.data(), {in.x.data(), in.y.data(), in.z.data()}, {out.x.data(), out.y.data(), out.z.data()}, w};
+			Run(&BatchMathKernels::transform, args, in.Size());
+		}
+	}
+
+	BatchMathPath BatchMath::GetPath()
+	{
+		return GetDispatch().path;
+	}
+
+	bool BatchMath::IsPathSupported(BatchMathPath path)
+	{
+		return IsCpuSupported(path);
+	}
+
+	bool BatchMath::SetPath(BatchMathPath path)
+	{
+		if (!IsCpuSupported(path))
+			return false;
+		GetDispatch() = BatchMathDispatch{path, GetKernels(path)};
+		return true;
+	}
+
+	const char *BatchMath::GetPathName(BatchMathPath path)
+	{
+		switch (path)
+		{
+		case BatchMathPath::SCALAR:
+			return "scalar";
+		case BatchMathPath::SSE4:
+			return "sse4";
+		case BatchMathPath::AVX2:
+			return "avx2";
+		case BatchMathPath::AVX512:
+			return "avx512";
+		default:
+			return "unknown";
+		}
+	}
+
+	void BatchMath::TransformPoints(const Matrix4f &matrix, const ConstVector3fStream &in, const Vector3fStream &out)
+	{
+		TransformStream(matrix, in, out, 1.0f);
+	}
+
+	void BatchMath::TransformVectors(const Matrix4f &matrix, const ConstVector3fStream &in, const Vector3fStream &out)
+	{
+		TransformStream(matrix, in, out, 0.0f);
+	}
+
+	void BatchMath::Normalize(const Vector3fStream &inOut)
+	{
+		assert(inOut.y.size() == inOut.Size() && inOut.z.size() == inOut.Size());
+
+		BatchNormalizeArgs args{{inOut.x.data(), inOut.y.data(), inOut.z.data()}};
+		Run(&BatchMathKernels::normalize, args, inOut.Size());
+	}
+
+	void BatchMath::Slerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, std::span<const float> factors, const QuaternionfStream &out)
+	{
+		assert(factors.size() == a.Size());
+		Run(&BatchMathKernels::slerp, MakeBlendArgs(a, b, factors.data(), false, out), a.Size());
+	}
+
+	void BatchMath::Slerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, float factor, const QuaternionfStream &out)
+	{
+		Run(&BatchMathKernels::slerp, MakeBlendArgs(a, b, &factor, true, out), a.Size());
+	}
+
+	void BatchMath::NLerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, std::span<const float> factors, const QuaternionfStream &out)
+	{
+		assert(factors.size() == a.Size());
+		Run(&BatchMathKernels::nlerp, MakeBlendArgs(a, b, factors.data(), false, out), a.Size());
+	}
+
+	void BatchMath::NLerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, float factor, const QuaternionfStream &out)
+	{
+		Run(&BatchMathKernels::nlerp, MakeBlendArgs(a, b, &factor, true, out), a.Size());
+	}
+
+	void BatchMath::Multiply(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, const QuaternionfStream &out)
+	{
+		assert(IsValid(a) && IsValid(b) && IsValid(out) && b.Size() == a.Size() && out.Size() == a.Size());
+
+		BatchQuaternionArgs args;
+		Unpack(a, args.a);
+		Unpack(b, args.b);
+		Unpack(out, args.out);
+		Run(&BatchMathKernels::quaternionMultiply, args, a.Size());
+	}
+
+	void BatchMath::Normalize(const QuaternionfStream &inOut)
+	{
+		assert(IsValid(inOut));
+
+		BatchQuaternionNormalizeArgs args;
+		Unpack(inOut, args.inOut);
+		Run(&BatchMathKernels::quaternionNormalize, args, inOut.Size());
+	}
+
+	void BatchMath::Multiply(const ConstDualQuaternionfStream &a, const ConstDualQuaternionfStream &b, const DualQuaternionfStream &out)
+	{
+		assert(IsValid(a) && IsValid(b) && IsValid(out) && b.Size() == a.Size() && out.Size() == a.Size());
+
+		BatchDualQuaternionArgs args;
+		Unpack(a, args.a);
+		Unpack(b, args.b);
+		Unpack(out, args.out);
+		Run(&BatchMathKernels::dualQuaternionMultiply, args, a.Size());
+	}
+
+	void BatchMath::Normalize(const DualQuaternionfStream &inOut)
+	{
+		assert(IsValid(inOut));
+
+		BatchDualQuaternionNormalizeArgs args;
+		Unpack(inOut, args.inOut);
+		Run(&BatchMathKernels::dualQuaternionNormalize, args, inOut.Size());
+	}
+
+	void BatchMath::ToMatrices(const ConstDualQuaternionfStream &in, std::span<Matrix4f> out)
+	{
+		static_assert(sizeof(Matrix4f) == sizeof(float) * 16, "Matrix4f must be 16 packed floats");
+		assert(IsValid(in) && out.size() == in.Size());
+
+		BatchDualQuaternionToMatrixArgs args;
+		Unpack(in, args.in);
+		args.matrices = out.data()->elements.data();
+		Run(&BatchMathKernels::dualQuaternionToMatrix, args, in.Size());
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "Matrix4.hpp"
+namespace RealSix
+{
+	// Structure of arrays views, element i of the stream is (x[i], y[i], z[i]).
+	// All component spans of one stream have the same size
+	template <typename T>
+	struct Vector3Stream
+	{
+		std::span<T> x;
+		std::span<T> y;
+		std::span<T> z;
+
+		size_t Size() const
+		{
+			return x.size();
+		}
+
+		operator Vector3Stream<const T>() const
+			requires(!std::is_const_v<T>)
+		{
+			return {x, y, z};
+		}
+	};
+
+	template <typename T>
+	struct QuaternionStream
+	{
+		std::span<T> x;
+		std::span<T> y;
+		std::span<T> z;
+		std::span<T> w;
+
+		size_t Size() const
+		{
+			return x.size();
+		}
+
+		operator QuaternionStream<const T>() const
+			requires(!std::is_const_v<T>)
+		{
+			return {x, y, z, w};
+		}
+	};
+
+	// Skinning palettes, the real and dual parts as two quaternion streams
+	template <typename T>
+	struct DualQuaternionStream
+	{
+		QuaternionStream<T> real;
+		QuaternionStream<T> dual;
+
+		size_t Size() const
+		{
+			return real.Size();
+		}
+
+		operator DualQuaternionStream<const T>() const
+			requires(!std::is_const_v<T>)
+		{
+			return {real, dual};
+		}
+	};
+
+	typedef Vector3Stream<float> Vector3fStream;
+	typedef Vector3Stream<const float> ConstVector3fStream;
+	typedef QuaternionStream<float> QuaternionfStream;
+	typedef QuaternionStream<const float> ConstQuaternionfStream;
+	typedef DualQuaternionStream<float> DualQuaternionfStream;
+	typedef DualQuaternionStream<const float> ConstDualQuaternionfStream;
+
+	enum class BatchMathPath : uint8_t
+	{
+		SCALAR,
+		SSE4,	// 4 lanes
+		AVX2,	// 8 lanes with fused multiply add
+		AVX512, // 16 lanes with mask registers
+	};
+
+	// Math over thousands of elements per call, picking the widest SIMD path the running CPU supports
+	class BatchMath
+	{
+	public:
+		static BatchMathPath GetPath();
+		static bool IsPathSupported(BatchMathPath path);
+		// Forces a path, for benchmarks and tests, returns false and keeps the current one if the CPU lacks it
+		static bool SetPath(BatchMathPath path);
+		static const char *GetPathName(BatchMathPath path);
+
+		// out[i] = matrix * (in[i], 1), out may alias in
+		static void TransformPoints(const Matrix4f &matrix, const ConstVector3fStream &in, const Vector3fStream &out);
+		// out[i] = matrix * (in[i], 0), out may alias in
+		static void TransformVectors(const Matrix4f &matrix, const ConstVector3fStream &in, const Vector3fStream &out);
+		// Normalizes every vector with a non zero length in place
+		static void Normalize(const Vector3fStream &inOut);
+		// out[i] = Quaternionf::Slerp(a[i], b[i], factors[i]) with polynomial acos and sin good to about 1e-6,
+		// factors are expected in [-1, 2]. out may alias a or b
+		static void Slerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, std::span<const float> factors, const QuaternionfStream &out);
+		// Same with one factor for all pairs, like blending two poses
+		static void Slerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, float factor, const QuaternionfStream &out);
+		// out[i] = Quaternionf::NLerp(a[i], b[i], factors[i]), out may alias a or b
+		static void NLerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, std::span<const float> factors, const QuaternionfStream &out);
+		static void NLerp(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, float factor, const QuaternionfStream &out);
+		// out[i] = a[i] * b[i], out may alias a or b
+		static void Multiply(const ConstQuaternionfStream &a, const ConstQuaternionfStream &b, const QuaternionfStream &out);
+		static void Normalize(const QuaternionfStream &inOut);
+
+		// out[i] = a[i] * b[i] with the DualQuaternion operator, out may alias a or b
+		static void Multiply(const ConstDualQuaternionfStream &a, const ConstDualQuaternionfStream &b, const DualQuaternionfStream &out);
+		static void Normalize(const DualQuaternionfStream &inOut);
+		// Rigid transform matrices of a dual quaternion palette, ready to upload for linear blend skinning
+		static void ToMatrices(const ConstDualQuaternionfStream &in, std::span<Matrix4f> out);
+	};
+}
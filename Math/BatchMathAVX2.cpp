@@ -0,0 +1,48 @@
+// Compiled with AVX2 and FMA enabled, only called after BatchMath checked the CPU supports it
+#if (defined(__AVX2__) && defined(__FMA__)) || (defined(_MSC_VER) && defined(_M_X64))
+#include <cstddef>
+#include <immintrin.h>
+namespace RealSix
+{
+	namespace
+	{
+		struct AVX2Lanes
+		{
+			using Type = __m256;
+			using Mask = __m256;
+			static constexpr size_t WIDTH = 8;
+
+			static Type Load(const float *src) { return _mm256_loadu_ps(src); }
+			static void Store(float *dst, Type value) { _mm256_storeu_ps(dst, value); }
+			static Type Splat(float value) { return _mm256_set1_ps(value); }
+			static Type Add(Type left, Type right) { return _mm256_add_ps(left, right); }
+			static Type Sub(Type left, Type right) { return _mm256_sub_ps(left, right); }
+			static Type Mul(Type left, Type right) { return _mm256_mul_ps(left, right); }
+			static Type MulAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+			static Type Div(Type left, Type right) { return _mm256_div_ps(left, right); }
+			static Type Sqrt(Type value) { return _mm256_sqrt_ps(value); }
+			static Type Abs(Type value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value); }
+			static Mask Less(Type left, Type right) { return _mm256_cmp_ps(left, right, _CMP_LT_OQ); }
+			static Mask Greater(Type left, Type right) { return _mm256_cmp_ps(left, right, _CMP_GT_OQ); }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+		};
+	}
+}
+#include "BatchMathKernels.inl"
+namespace RealSix
+{
+	const BatchMathKernels *GetAVX2BatchMathKernels()
+	{
+		return GetBatchMathKernels<AVX2Lanes>();
+	}
+}
+#else
+#include "BatchMathKernels.hpp"
+namespace RealSix
+{
+	const BatchMathKernels *GetAVX2BatchMathKernels()
+	{
+		return nullptr;
+	}
+}
+#endif
@@ -0,0 +1,48 @@
+// Compiled with AVX-512F enabled, only called after BatchMath checked the CPU and the OS support it
+#if defined(__AVX512F__) || (defined(_MSC_VER) && defined(_M_X64))
+#include <cstddef>
+#include <immintrin.h>
+namespace RealSix
+{
+	namespace
+	{
+		struct AVX512Lanes
+		{
+			using Type = __m512;
+			using Mask = __mmask16;
+			static constexpr size_t WIDTH = 16;
+
+			static Type Load(const float *src) { return _mm512_loadu_ps(src); }
+			static void Store(float *dst, Type value) { _mm512_storeu_ps(dst, value); }
+			static Type Splat(float value) { return _mm512_set1_ps(value); }
+			static Type Add(Type left, Type right) { return _mm512_add_ps(left, right); }
+			static Type Sub(Type left, Type right) { return _mm512_sub_ps(left, right); }
+			static Type Mul(Type left, Type right) { return _mm512_mul_ps(left, right); }
+			static Type MulAdd(Type a, Type b, Type c) { return _mm512_fmadd_ps(a, b, c); }
+			static Type Div(Type left, Type right) { return _mm512_div_ps(left, right); }
+			static Type Sqrt(Type value) { return _mm512_sqrt_ps(value); }
+			static Type Abs(Type value) { return _mm512_abs_ps(value); }
+			static Mask Less(Type left, Type right) { return _mm512_cmp_ps_mask(left, right, _CMP_LT_OQ); }
+			static Mask Greater(Type left, Type right) { return _mm512_cmp_ps_mask(left, right, _CMP_GT_OQ); }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return _mm512_mask_blend_ps(mask, ifFalse, ifTrue); }
+		};
+	}
+}
+#include "BatchMathKernels.inl"
+namespace RealSix
+{
+	const BatchMathKernels *GetAVX512BatchMathKernels()
+	{
+		return GetBatchMathKernels<AVX512Lanes>();
+	}
+}
+#else
+#include "BatchMathKernels.hpp"
+namespace RealSix
+{
+	const BatchMathKernels *GetAVX512BatchMathKernels()
+	{
+		return nullptr;
+	}
+}
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+// Internal to BatchMath, shared by the per instruction set translation units.
+// Nothing here may be inline or templated, the kernel files are compiled with different target flags
+namespace RealSix
+{
+	struct BatchTransformArgs
+	{
+		const float *matrix; // 16 column major elements
+		const float *in[3];
+		float *out[3];
+		float w; // 1 for points, 0 for vectors
+	};
+
+	struct BatchNormalizeArgs
+	{
+		float *inOut[3];
+	};
+
+	struct BatchBlendArgs
+	{
+		const float *a[4];
+		const float *b[4];
+		const float *factors;
+		bool sharedFactor; // every pair uses factors[0]
+		float *out[4];
+	};
+
+	struct BatchQuaternionArgs
+	{
+		const float *a[4];
+		const float *b[4];
+		float *out[4];
+	};
+
+	struct BatchQuaternionNormalizeArgs
+	{
+		float *inOut[4];
+	};
+
+	// Dual quaternions as 8 component streams, the real part x y z w followed by the dual part
+	struct BatchDualQuaternionArgs
+	{
+		const float *a[8];
+		const float *b[8];
+		float *out[8];
+	};
+
+	struct BatchDualQuaternionNormalizeArgs
+	{
+		float *inOut[8];
+	};
+
+	struct BatchDualQuaternionToMatrixArgs
+	{
+		const float *in[8];
+		float *matrices; // 16 column major elements per dual quaternion
+	};
+
+	// Every kernel works on the elements [begin, end) and returns where it stopped,
+	// the SIMD kernels only process whole registers and leave the tail to the scalar ones
+	struct BatchMathKernels
+	{
+		size_t (*transform)(const BatchTransformArgs &args, size_t begin, size_t end);
+		size_t (*normalize)(const BatchNormalizeArgs &args, size_t begin, size_t end);
+		size_t (*slerp)(const BatchBlendArgs &args, size_t begin, size_t end);
+		size_t (*nlerp)(const BatchBlendArgs &args, size_t begin, size_t end);
+		size_t (*quaternionMultiply)(const BatchQuaternionArgs &args, size_t begin, size_t end);
+		size_t (*quaternionNormalize)(const BatchQuaternionNormalizeArgs &args, size_t begin, size_t end);
+		size_t (*dualQuaternionMultiply)(const BatchDualQuaternionArgs &args, size_t begin, size_t end);
+		size_t (*dualQuaternionNormalize)(const BatchDualQuaternionNormalizeArgs &args, size_t begin, size_t end);
+		size_t (*dualQuaternionToMatrix)(const BatchDualQuaternionToMatrixArgs &args, size_t begin, size_t end);
+	};
+
+	// nullptr when the compiler can not target the instruction set
+	const BatchMathKernels *GetSSE4BatchMathKernels();
+	const BatchMathKernels *GetAVX2BatchMathKernels();
+	const BatchMathKernels *GetAVX512BatchMathKernels();
+}
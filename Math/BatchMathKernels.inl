@@ -0,0 +1,365 @@
+// Kernel bodies shared by every BatchMath path, included once per instruction set after the lane type L is defined.
+// L provides Type, Mask, WIDTH and Load, Store, Splat, Add, Sub, Mul, MulAdd, Div, Sqrt, Abs, Less, Greater, Select.
+// Everything lives in an anonymous namespace so no instantiation leaks into the other translation units
+#include <cstddef>
+#include "BatchMathKernels.hpp"
+namespace RealSix
+{
+	namespace
+	{
+		constexpr float BATCH_PI = 3.14159265358979323846f;
+		constexpr float BATCH_HALF_PI = 1.57079632679489661923f;
+		constexpr float BATCH_EPSILON = 1.192092896e-07f; // std::numeric_limits<float>::epsilon()
+
+		// acos(x) for x in [0, 1], Abramowitz and Stegun 4.4.46, absolute error below 2e-8
+		template <typename L>
+		inline typename L::Type BatchArcCos(typename L::Type x)
+		{
+			typename L::Type poly = L::Splat(-0.0012624911f);
+			poly = L::MulAdd(poly, x, L::Splat(0.0066700901f));
+			poly = L::MulAdd(poly, x, L::Splat(-0.0170881256f));
+			poly = L::MulAdd(poly, x, L::Splat(0.0308918810f));
+			poly = L::MulAdd(poly, x, L::Splat(-0.0501743046f));
+			poly = L::MulAdd(poly, x, L::Splat(0.0889789874f));
+			poly = L::MulAdd(poly, x, L::Splat(-0.2145988016f));
+			poly = L::MulAdd(poly, x, L::Splat(1.5707963050f));
+			return L::Mul(L::Sqrt(L::Sub(L::Splat(1.0f), x)), poly);
+		}
+
+		// sin(x) for x in [-pi, pi], folded into [-pi/2, pi/2] and evaluated up to x^11
+		template <typename L>
+		inline typename L::Type BatchSin(typename L::Type x)
+		{
+			x = L::Select(L::Greater(x, L::Splat(BATCH_HALF_PI)), L::Sub(L::Splat(BATCH_PI), x), x);
+			x = L::Select(L::Less(x, L::Splat(-BATCH_HALF_PI)), L::Sub(L::Splat(-BATCH_PI), x), x);
+			typename L::Type x2 = L::Mul(x, x);
+			typename L::Type poly = L::Splat(-1.0f / 39916800.0f);
+			poly = L::MulAdd(poly, x2, L::Splat(1.0f / 362880.0f));
+			poly = L::MulAdd(poly, x2, L::Splat(-1.0f / 5040.0f));
+			poly = L::MulAdd(poly, x2, L::Splat(1.0f / 120.0f));
+			poly = L::MulAdd(poly, x2, L::Splat(-1.0f / 6.0f));
+			poly = L::MulAdd(poly, x2, L::Splat(1.0f));
+			return L::Mul(poly, x);
+		}
+
+		// Four component registers of WIDTH quaternions
+		template <typename L>
+		struct BatchQuaternion
+		{
+			typename L::Type x, y, z, w;
+		};
+
+		template <typename L>
+		inline BatchQuaternion<L> BatchLoadQuaternion(const float *const src[4], size_t i)
+		{
+			return {L::Load(src[0] + i), L::Load(src[1] + i), L::Load(src[2] + i), L::Load(src[3] + i)};
+		}
+
+		template <typename L>
+		inline BatchQuaternion<L> BatchLoadQuaternion(float *const src[4], size_t i)
+		{
+			return {L::Load(src[0] + i), L::Load(src[1] + i), L::Load(src[2] + i), L::Load(src[3] + i)};
+		}
+
+		template <typename L>
+		inline void BatchStoreQuaternion(float *const dst[4], size_t i, const BatchQuaternion<L> &q)
+		{
+			L::Store(dst[0] + i, q.x);
+			L::Store(dst[1] + i, q.y);
+			L::Store(dst[2] + i, q.z);
+			L::Store(dst[3] + i, q.w);
+		}
+
+		template <typename L>
+		inline typename L::Type BatchQuaternionDot(const BatchQuaternion<L> &left, const BatchQuaternion<L> &right)
+		{
+			return L::MulAdd(left.x, right.x, L::MulAdd(left.y, right.y, L::MulAdd(left.z, right.z, L::Mul(left.w, right.w))));
+		}
+
+		template <typename L>
+		inline BatchQuaternion<L> BatchQuaternionScale(const BatchQuaternion<L> &q, typename L::Type scale)
+		{
+			return {L::Mul(q.x, scale), L::Mul(q.y, scale), L::Mul(q.z, scale), L::Mul(q.w, scale)};
+		}
+
+		template <typename L>
+		inline BatchQuaternion<L> BatchQuaternionAdd(const BatchQuaternion<L> &left, const BatchQuaternion<L> &right)
+		{
+			return {L::Add(left.x, right.x), L::Add(left.y, right.y), L::Add(left.z, right.z), L::Add(left.w, right.w)};
+		}
+
+		// a * scaleA + b * scaleB
+		template <typename L>
+		inline BatchQuaternion<L> BatchQuaternionMix(const BatchQuaternion<L> &a, typename L::Type scaleA, const BatchQuaternion<L> &b, typename L::Type scaleB)
+		{
+			return {L::MulAdd(scaleA, a.x, L::Mul(scaleB, b.x)),
+					L::MulAdd(scaleA, a.y, L::Mul(scaleB, b.y)),
+					L::MulAdd(scaleA, a.z, L::Mul(scaleB, b.z)),
+					L::MulAdd(scaleA, a.w, L::Mul(scaleB, b.w))};
+		}
+
+		// Quaternion<T>::Normalize, zero length quaternions stay as they are
+		template <typename L>
+		inline BatchQuaternion<L> BatchQuaternionNormalize(const BatchQuaternion<L> &q)
+		{
+			using T = typename L::Type;
+			const T one = L::Splat(1.0f);
+			const T lengthSquared = BatchQuaternionDot<L>(q, q);
+			const T invLength = L::Select(L::Greater(lengthSquared, L::Splat(0.0f)), L::Div(one, L::Sqrt(lengthSquared)), one);
+			return BatchQuaternionScale<L>(q, invLength);
+		}
+
+		// Same component order as operator*(Quaternion, Quaternion)
+		template <typename L>
+		inline BatchQuaternion<L> BatchQuaternionMultiply(const BatchQuaternion<L> &left, const BatchQuaternion<L> &right)
+		{
+			return {L::Sub(L::MulAdd(right.x, left.w, L::MulAdd(right.y, left.z, L::Mul(right.w, left.x))), L::Mul(right.z, left.y)),
+					L::Sub(L::MulAdd(right.y, left.w, L::MulAdd(right.z, left.x, L::Mul(right.w, left.y))), L::Mul(right.x, left.z)),
+					L::Sub(L::MulAdd(right.x, left.y, L::MulAdd(right.z, left.w, L::Mul(right.w, left.z))), L::Mul(right.y, left.x)),
+					L::Sub(L::Mul(right.w, left.w), L::MulAdd(right.x, left.x, L::MulAdd(right.y, left.y, L::Mul(right.z, left.z))))};
+		}
+
+		template <typename L>
+		size_t BatchTransformKernel(const BatchTransformArgs &args, size_t begin, size_t end)
+		{
+			using T = typename L::Type;
+			const float *m = args.matrix;
+			const T m0 = L::Splat(m[0]), m1 = L::Splat(m[1]), m2 = L::Splat(m[2]);
+			const T m4 = L::Splat(m[4]), m5 = L::Splat(m[5]), m6 = L::Splat(m[6]);
+			const T m8 = L::Splat(m[8]), m9 = L::Splat(m[9]), m10 = L::Splat(m[10]);
+			const T tx = L::Splat(m[12] * args.w), ty = L::Splat(m[13] * args.w), tz = L::Splat(m[14] * args.w);
+
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T x = L::Load(args.in[0] + i);
+				const T y = L::Load(args.in[1] + i);
+				const T z = L::Load(args.in[2] + i);
+				L::Store(args.out[0] + i, L::MulAdd(m0, x, L::MulAdd(m4, y, L::MulAdd(m8, z, tx))));
+				L::Store(args.out[1] + i, L::MulAdd(m1, x, L::MulAdd(m5, y, L::MulAdd(m9, z, ty))));
+				L::Store(args.out[2] + i, L::MulAdd(m2, x, L::MulAdd(m6, y, L::MulAdd(m10, z, tz))));
+			}
+			return i;
+		}
+
+		template <typename L>
+		size_t BatchNormalizeKernel(const BatchNormalizeArgs &args, size_t begin, size_t end)
+		{
+			using T = typename L::Type;
+			const T zero = L::Splat(0.0f);
+			const T one = L::Splat(1.0f);
+
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T x = L::Load(args.inOut[0] + i);
+				const T y = L::Load(args.inOut[1] + i);
+				const T z = L::Load(args.inOut[2] + i);
+				const T lengthSquared = L::MulAdd(x, x, L::MulAdd(y, y, L::Mul(z, z)));
+				const auto nonZero = L::Greater(lengthSquared, zero);
+				const T invLength = L::Select(nonZero, L::Div(one, L::Sqrt(lengthSquared)), one);
+				L::Store(args.inOut[0] + i, L::Mul(x, invLength));
+				L::Store(args.inOut[1] + i, L::Mul(y, invLength));
+				L::Store(args.inOut[2] + i, L::Mul(z, invLength));
+			}
+			return i;
+		}
+
+		// Same branches as Quaternion<T>::Slerp, taken per lane with selects
+		template <typename L>
+		size_t BatchSlerpKernel(const BatchBlendArgs &args, size_t begin, size_t end)
+		{
+			using T = typename L::Type;
+			const T zero = L::Splat(0.0f);
+			const T one = L::Splat(1.0f);
+			const T linearThreshold = L::Splat(0.9999f);
+
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const BatchQuaternion<L> a = BatchLoadQuaternion<L>(args.a, i);
+				const BatchQuaternion<L> b = BatchLoadQuaternion<L>(args.b, i);
+				const T factor = args.sharedFactor ? L::Splat(args.factors[0]) : L::Load(args.factors + i);
+				const T oneMinusFactor = L::Sub(one, factor);
+
+				const T rawCosom = BatchQuaternionDot<L>(a, b);
+				const T cosom = L::Abs(rawCosom);
+				const auto spherical = L::Less(cosom, linearThreshold);
+
+				const T omega = BatchArcCos<L>(cosom);
+				const T invSin = L::Div(one, L::Select(spherical, BatchSin<L>(omega), one));
+				const T scale0 = L::Select(spherical, L::Mul(BatchSin<L>(L::Mul(oneMinusFactor, omega)), invSin), oneMinusFactor);
+				T scale1 = L::Select(spherical, L::Mul(BatchSin<L>(L::Mul(factor, omega)), invSin), factor);
+				scale1 = L::Select(L::Less(rawCosom, zero), L::Sub(zero, scale1), scale1);
+
+				BatchStoreQuaternion<L>(args.out, i, BatchQuaternionNormalize<L>(BatchQuaternionMix<L>(a, scale0, b, scale1)));
+			}
+			return i;
+		}
+
+		// Quaternion<T>::NLerp
+		template <typename L>
+		size_t BatchNLerpKernel(const BatchBlendArgs &args, size_t begin, size_t end)
+		{
+			using T = typename L::Type;
+			const T one = L::Splat(1.0f);
+
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T factor = args.sharedFactor ? L::Splat(args.factors[0]) : L::Load(args.factors + i);
+				const BatchQuaternion<L> mixed = BatchQuaternionMix<L>(BatchLoadQuaternion<L>(args.a, i), L::Sub(one, factor), BatchLoadQuaternion<L>(args.b, i), factor);
+				BatchStoreQuaternion<L>(args.out, i, BatchQuaternionNormalize<L>(mixed));
+			}
+			return i;
+		}
+
+		template <typename L>
+		size_t BatchQuaternionMultiplyKernel(const BatchQuaternionArgs &args, size_t begin, size_t end)
+		{
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+				BatchStoreQuaternion<L>(args.out, i, BatchQuaternionMultiply<L>(BatchLoadQuaternion<L>(args.a, i), BatchLoadQuaternion<L>(args.b, i)));
+			return i;
+		}
+
+		template <typename L>
+		size_t BatchQuaternionNormalizeKernel(const BatchQuaternionNormalizeArgs &args, size_t begin, size_t end)
+		{
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+				BatchStoreQuaternion<L>(args.inOut, i, BatchQuaternionNormalize<L>(BatchLoadQuaternion<L>(args.inOut, i)));
+			return i;
+		}
+
+		// DualQuaternion<T>::Normalize, a real part below epsilon gives the identity
+		template <typename L>
+		inline void BatchDualQuaternionNormalize(BatchQuaternion<L> &real, BatchQuaternion<L> &dual)
+		{
+			using T = typename L::Type;
+			const T zero = L::Splat(0.0f);
+			const T one = L::Splat(1.0f);
+
+			const T magnitudeSquared = BatchQuaternionDot<L>(real, real);
+			const auto degenerate = L::Less(magnitudeSquared, L::Splat(BATCH_EPSILON));
+			const T invMagnitude = L::Div(one, L::Sqrt(L::Select(degenerate, one, magnitudeSquared)));
+			real = BatchQuaternionScale<L>(real, invMagnitude);
+			dual = BatchQuaternionScale<L>(dual, invMagnitude);
+			real.x = L::Select(degenerate, zero, real.x);
+			real.y = L::Select(degenerate, zero, real.y);
+			real.z = L::Select(degenerate, zero, real.z);
+			real.w = L::Select(degenerate, one, real.w);
+			dual.x = L::Select(degenerate, zero, dual.x);
+			dual.y = L::Select(degenerate, zero, dual.y);
+			dual.z = L::Select(degenerate, zero, dual.z);
+			dual.w = L::Select(degenerate, zero, dual.w);
+		}
+
+		// operator*(DualQuaternion, DualQuaternion), both sides are normalized first
+		template <typename L>
+		size_t BatchDualQuaternionMultiplyKernel(const BatchDualQuaternionArgs &args, size_t begin, size_t end)
+		{
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				BatchQuaternion<L> leftReal = BatchLoadQuaternion<L>(args.a, i);
+				BatchQuaternion<L> leftDual = BatchLoadQuaternion<L>(args.a + 4, i);
+				BatchQuaternion<L> rightReal = BatchLoadQuaternion<L>(args.b, i);
+				BatchQuaternion<L> rightDual = BatchLoadQuaternion<L>(args.b + 4, i);
+				BatchDualQuaternionNormalize<L>(leftReal, leftDual);
+				BatchDualQuaternionNormalize<L>(rightReal, rightDual);
+
+				const BatchQuaternion<L> real = BatchQuaternionMultiply<L>(leftReal, rightReal);
+				const BatchQuaternion<L> dual = BatchQuaternionAdd<L>(BatchQuaternionMultiply<L>(leftReal, rightDual), BatchQuaternionMultiply<L>(leftDual, rightReal));
+				BatchStoreQuaternion<L>(args.out, i, real);
+				BatchStoreQuaternion<L>(args.out + 4, i, dual);
+			}
+			return i;
+		}
+
+		template <typename L>
+		size_t BatchDualQuaternionNormalizeKernel(const BatchDualQuaternionNormalizeArgs &args, size_t begin, size_t end)
+		{
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				BatchQuaternion<L> real = BatchLoadQuaternion<L>(args.inOut, i);
+				BatchQuaternion<L> dual = BatchLoadQuaternion<L>(args.inOut + 4, i);
+				BatchDualQuaternionNormalize<L>(real, dual);
+				BatchStoreQuaternion<L>(args.inOut, i, real);
+				BatchStoreQuaternion<L>(args.inOut + 4, i, dual);
+			}
+			return i;
+		}
+
+		// Rigid transform of a normalized dual quaternion, the same matrix as
+		// Transform3<T>::ToMatrix4 with the rotation real and the position (Conjugate(real) * dual * 2).vec
+		template <typename L>
+		size_t BatchDualQuaternionToMatrixKernel(const BatchDualQuaternionToMatrixArgs &args, size_t begin, size_t end)
+		{
+			using T = typename L::Type;
+			const T one = L::Splat(1.0f);
+			const T two = L::Splat(2.0f);
+
+			size_t i = begin;
+			for (; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				BatchQuaternion<L> real = BatchLoadQuaternion<L>(args.in, i);
+				BatchQuaternion<L> dual = BatchLoadQuaternion<L>(args.in + 4, i);
+				BatchDualQuaternionNormalize<L>(real, dual);
+
+				const BatchQuaternion<L> conjugate{L::Sub(L::Splat(0.0f), real.x), L::Sub(L::Splat(0.0f), real.y), L::Sub(L::Splat(0.0f), real.z), real.w};
+				const BatchQuaternion<L> position = BatchQuaternionMultiply<L>(conjugate, BatchQuaternionScale<L>(dual, two));
+
+				const T x2 = L::Mul(two, real.x), y2 = L::Mul(two, real.y), z2 = L::Mul(two, real.z);
+				const T xx = L::Mul(x2, real.x), yy = L::Mul(y2, real.y), zz = L::Mul(z2, real.z);
+				const T xy = L::Mul(x2, real.y), xz = L::Mul(x2, real.z), yz = L::Mul(y2, real.z);
+				const T wx = L::Mul(x2, real.w), wy = L::Mul(y2, real.w), wz = L::Mul(z2, real.w);
+
+				alignas(64) float columns[12][L::WIDTH];
+				L::Store(columns[0], L::Sub(one, L::Add(yy, zz)));
+				L::Store(columns[1], L::Add(xy, wz));
+				L::Store(columns[2], L::Sub(xz, wy));
+				L::Store(columns[3], L::Sub(xy, wz));
+				L::Store(columns[4], L::Sub(one, L::Add(xx, zz)));
+				L::Store(columns[5], L::Add(yz, wx));
+				L::Store(columns[6], L::Add(xz, wy));
+				L::Store(columns[7], L::Sub(yz, wx));
+				L::Store(columns[8], L::Sub(one, L::Add(xx, yy)));
+				L::Store(columns[9], position.x);
+				L::Store(columns[10], position.y);
+				L::Store(columns[11], position.z);
+
+				for (size_t lane = 0; lane < L::WIDTH; ++lane)
+				{
+					float *matrix = args.matrices + (i + lane) * 16;
+					for (size_t column = 0; column < 4; ++column)
+					{
+						matrix[column * 4 + 0] = columns[column * 3 + 0][lane];
+						matrix[column * 4 + 1] = columns[column * 3 + 1][lane];
+						matrix[column * 4 + 2] = columns[column * 3 + 2][lane];
+						matrix[column * 4 + 3] = column == 3 ? 1.0f : 0.0f;
+					}
+				}
+			}
+			return i;
+		}
+
+		template <typename L>
+		const BatchMathKernels *GetBatchMathKernels()
+		{
+			static const BatchMathKernels kernels = {
+				&BatchTransformKernel<L>,
+				&BatchNormalizeKernel<L>,
+				&BatchSlerpKernel<L>,
+				&BatchNLerpKernel<L>,
+				&BatchQuaternionMultiplyKernel<L>,
+				&BatchQuaternionNormalizeKernel<L>,
+				&BatchDualQuaternionMultiplyKernel<L>,
+				&BatchDualQuaternionNormalizeKernel<L>,
+				&BatchDualQuaternionToMatrixKernel<L>,
+			};
+			return &kernels;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+// Compiled with SSE4.1 enabled, only called after BatchMath checked the CPU supports it
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#include <cstddef>
+#include <smmintrin.h>
+namespace RealSix
+{
+	namespace
+	{
+		struct SSE4Lanes
+		{
+			using Type = __m128;
+			using Mask = __m128;
+			static constexpr size_t WIDTH = 4;
+
+			static Type Load(const float *src) { return _mm_loadu_ps(src); }
+			static void Store(float *dst, Type value) { _mm_storeu_ps(dst, value); }
+			static Type Splat(float value) { return _mm_set1_ps(value); }
+			static Type Add(Type left, Type right) { return _mm_add_ps(left, right); }
+			static Type Sub(Type left, Type right) { return _mm_sub_ps(left, right); }
+			static Type Mul(Type left, Type right) { return _mm_mul_ps(left, right); }
+			static Type MulAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+			static Type Div(Type left, Type right) { return _mm_div_ps(left, right); }
+			static Type Sqrt(Type value) { return _mm_sqrt_ps(value); }
+			static Type Abs(Type value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+			static Mask Less(Type left, Type right) { return _mm_cmplt_ps(left, right); }
+			static Mask Greater(Type left, Type right) { return _mm_cmpgt_ps(left, right); }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return _mm_blendv_ps(ifFalse, ifTrue, mask); }
+		};
+	}
+}
+#include "BatchMathKernels.inl"
+namespace RealSix
+{
+	const BatchMathKernels *GetSSE4BatchMathKernels()
+	{
+		return GetBatchMathKernels<SSE4Lanes>();
+	}
+}
+#else
+#include "BatchMathKernels.hpp"
+namespace RealSix
+{
+	const BatchMathKernels *GetSSE4BatchMathKernels()
+	{
+		return nullptr;
+	}
+}
+#endif
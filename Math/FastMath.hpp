@@ -0,0 +1,403 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "Math.hpp"
+#include "Simd.hpp"
+
+// Polynomial approximations of the Math functions for float and Simd::Float4.
+// LOW is good to about 1e-4, MEDIUM to about 1e-6 and HIGH to a few float ulps,
+// see the fast math table of MathBench for the measured errors and timings
+namespace RealSix
+{
+	enum class FastMathPrecision : uint8_t
+	{
+		LOW,
+		MEDIUM,
+		HIGH,
+	};
+}
+
+namespace RealSix::FastMath
+{
+	namespace Detail
+	{
+		constexpr float HALF_PI = 1.5707963268f;
+		constexpr float QUARTER_PI = 0.7853981634f;
+		constexpr float INV_PI = 0.3183098862f;
+		// pi and ln(2) split in a short high part, exact when multiplied by small integers, and the rest
+		constexpr float PI_HI = 3.140625f;
+		constexpr float PI_LO = 9.6765358979e-4f;
+		constexpr float LN2_HI = 0.693359375f;
+		constexpr float LN2_LO = -2.1219444005e-4f;
+		constexpr float LOG2_E = 1.4426950409f;
+		constexpr float SQRT_2 = 1.4142135624f;
+		constexpr float TAN_PI_8 = 0.4142135624f;
+
+		struct ScalarLanes
+		{
+			using Type = float;
+			using Mask = bool;
+			// Correct bits of the bit shift guess
+			static constexpr uint32_t RSQRT_ESTIMATE_BITS = 4;
+
+			static Type Splat(float value) { return value; }
+			static Type Add(Type left, Type right) { return left + right; }
+			static Type Sub(Type left, Type right) { return left - right; }
+			static Type Mul(Type left, Type right) { return left * right; }
+			static Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+			static Type Div(Type left, Type right) { return left / right; }
+			static Type Min(Type left, Type right) { return left < right ? left : right; }
+			static Type Max(Type left, Type right) { return left > right ? left : right; }
+			static Type Abs(Type value) { return std::fabs(value); }
+			static Type Sqrt(Type value) { return std::sqrt(value); }
+			static Type RSqrtEstimate(Type value) { return std::bit_cast<float>(0x5f375a86u - (std::bit_cast<uint32_t>(value) >> 1)); }
+			// Adding and removing 1.5 * 2^23 pushes the fraction out of the mantissa, valid for |value| < 2^22
+			static Type Round(Type value) { return (value + 12582912.0f) - 12582912.0f; }
+			static Type Pow2(Type n) { return std::bit_cast<float>(static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23); }
+			static Type SplitExponent(Type value, Type &exponent)
+			{
+				const uint32_t bits = std::bit_cast<uint32_t>(value);
+				exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+				return std::bit_cast<float>((bits & 0x007fffff) | 0x3f800000);
+			}
+			static Mask Less(Type left, Type right) { return left < right; }
+			static Mask Greater(Type left, Type right) { return left > right; }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return mask ? ifTrue : ifFalse; }
+		};
+
+		struct Float4Lanes
+		{
+			using Type = Simd::Float4;
+			using Mask = Simd::Mask4;
+			static constexpr uint32_t RSQRT_ESTIMATE_BITS = Simd::RSQRT_ESTIMATE_BITS;
+
+			static Type Splat(float value) { return Simd::Splat(value); }
+			static Type Add(Type left, Type right) { return Simd::Add(left, right); }
+			static Type Sub(Type left, Type right) { return Simd::Sub(left, right); }
+			static Type Mul(Type left, Type right) { return Simd::Mul(left, right); }
+			static Type MulAdd(Type a, Type b, Type c) { return Simd::MulAdd(a, b, c); }
+			static Type Div(Type left, Type right) { return Simd::Div(left, right); }
+			static Type Min(Type left, Type right) { return Simd::Min(left, right); }
+			static Type Max(Type left, Type right) { return Simd::Max(left, right); }
+			static Type Abs(Type value) { return Simd::Abs(value); }
+			static Type Sqrt(Type value) { return Simd::Sqrt(value); }
+			static Type RSqrtEstimate(Type value) { return Simd::RSqrtEstimate(value); }
+			static Type Round(Type value) { return Simd::Round(value); }
+			static Type Pow2(Type n) { return Simd::Pow2(n); }
+			static Type SplitExponent(Type value, Type &exponent) { return Simd::SplitExponent(value, exponent); }
+			static Mask Less(Type left, Type right) { return Simd::Less(left, right); }
+			static Mask Greater(Type left, Type right) { return Simd::Greater(left, right); }
+			static Type Select(Mask mask, Type ifTrue, Type ifFalse) { return Simd::Select(mask, ifTrue, ifFalse); }
+		};
+
+		// Picked by overload, a SIMD register named as a template argument loses its vector attributes
+		template <typename T>
+		void SelectLanes(const T &);
+		ScalarLanes SelectLanes(const float &);
+		Float4Lanes SelectLanes(const Simd::Float4 &);
+
+		// The lane operations for T, void for the types that fall back to Math
+		template <typename T>
+		struct Lanes
+		{
+			using Type = decltype(SelectLanes(std::declval<const T &>()));
+		};
+
+		template <typename T>
+		constexpr bool HAS_LANES = !std::is_void_v<typename Lanes<T>::Type>;
+
+		// c[0] + c[1] * x + c[2] * x^2 + ...
+		template <typename L, size_t N>
+		inline typename L::Type Polynomial(typename L::Type x, const std::array<float, N> &c)
+		{
+			typename L::Type result = L::Splat(c[N - 1]);
+			for (size_t i = N - 1; i-- > 0;)
+				result = L::MulAdd(result, x, L::Splat(c[i]));
+			return result;
+		}
+
+		// Near minimax fits, sin(r) = r * P(r^2) on [-pi/2, pi/2]
+		template <FastMathPrecision P>
+		constexpr auto SIN_COEFFICIENTS = std::array<float, 5>{9.999999957e-01f, -1.666665795e-01f, 8.333050171e-03f, -1.980901741e-04f, 2.605107635e-06f};
+		template <>
+		constexpr auto SIN_COEFFICIENTS<FastMathPrecision::LOW> = std::array<float, 3>{9.999115284e-01f, -1.660200043e-01f, 7.626662151e-03f};
+		template <>
+		constexpr auto SIN_COEFFICIENTS<FastMathPrecision::MEDIUM> = std::array<float, 4>{9.999992371e-01f, -1.666567650e-01f, 8.313191414e-03f, -1.852253932e-04f};
+
+		// atan(u) = u * P(u^2) on [-tan(pi/8), tan(pi/8)]
+		template <FastMathPrecision P>
+		constexpr auto ATAN_COEFFICIENTS = std::array<float, 6>{9.999999994e-01f, -3.333330689e-01f, 1.999818304e-01f, -1.423953267e-01f, 1.056982881e-01f, -6.026305236e-02f};
+		template <>
+		constexpr auto ATAN_COEFFICIENTS<FastMathPrecision::LOW> = std::array<float, 3>{9.999813451e-01f, -3.313618483e-01f, 1.680625372e-01f};
+		template <>
+		constexpr auto ATAN_COEFFICIENTS<FastMathPrecision::MEDIUM> = std::array<float, 4>{9.999994232e-01f, -3.332252809e-01f, 1.967771291e-01f, -1.110037221e-01f};
+
+		// exp(r) = P(r) on [-ln(2) / 2, ln(2) / 2]
+		template <FastMathPrecision P>
+		constexpr auto EXP_COEFFICIENTS = std::array<float, 7>{1.0f, 1.000000038f, 5.000000047e-01f, 1.666641551e-01f, 4.166635290e-02f, 8.375126398e-03f, 1.394110844e-03f};
+		template <>
+		constexpr auto EXP_COEFFICIENTS<FastMathPrecision::LOW> = std::array<float, 4>{9.999245570e-01f, 9.999849286e-01f, 5.050222842e-01f, 1.676701188e-01f};
+		template <>
+		constexpr auto EXP_COEFFICIENTS<FastMathPrecision::MEDIUM> = std::array<float, 5>{1.0f, 9.999622947e-01f, 4.999937214e-01f, 1.679214302e-01f, 4.187564445e-02f};
+
+		// log(1 + f) = s * P(s^2) with s = f / (2 + f) and f in [sqrt(2) / 2 - 1, sqrt(2) - 1]
+		template <FastMathPrecision P>
+		constexpr auto LOG_COEFFICIENTS = std::array<float, 4>{1.999999999f, 6.666681534e-01f, 3.997485052e-01f, 2.992439048e-01f};
+		template <>
+		constexpr auto LOG_COEFFICIENTS<FastMathPrecision::LOW> = std::array<float, 2>{1.999955743f, 6.786625461e-01f};
+		template <>
+		constexpr auto LOG_COEFFICIENTS<FastMathPrecision::MEDIUM> = std::array<float, 3>{2.000000236f, 6.665226673e-01f, 4.129490918e-01f};
+
+		// acos(x) = sqrt(1 - x) * P(x) on [0, 1], Abramowitz and Stegun 4.4.45 and 4.4.46
+		template <FastMathPrecision P>
+		constexpr auto ACOS_COEFFICIENTS = std::array<float, 8>{1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f, 0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f};
+		template <>
+		constexpr auto ACOS_COEFFICIENTS<FastMathPrecision::LOW> = std::array<float, 4>{1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f};
+
+		// Reduces x to r in [-pi/2, pi/2] with x = r + n * pi and returns (-1)^n * sin(r)
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type SinReduced(typename L::Type x, typename L::Type n)
+		{
+			using T = typename L::Type;
+			T r = L::MulAdd(n, L::Splat(-PI_HI), x);
+			r = L::MulAdd(n, L::Splat(-PI_LO), r);
+			const T half = L::Round(L::MulAdd(n, L::Splat(0.5f), L::Splat(-0.25f)));
+			const T odd = L::MulAdd(half, L::Splat(-2.0f), n); // 0 or 1
+			const T sign = L::MulAdd(odd, L::Splat(-2.0f), L::Splat(1.0f));
+			return L::Mul(L::Mul(sign, r), Polynomial<L>(L::Mul(r, r), SIN_COEFFICIENTS<P>));
+		}
+
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type Sin(typename L::Type x)
+		{
+			return SinReduced<P, L>(x, L::Round(L::Mul(x, L::Splat(INV_PI))));
+		}
+
+		// cos(x) = sin(x + pi / 2), shifted before the reduction so no precision is lost on the way
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type Cos(typename L::Type x)
+		{
+			using T = typename L::Type;
+			const T n = L::Add(L::Round(L::MulAdd(x, L::Splat(INV_PI), L::Splat(-0.5f))), L::Splat(0.5f));
+			T r = L::MulAdd(n, L::Splat(-PI_HI), x);
+			r = L::MulAdd(n, L::Splat(-PI_LO), r);
+			// x = r + (k + 1/2) * pi, so cos(x) = -(-1)^k * sin(r)
+			const T k = L::Sub(n, L::Splat(0.5f));
+			const T half = L::Round(L::MulAdd(k, L::Splat(0.5f), L::Splat(-0.25f)));
+			const T odd = L::MulAdd(half, L::Splat(-2.0f), k);
+			const T sign = L::MulAdd(odd, L::Splat(2.0f), L::Splat(-1.0f));
+			return L::Mul(L::Mul(sign, r), Polynomial<L>(L::Mul(r, r), SIN_COEFFICIENTS<P>));
+		}
+
+		// atan(t) for t in [0, 1]
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type ArcTanUnit(typename L::Type t)
+		{
+			using T = typename L::Type;
+			const T one = L::Splat(1.0f);
+			const typename L::Mask shifted = L::Greater(t, L::Splat(TAN_PI_8));
+			const T u = L::Select(shifted, L::Div(L::Sub(t, one), L::Add(t, one)), t);
+			const T offset = L::Select(shifted, L::Splat(QUARTER_PI), L::Splat(0.0f));
+			return L::MulAdd(u, Polynomial<L>(L::Mul(u, u), ATAN_COEFFICIENTS<P>), offset);
+		}
+
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type ArcTan(typename L::Type x)
+		{
+			using T = typename L::Type;
+			const T zero = L::Splat(0.0f);
+			const T a = L::Abs(x);
+			const typename L::Mask inverted = L::Greater(a, L::Splat(1.0f));
+			T result = ArcTanUnit<P, L>(L::Select(inverted, L::Div(L::Splat(1.0f), a), a));
+			result = L::Select(inverted, L::Sub(L::Splat(HALF_PI), result), result);
+			return L::Select(L::Less(x, zero), L::Sub(zero, result), result);
+		}
+
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type ArcTan2(typename L::Type y, typename L::Type x)
+		{
+			using T = typename L::Type;
+			const T zero = L::Splat(0.0f);
+			const T ax = L::Abs(x);
+			const T ay = L::Abs(y);
+			const T big = L::Max(ax, ay);
+			const T t = L::Select(L::Greater(big, zero), L::Div(L::Min(ax, ay), big), zero);
+			T result = ArcTanUnit<P, L>(t);
+			result = L::Select(L::Greater(ay, ax), L::Sub(L::Splat(HALF_PI), result), result);
+			result = L::Select(L::Less(x, zero), L::Sub(L::Splat(Math::PI), result), result);
+			return L::Select(L::Less(y, zero), L::Sub(zero, result), result);
+		}
+
+		// x is clamped to [-87.3, 88.3] so the result stays a finite normal float
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type Exp(typename L::Type x)
+		{
+			using T = typename L::Type;
+			x = L::Min(L::Max(x, L::Splat(-87.3f)), L::Splat(88.3f));
+			const T n = L::Round(L::Mul(x, L::Splat(LOG2_E)));
+			T r = L::MulAdd(n, L::Splat(-LN2_HI), x);
+			r = L::MulAdd(n, L::Splat(-LN2_LO), r);
+			return L::Mul(Polynomial<L>(r, EXP_COEFFICIENTS<P>), L::Pow2(n));
+		}
+
+		// Positive normal floats only
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type Log(typename L::Type x)
+		{
+			using T = typename L::Type;
+			T exponent;
+			T mantissa = L::SplitExponent(x, exponent);
+			const typename L::Mask halve = L::Greater(mantissa, L::Splat(SQRT_2));
+			mantissa = L::Select(halve, L::Mul(mantissa, L::Splat(0.5f)), mantissa);
+			exponent = L::Select(halve, L::Add(exponent, L::Splat(1.0f)), exponent);
+
+			const T f = L::Sub(mantissa, L::Splat(1.0f));
+			const T s = L::Div(f, L::Add(f, L::Splat(2.0f)));
+			const T result = L::MulAdd(s, Polynomial<L>(L::Mul(s, s), LOG_COEFFICIENTS<P>), L::Mul(exponent, L::Splat(LN2_LO)));
+			return L::MulAdd(exponent, L::Splat(LN2_HI), result);
+		}
+
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type ArcCos(typename L::Type x)
+		{
+			using T = typename L::Type;
+			const T a = L::Min(L::Abs(x), L::Splat(1.0f));
+			const T result = L::Mul(L::Sqrt(L::Sub(L::Splat(1.0f), a)), Polynomial<L>(a, ACOS_COEFFICIENTS<P>));
+			return L::Select(L::Less(x, L::Splat(0.0f)), L::Sub(L::Splat(Math::PI), result), result);
+		}
+
+		// Every Newton-Raphson step roughly doubles the correct bits of the estimate
+		constexpr uint32_t RSqrtSteps(uint32_t estimateBits, FastMathPrecision precision)
+		{
+			const uint32_t targetBits = precision == FastMathPrecision::LOW ? 8 : precision == FastMathPrecision::MEDIUM ? 16 : 22;
+			uint32_t steps = 0;
+			for (uint32_t bits = estimateBits; bits < targetBits; bits *= 2)
+				++steps;
+			return steps;
+		}
+
+		template <FastMathPrecision P, typename L>
+		inline typename L::Type RSqrt(typename L::Type x)
+		{
+			using T = typename L::Type;
+			T result = L::RSqrtEstimate(x);
+			const T halfX = L::Mul(x, L::Splat(0.5f));
+			for (uint32_t i = 0; i < RSqrtSteps(L::RSQRT_ESTIMATE_BITS, P); ++i)
+				result = L::Mul(result, L::MulAdd(L::Mul(halfX, result), L::Sub(L::Splat(0.0f), result), L::Splat(1.5f)));
+			return result;
+		}
+	}
+
+	// Same signatures as the Math functions, float and Simd::Float4 take the approximations,
+	// any other type keeps the std library version
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Sin(const T &radian)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::Sin<P, typename Detail::Lanes<T>::Type>(radian);
+		else
+			return Math::Sin(radian);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Cos(const T &radian)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::Cos<P, typename Detail::Lanes<T>::Type>(radian);
+		else
+			return Math::Cos(radian);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Tan(const T &radian)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+		{
+			using L = typename Detail::Lanes<T>::Type;
+			return L::Div(Detail::Sin<P, L>(radian), Detail::Cos<P, L>(radian));
+		}
+		else
+			return Math::Tan(radian);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Cot(const T &radian)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+		{
+			using L = typename Detail::Lanes<T>::Type;
+			return L::Div(Detail::Cos<P, L>(radian), Detail::Sin<P, L>(radian));
+		}
+		else
+			return Math::Cot(radian);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T ArcCos(const T &value)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::ArcCos<P, typename Detail::Lanes<T>::Type>(value);
+		else
+			return Math::ArcCos(value);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T ArcTan(const T &value)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::ArcTan<P, typename Detail::Lanes<T>::Type>(value);
+		else
+			return Math::ArcTan(value);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T ArcTan2(const T &y, const T &x)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::ArcTan2<P, typename Detail::Lanes<T>::Type>(y, x);
+		else
+			return Math::ArcTan2(y, x);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Exp(const T &value)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::Exp<P, typename Detail::Lanes<T>::Type>(value);
+		else
+			return std::exp(value);
+	}
+
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T Log(const T &value)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::Log<P, typename Detail::Lanes<T>::Type>(value);
+		else
+			return std::log(value);
+	}
+
+	// 1 / sqrt(value) from the bit shift guess or the hardware estimate plus as many refinement steps as the precision needs
+	template <FastMathPrecision P = FastMathPrecision::MEDIUM, typename T>
+	inline T RSqrt(const T &value)
+	{
+		if constexpr (Detail::HAS_LANES<T>)
+			return Detail::RSqrt<P, typename Detail::Lanes<T>::Type>(value);
+		else
+			return static_cast<T>(1) / Math::Sqrt(value);
+	}
+}
+
+namespace RealSix
+{
+	// The functions the animation, camera and rotation code evaluate every frame,
+	// configure with REALSIX_FAST_MATH to trade their last bits of precision for speed
+#if defined(REALSIX_FAST_MATH)
+	namespace HotMath = FastMath;
+#else
+	namespace HotMath = Math;
+#endif
+}
@@ -147,9 +147,9 @@ namespace RealSix::Math
 	}
 
 	template <typename T>
-	inline T ArcTan2(const T &value)
+	inline T ArcTan2(const T &y, const T &x)
 	{
-		return std::atan2(value);
+		return std::atan2(y, x);
 	}
 
 	template <typename T, typename T2>
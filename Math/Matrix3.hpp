@@ -2,6 +2,7 @@
 #include <xmmintrin.h>
 #include <cassert>
 #include "Math.hpp"
+#include "FastMath.hpp"
 namespace RealSix
 {
 	template <typename T>
@@ -190,8 +191,8 @@ namespace RealSix
 	inline Matrix3<T> Matrix3<T>::Rotate(const Vector3<T> &axis, const T &radian)
 	{
 		Matrix3<T> tmp;
-		float radian_cos = Math::Cos(radian);
-		float radian_sin = Math::Sin(radian);
+		float radian_cos = HotMath::Cos(radian);
+		float radian_sin = HotMath::Sin(radian);
 		float tmpNum = 1 - radian_cos;
 
 		tmp.elements[0] = axis.x * axis.x * tmpNum + radian_cos;
@@ -274,12 +275,10 @@ namespace RealSix
 	template <typename T>
 	inline Matrix4<T> Matrix3<T>::ToMatrix4(const Matrix3<T> &matrix)
 	{
-		Matrix4<T> tmp;
-		tmp.col[0] = _mm_set_ps(static_cast<T>(0.0f), matrix.elements[2], matrix.elements[1], matrix.elements[0]);
-		tmp.col[1] = _mm_set_ps(static_cast<T>(0.0f), matrix.elements[5], matrix.elements[4], matrix.elements[3]);
-		tmp.col[2] = _mm_set_ps(static_cast<T>(0.0f), matrix.elements[8], matrix.elements[7], matrix.elements[6]);
-		tmp.col[3] = _mm_set_ps(static_cast<T>(1.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f));
-		return tmp;
+		return Matrix4<T>(matrix.elements[0], matrix.elements[1], matrix.elements[2], static_cast<T>(0.0f),
+						  matrix.elements[3], matrix.elements[4], matrix.elements[5], static_cast<T>(0.0f),
+						  matrix.elements[6], matrix.elements[7], matrix.elements[8], static_cast<T>(0.0f),
+						  static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(1.0f));
 	}
 
 	template <typename T>
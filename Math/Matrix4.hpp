@@ -1,10 +1,12 @@
 #pragma once
-#include <xmmintrin.h>
 #include <cstdint>
 #include <array>
 #include <iostream>
 #include <cassert>
+#include <type_traits>
 #include "Math.hpp"
+#include "Simd.hpp"
+#include "FastMath.hpp"
 #include "Vector4.hpp"
 #include "Quaternion.hpp"
 #include "Transform.hpp"
@@ -33,7 +35,8 @@ namespace RealSix
 		{
 			struct
 			{
-				std::array<__m128, 4> col;
+				// SIMD registers for float, plain arrays for the other element types
+				std::array<typename Simd::Lane4<T>::Type, 4> col;
 			};
 			struct
 			{
@@ -83,6 +86,10 @@ namespace RealSix
 		static Matrix4<T> Scale(const Vector3<T> &factor);
 		static Matrix4<T> Transpose(const Matrix4<T> &right);
 		static Matrix4<T> Inverse(const Matrix4<T> &right);
+		// Inverse of a matrix whose last row is (0,0,0,1), like the ones built from a Transform3
+		static Matrix4<T> InverseAffine(const Matrix4<T> &right);
+		static Vector3<T> TransformPoint(const Matrix4<T> &matrix, const Vector3<T> &point);
+		static Vector3<T> TransformVector(const Matrix4<T> &matrix, const Vector3<T> &vector);
 		static T Determinant(const Matrix4<T> &right);
 		static Matrix4<T> Adjoint(const Matrix4<T> &right);
 		static Matrix4<T> OrthoGraphic(const T &left, const T &right, const T &top, const T &bottom, const T &znear, const T &zfar);
@@ -116,30 +123,23 @@ namespace RealSix
 	template <typename T>
 	inline T Matrix4<T>::Determinant(const Matrix4<T> &right)
 	{
-		return right.elements[0] * right.elements[5] * right.elements[10] * right.elements[15] -
-			   right.elements[4] * right.elements[9] * right.elements[14] * right.elements[3] +
-			   right.elements[8] * right.elements[13] * right.elements[2] * right.elements[7] -
-			   right.elements[12] * right.elements[1] * right.elements[6] * right.elements[11] +
-			   right.elements[12] * right.elements[9] * right.elements[6] * right.elements[3] -
-			   right.elements[0] * right.elements[12] * right.elements[10] * right.elements[7] +
-			   right.elements[4] * right.elements[1] * right.elements[14] * right.elements[11] -
-			   right.elements[8] * right.elements[5] * right.elements[2] * right.elements[15] +
-			   right.elements[4] * right.elements[9] * right.elements[2] * right.elements[15] -
-			   right.elements[8] * right.elements[1] * right.elements[14] * right.elements[7] +
-			   right.elements[0] * right.elements[13] * right.elements[6] * right.elements[11] -
-			   right.elements[12] * right.elements[5] * right.elements[10] * right.elements[3] +
-			   right.elements[12] * right.elements[1] * right.elements[10] * right.elements[7] -
-			   right.elements[4] * right.elements[13] * right.elements[2] * right.elements[11] +
-			   right.elements[8] * right.elements[5] * right.elements[14] * right.elements[3] -
-			   right.elements[0] * right.elements[9] * right.elements[6] * right.elements[15] +
-			   right.elements[8] * right.elements[1] * right.elements[6] * right.elements[15] -
-			   right.elements[0] * right.elements[5] * right.elements[14] * right.elements[11] +
-			   right.elements[4] * right.elements[13] * right.elements[10] * right.elements[3] -
-			   right.elements[12] * right.elements[9] * right.elements[2] * right.elements[7] +
-			   right.elements[12] * right.elements[5] * right.elements[2] * right.elements[11] -
-			   right.elements[8] * right.elements[13] * right.elements[6] * right.elements[3] +
-			   right.elements[0] * right.elements[9] * right.elements[14] * right.elements[7] -
-			   right.elements[4] * right.elements[1] * right.elements[10] * right.elements[15];
+		// Laplace expansion over the 2x2 minors of the first two and the last two rows
+		const auto &e = right.elements;
+		T s0 = e[0] * e[5] - e[4] * e[1];
+		T s1 = e[0] * e[9] - e[8] * e[1];
+		T s2 = e[0] * e[13] - e[12] * e[1];
+		T s3 = e[4] * e[9] - e[8] * e[5];
+		T s4 = e[4] * e[13] - e[12] * e[5];
+		T s5 = e[8] * e[13] - e[12] * e[9];
+
+		T c0 = e[2] * e[7] - e[6] * e[3];
+		T c1 = e[2] * e[11] - e[10] * e[3];
+		T c2 = e[2] * e[15] - e[14] * e[3];
+		T c3 = e[6] * e[11] - e[10] * e[7];
+		T c4 = e[6] * e[15] - e[14] * e[7];
+		T c5 = e[10] * e[15] - e[14] * e[11];
+
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 	}
 
 	template <typename T>
@@ -401,7 +401,7 @@ namespace RealSix
 	template <typename T>
 	inline Matrix4<T> Matrix4<T>::GLPerspective(const T &fov_radian, const T &aspect, const T &znear, const T &zfar)
 	{
-		T cotFov = Math::Cot(fov_radian / 2);
+		T cotFov = HotMath::Cot(fov_radian / 2);
 
 		Matrix4<T> tmp(static_cast<T>(0.0f));
 		tmp.elements[0] = cotFov / aspect;
@@ -416,7 +416,7 @@ namespace RealSix
 	template <typename T>
 	inline Matrix4<T> Matrix4<T>::VKPerspective(const T &fov_radian, const T &aspect, const T &znear, const T &zfar)
 	{
-		float f = Math::Cot(fov_radian / 2);
+		float f = HotMath::Cot(fov_radian / 2);
 
 		Matrix4<T> tmp(static_cast<T>(0.0f));
 		tmp.elements[0] = f / aspect;
@@ -475,8 +475,16 @@ namespace RealSix
 	inline Matrix4<T> operator+(const Matrix4<T> &left, const Matrix4<T> &right)
 	{
 		Matrix4<T> tmp;
-		for (uint8_t i = 0; i < 4; ++i)
-			tmp.col[i] = _mm_add_ps(left.col[i], right.col[i]);
+		if constexpr (std::is_same_v<T, float>)
+		{
+			for (uint8_t i = 0; i < 4; ++i)
+				tmp.col[i] = Simd::Add(left.col[i], right.col[i]);
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 16; ++i)
+				tmp.elements[i] = left.elements[i] + right.elements[i];
+		}
 		return tmp;
 	}
 
@@ -484,8 +492,16 @@ namespace RealSix
 	inline Matrix4<T> operator-(const Matrix4<T> &left, const Matrix4<T> &right)
 	{
 		Matrix4<T> tmp;
-		for (uint8_t i = 0; i < 4; ++i)
-			tmp.col[i] = _mm_sub_ps(left.col[i], right.col[i]);
+		if constexpr (std::is_same_v<T, float>)
+		{
+			for (uint8_t i = 0; i < 4; ++i)
+				tmp.col[i] = Simd::Sub(left.col[i], right.col[i]);
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 16; ++i)
+				tmp.elements[i] = left.elements[i] - right.elements[i];
+		}
 		return tmp;
 	}
 
@@ -493,27 +509,40 @@ namespace RealSix
 	inline Matrix4<T> operator*(const Matrix4<T> &left, const Matrix4<T> &right)
 	{
 		Matrix4<T> tmp;
-
-		tmp.elements[0] = left.elements[0] * right.elements[0] + left.elements[4] * right.elements[1] + left.elements[8] * right.elements[2] + left.elements[12] * right.elements[3];
-		tmp.elements[1] = left.elements[1] * right.elements[0] + left.elements[5] * right.elements[1] + left.elements[9] * right.elements[2] + left.elements[13] * right.elements[3];
-		tmp.elements[2] = left.elements[2] * right.elements[0] + left.elements[6] * right.elements[1] + left.elements[10] * right.elements[2] + left.elements[14] * right.elements[3];
-		tmp.elements[3] = left.elements[3] * right.elements[0] + left.elements[7] * right.elements[1] + left.elements[11] * right.elements[2] + left.elements[15] * right.elements[3];
-
-		tmp.elements[4] = left.elements[0] * right.elements[4] + left.elements[4] * right.elements[5] + left.elements[8] * right.elements[6] + left.elements[12] * right.elements[7];
-		tmp.elements[5] = left.elements[1] * right.elements[4] + left.elements[5] * right.elements[5] + left.elements[9] * right.elements[6] + left.elements[13] * right.elements[7];
-		tmp.elements[6] = left.elements[2] * right.elements[4] + left.elements[6] * right.elements[5] + left.elements[10] * right.elements[6] + left.elements[14] * right.elements[7];
-		tmp.elements[7] = left.elements[3] * right.elements[4] + left.elements[7] * right.elements[5] + left.elements[11] * right.elements[6] + left.elements[15] * right.elements[7];
-
-		tmp.elements[8] = left.elements[0] * right.elements[8] + left.elements[4] * right.elements[9] + left.elements[8] * right.elements[10] + left.elements[12] * right.elements[11];
-		tmp.elements[9] = left.elements[1] * right.elements[8] + left.elements[5] * right.elements[9] + left.elements[9] * right.elements[10] + left.elements[13] * right.elements[11];
-		tmp.elements[10] = left.elements[2] * right.elements[8] + left.elements[6] * right.elements[9] + left.elements[10] * right.elements[10] + left.elements[14] * right.elements[11];
-		tmp.elements[11] = left.elements[3] * right.elements[8] + left.elements[7] * right.elements[9] + left.elements[11] * right.elements[10] + left.elements[15] * right.elements[11];
-
-		tmp.elements[12] = left.elements[0] * right.elements[12] + left.elements[4] * right.elements[13] + left.elements[8] * right.elements[14] + left.elements[12] * right.elements[15];
-		tmp.elements[13] = left.elements[1] * right.elements[12] + left.elements[5] * right.elements[13] + left.elements[9] * right.elements[14] + left.elements[13] * right.elements[15];
-		tmp.elements[14] = left.elements[2] * right.elements[12] + left.elements[6] * right.elements[13] + left.elements[10] * right.elements[14] + left.elements[14] * right.elements[15];
-		tmp.elements[15] = left.elements[3] * right.elements[12] + left.elements[7] * right.elements[13] + left.elements[11] * right.elements[14] + left.elements[15] * right.elements[15];
-
+		if constexpr (std::is_same_v<T, float>)
+		{
+#if defined(REALSIX_SIMD_AVX)
+			// Two result columns per iteration, each column of left broadcast to both 128 bit halves
+			__m256 l0 = _mm256_broadcast_ps(&left.col[0]);
+			__m256 l1 = _mm256_broadcast_ps(&left.col[1]);
+			__m256 l2 = _mm256_broadcast_ps(&left.col[2]);
+			__m256 l3 = _mm256_broadcast_ps(&left.col[3]);
+			for (uint8_t i = 0; i < 16; i += 8)
+			{
+				__m256 r = _mm256_loadu_ps(&right.elements[i]);
+				__m256 c = _mm256_mul_ps(l0, _mm256_permute_ps(r, 0x00));
+				c = _mm256_add_ps(c, _mm256_mul_ps(l1, _mm256_permute_ps(r, 0x55)));
+				c = _mm256_add_ps(c, _mm256_mul_ps(l2, _mm256_permute_ps(r, 0xAA)));
+				c = _mm256_add_ps(c, _mm256_mul_ps(l3, _mm256_permute_ps(r, 0xFF)));
+				_mm256_storeu_ps(&tmp.elements[i], c);
+			}
+#else
+			// Every result column is the columns of left weighted by the lanes of the right column
+			for (uint8_t i = 0; i < 4; ++i)
+			{
+				Simd::Float4 c = Simd::Mul(left.col[0], Simd::SplatLane<0>(right.col[i]));
+				c = Simd::MulAdd(left.col[1], Simd::SplatLane<1>(right.col[i]), c);
+				c = Simd::MulAdd(left.col[2], Simd::SplatLane<2>(right.col[i]), c);
+				tmp.col[i] = Simd::MulAdd(left.col[3], Simd::SplatLane<3>(right.col[i]), c);
+			}
+#endif
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 4; ++i)
+				for (uint8_t j = 0; j < 4; ++j)
+					tmp.elements[i * 4 + j] = left.elements[j] * right.elements[i * 4] + left.elements[4 + j] * right.elements[i * 4 + 1] + left.elements[8 + j] * right.elements[i * 4 + 2] + left.elements[12 + j] * right.elements[i * 4 + 3];
+		}
 		return tmp;
 	}
 
@@ -523,9 +552,16 @@ namespace RealSix
 		if (!Math::IsNearZero(value))
 		{
 			Matrix4<T> tmp;
-
-			for (uint8_t i = 0; i < 4; ++i)
-				tmp.col[i] = _mm_div_ps(left.col[i], _mm_set_ps1(value));
+			if constexpr (std::is_same_v<T, float>)
+			{
+				for (uint8_t i = 0; i < 4; ++i)
+					tmp.col[i] = Simd::Div(left.col[i], Simd::Splat(value));
+			}
+			else
+			{
+				for (uint8_t i = 0; i < 16; ++i)
+					tmp.elements[i] = left.elements[i] / value;
+			}
 			return tmp;
 		}
 		return left;
@@ -535,8 +571,16 @@ namespace RealSix
 	inline Matrix4<T> operator*(const T &value, const Matrix4<T2> &right)
 	{
 		Matrix4<T> tmp;
-		for (uint8_t i = 0; i < 4; ++i)
-			tmp.col[i] = _mm_mul_ps(right.col[i], _mm_set_ps1(value));
+		if constexpr (std::is_same_v<T, float> && std::is_same_v<T2, float>)
+		{
+			for (uint8_t i = 0; i < 4; ++i)
+				tmp.col[i] = Simd::Mul(right.col[i], Simd::Splat(value));
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 16; ++i)
+				tmp.elements[i] = static_cast<T>(right.elements[i] * value);
+		}
 		return tmp;
 	}
 
@@ -560,7 +604,7 @@ namespace RealSix
 	inline Matrix4<T> &Matrix4<T>::operator-=(const Matrix4<T2> &right)
 	{
 
-		*this = this - right;
+		*this = *this - right;
 		return *this;
 	}
 
@@ -585,7 +629,9 @@ namespace RealSix
 	inline Matrix4<T> Matrix4<T>::Translate(const Vector3<T> &position)
 	{
 		Matrix4<T> tmp;
-		tmp.col[3] = _mm_set_ps(static_cast<T>(1.0f), position.z, position.y, position.x);
+		tmp.elements[12] = position.x;
+		tmp.elements[13] = position.y;
+		tmp.elements[14] = position.z;
 		return tmp;
 	}
 
@@ -593,8 +639,8 @@ namespace RealSix
 	inline Matrix4<T> Matrix4<T>::Rotate(const Vector3<T> &axis, const T &radian)
 	{
 		Matrix4<T> tmp;
-		T radian_cos = Math::Cos(radian);
-		T radian_sin = Math::Sin(radian);
+		T radian_cos = HotMath::Cos(radian);
+		T radian_sin = HotMath::Sin(radian);
 		T tmpNum = static_cast<T>(1.0f) - radian_cos;
 
 		tmp.elements[0] = axis.x * axis.x * tmpNum + radian_cos;
@@ -636,58 +682,214 @@ namespace RealSix
 	inline Matrix4<T> Matrix4<T>::Transpose(const Matrix4<T> &right)
 	{
 		Matrix4<T> tmp;
-		tmp.col[0] = _mm_set_ps(right.elements[12], right.elements[8], right.elements[4], right.elements[0]);
-		tmp.col[1] = _mm_set_ps(right.elements[13], right.elements[9], right.elements[5], right.elements[1]);
-		tmp.col[2] = _mm_set_ps(right.elements[14], right.elements[10], right.elements[6], right.elements[2]);
-		tmp.col[3] = _mm_set_ps(right.elements[15], right.elements[11], right.elements[7], right.elements[3]);
-
+		if constexpr (std::is_same_v<T, float>)
+		{
+			tmp.col = right.col;
+			Simd::Transpose(tmp.col[0], tmp.col[1], tmp.col[2], tmp.col[3]);
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 4; ++i)
+				for (uint8_t j = 0; j < 4; ++j)
+					tmp.elements[i * 4 + j] = right.elements[j * 4 + i];
+		}
 		return tmp;
 	}
 
 	template <typename T>
 	inline Matrix4<T> Matrix4<T>::Inverse(const Matrix4<T> &right)
 	{
-		return Matrix4f::Transpose(Matrix4<T>::Adjoint(right)) / Matrix4<T>::Determinant(right);
+		if constexpr (std::is_same_v<T, float>)
+		{
+			// Block wise inverse of the 2x2 sub matrices | A B |, each held in one register.
+			//                                             | C D |
+			// Inverting the transpose gives the transposed inverse, so it works on columns as well as on rows
+			Simd::Float4 a = Simd::Shuffle<0, 1, 0, 1>(right.col[0], right.col[1]);
+			Simd::Float4 b = Simd::Shuffle<2, 3, 2, 3>(right.col[0], right.col[1]);
+			Simd::Float4 c = Simd::Shuffle<0, 1, 0, 1>(right.col[2], right.col[3]);
+			Simd::Float4 d = Simd::Shuffle<2, 3, 2, 3>(right.col[2], right.col[3]);
+
+			// 2x2 sub matrix products, adj() is the adjugate
+			auto mul2 = [](Simd::Float4 l, Simd::Float4 r)
+			{
+				return Simd::Add(Simd::Mul(l, Simd::Swizzle<0, 3, 0, 3>(r)), Simd::Mul(Simd::Swizzle<1, 0, 3, 2>(l), Simd::Swizzle<2, 1, 2, 1>(r)));
+			};
+			auto adjMul2 = [](Simd::Float4 l, Simd::Float4 r)
+			{
+				return Simd::Sub(Simd::Mul(Simd::Swizzle<3, 3, 0, 0>(l), r), Simd::Mul(Simd::Swizzle<1, 1, 2, 2>(l), Simd::Swizzle<2, 3, 0, 1>(r)));
+			};
+			auto mulAdj2 = [](Simd::Float4 l, Simd::Float4 r)
+			{
+				return Simd::Sub(Simd::Mul(l, Simd::Swizzle<3, 0, 3, 0>(r)), Simd::Mul(Simd::Swizzle<1, 0, 3, 2>(l), Simd::Swizzle<2, 1, 2, 1>(r)));
+			};
+
+			// (|A|, |B|, |C|, |D|)
+			Simd::Float4 detSub = Simd::Sub(Simd::Mul(Simd::Shuffle<0, 2, 0, 2>(right.col[0], right.col[2]), Simd::Shuffle<1, 3, 1, 3>(right.col[1], right.col[3])),
+											Simd::Mul(Simd::Shuffle<1, 3, 1, 3>(right.col[0], right.col[2]), Simd::Shuffle<0, 2, 0, 2>(right.col[1], right.col[3])));
+			Simd::Float4 detA = Simd::SplatLane<0>(detSub);
+			Simd::Float4 detB = Simd::SplatLane<1>(detSub);
+			Simd::Float4 detC = Simd::SplatLane<2>(detSub);
+			Simd::Float4 detD = Simd::SplatLane<3>(detSub);
+
+			Simd::Float4 dc = adjMul2(d, c);
+			Simd::Float4 ab = adjMul2(a, b);
+			Simd::Float4 x = Simd::Sub(Simd::Mul(detD, a), mul2(b, dc));
+			Simd::Float4 w = Simd::Sub(Simd::Mul(detA, d), mul2(c, ab));
+			Simd::Float4 y = Simd::Sub(Simd::Mul(detB, c), mulAdj2(d, ab));
+			Simd::Float4 z = Simd::Sub(Simd::Mul(detC, b), mulAdj2(a, dc));
+
+			// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+			Simd::Float4 det = Simd::Add(Simd::Mul(detA, detD), Simd::Mul(detB, detC));
+			det = Simd::Sub(det, Simd::HorizontalAdd(Simd::Mul(ab, Simd::Swizzle<0, 2, 1, 3>(dc))));
+
+			// A singular matrix keeps the behavior of dividing the adjugate only by a non zero determinant
+			if (Math::Abs(Simd::GetX(det)) <= std::numeric_limits<float>::epsilon())
+				return Matrix4<T>::Transpose(Matrix4<T>::Adjoint(right));
+
+			Simd::Float4 invDet = Simd::Div(Simd::Set(1.0f, -1.0f, -1.0f, 1.0f), det);
+			x = Simd::Mul(x, invDet);
+			y = Simd::Mul(y, invDet);
+			z = Simd::Mul(z, invDet);
+			w = Simd::Mul(w, invDet);
+
+			Matrix4<T> tmp;
+			tmp.col[0] = Simd::Shuffle<3, 1, 3, 1>(x, y);
+			tmp.col[1] = Simd::Shuffle<2, 0, 2, 0>(x, y);
+			tmp.col[2] = Simd::Shuffle<3, 1, 3, 1>(z, w);
+			tmp.col[3] = Simd::Shuffle<2, 0, 2, 0>(z, w);
+			return tmp;
+		}
+		else
+		{
+			Matrix4<T> tmp = Matrix4<T>::Transpose(Matrix4<T>::Adjoint(right));
+			T det = Matrix4<T>::Determinant(right);
+			if (Math::Abs(det) <= std::numeric_limits<T>::epsilon())
+				return tmp;
+			for (uint8_t i = 0; i < 16; ++i)
+				tmp.elements[i] /= det;
+			return tmp;
+		}
+	}
+
+	template <typename T>
+	inline Matrix4<T> Matrix4<T>::InverseAffine(const Matrix4<T> &right)
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			// The rows of the inverse of the upper 3x3 are the cross products of its columns over the determinant
+			Simd::Float4 c0 = Simd::Mul(right.col[0], Simd::Set(1.0f, 1.0f, 1.0f, 0.0f));
+			Simd::Float4 c1 = Simd::Mul(right.col[1], Simd::Set(1.0f, 1.0f, 1.0f, 0.0f));
+			Simd::Float4 c2 = Simd::Mul(right.col[2], Simd::Set(1.0f, 1.0f, 1.0f, 0.0f));
+
+			Simd::Float4 r0 = Simd::Cross3(c1, c2);
+			Simd::Float4 r1 = Simd::Cross3(c2, c0);
+			Simd::Float4 r2 = Simd::Cross3(c0, c1);
+
+			Simd::Float4 det = Simd::HorizontalAdd(Simd::Mul(c0, r0));
+			if (Math::Abs(Simd::GetX(det)) <= std::numeric_limits<float>::epsilon())
+				return Matrix4<T>::Inverse(right);
+
+			Simd::Float4 invDet = Simd::Div(Simd::Splat(1.0f), det);
+			r0 = Simd::Mul(r0, invDet);
+			r1 = Simd::Mul(r1, invDet);
+			r2 = Simd::Mul(r2, invDet);
+			Simd::Float4 r3 = Simd::Splat(0.0f);
+			Simd::Transpose(r0, r1, r2, r3);
+
+			// -inverse(3x3) * translation, with w set to 1
+			Simd::Float4 t = right.col[3];
+			Simd::Float4 position = Simd::Mul(r0, Simd::SplatLane<0>(t));
+			position = Simd::MulAdd(r1, Simd::SplatLane<1>(t), position);
+			position = Simd::MulAdd(r2, Simd::SplatLane<2>(t), position);
+
+			Matrix4<T> tmp;
+			tmp.col[0] = r0;
+			tmp.col[1] = r1;
+			tmp.col[2] = r2;
+			tmp.col[3] = Simd::Sub(Simd::Set(0.0f, 0.0f, 0.0f, 1.0f), position);
+			return tmp;
+		}
+		else
+		{
+			Matrix3<T> rotScale = Matrix3<T>::Inverse(Matrix4<T>::ToMatrix3(right));
+			Matrix4<T> tmp = Matrix3<T>::ToMatrix4(rotScale);
+			Vector3<T> position = Vector3<T>(right.elements[12], right.elements[13], right.elements[14]);
+			for (uint8_t i = 0; i < 3; ++i)
+				tmp.elements[12 + i] = -(tmp.elements[i] * position.x + tmp.elements[4 + i] * position.y + tmp.elements[8 + i] * position.z);
+			return tmp;
+		}
+	}
+
+	template <typename T>
+	inline Vector3<T> Matrix4<T>::TransformPoint(const Matrix4<T> &matrix, const Vector3<T> &point)
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			Simd::Float4 result = Simd::MulAdd(matrix.col[0], Simd::Splat(point.x), matrix.col[3]);
+			result = Simd::MulAdd(matrix.col[1], Simd::Splat(point.y), result);
+			result = Simd::MulAdd(matrix.col[2], Simd::Splat(point.z), result);
+
+			alignas(16) float lanes[4];
+			Simd::Store(lanes, result);
+			return Vector3<T>(lanes[0], lanes[1], lanes[2]);
+		}
+		else
+			return Vector4<T>::ToVector3(matrix * Vector4<T>(point, static_cast<T>(1.0f)));
+	}
+
+	template <typename T>
+	inline Vector3<T> Matrix4<T>::TransformVector(const Matrix4<T> &matrix, const Vector3<T> &vector)
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			Simd::Float4 result = Simd::Mul(matrix.col[0], Simd::Splat(vector.x));
+			result = Simd::MulAdd(matrix.col[1], Simd::Splat(vector.y), result);
+			result = Simd::MulAdd(matrix.col[2], Simd::Splat(vector.z), result);
+
+			alignas(16) float lanes[4];
+			Simd::Store(lanes, result);
+			return Vector3<T>(lanes[0], lanes[1], lanes[2]);
+		}
+		else
+			return Vector4<T>::ToVector3(matrix * Vector4<T>(vector, static_cast<T>(0.0f)));
 	}
 
 	template <typename T>
 	inline Matrix4<T>::Matrix4()
-		: col({_mm_set_ps(static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(1.0f)),
-			   _mm_set_ps(static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(1.0f), static_cast<T>(0.0f)),
-			   _mm_set_ps(static_cast<T>(0.0f), static_cast<T>(1.0f), static_cast<T>(0.0f), static_cast<T>(0.0f)),
-			   _mm_set_ps(static_cast<T>(1.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f))})
+		: Matrix4(static_cast<T>(1.0f))
 	{
 	}
 
 	template <typename T>
 	inline Matrix4<T>::Matrix4(const T &value)
-		: col({_mm_set_ps(static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), value),
-			   _mm_set_ps(static_cast<T>(0.0f), static_cast<T>(0.0f), value, static_cast<T>(0.0f)),
-			   _mm_set_ps(static_cast<T>(0.0f), value, static_cast<T>(0.0f), static_cast<T>(0.0f)),
-			   _mm_set_ps(value, static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f))})
+		: elements({value, static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f),
+					static_cast<T>(0.0f), value, static_cast<T>(0.0f), static_cast<T>(0.0f),
+					static_cast<T>(0.0f), static_cast<T>(0.0f), value, static_cast<T>(0.0f),
+					static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), value})
 	{
 	}
 
 	template <typename T>
 	inline Matrix4<T>::Matrix4(const Vector4<T> &diagonal)
-		: col({_mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f))})
+		: Matrix4(diagonal.x, diagonal.y, diagonal.z, diagonal.w)
 	{
-		Set(diagonal);
 	}
 
 	template <typename T>
 	inline Matrix4<T>::Matrix4(const T &d00, const T &d11, const T &d22, const T &d33)
-		: col({_mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f)), _mm_set_ps1(static_cast<T>(0.0f))})
+		: elements({d00, static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f),
+					static_cast<T>(0.0f), d11, static_cast<T>(0.0f), static_cast<T>(0.0f),
+					static_cast<T>(0.0f), static_cast<T>(0.0f), d22, static_cast<T>(0.0f),
+					static_cast<T>(0.0f), static_cast<T>(0.0f), static_cast<T>(0.0f), d33})
 	{
-		Set(d00, d11, d22, d33);
 	}
 
 	template <typename T>
 	inline Matrix4<T>::Matrix4(const T &e00, const T &e10, const T &e20, const T &e30, const T &e01, const T &e11, const T &e21, const T &e31, const T &e02, const T &e12, const T &e22, const T &e32, const T &e03, const T &e13, const T &e23, const T &e33)
-		: col({_mm_set_ps(e30, e20, e10, e00),
-			   _mm_set_ps(e31, e21, e11, e01),
-			   _mm_set_ps(e32, e22, e12, e02),
-			   _mm_set_ps(e33, e23, e13, e03)})
+		: elements({e00, e10, e20, e30,
+					e01, e11, e21, e31,
+					e02, e12, e22, e32,
+					e03, e13, e23, e33})
 	{
 	}
 
@@ -709,10 +911,10 @@ namespace RealSix
 	template <typename T>
 	inline void Matrix4<T>::Set(const T &e00, const T &e10, const T &e20, const T &e30, const T &e01, const T &e11, const T &e21, const T &e31, const T &e02, const T &e12, const T &e22, const T &e32, const T &e03, const T &e13, const T &e23, const T &e33)
 	{
-		col[0] = _mm_set_ps(e30, e20, e10, e00);
-		col[1] = _mm_set_ps(e31, e21, e11, e01);
-		col[2] = _mm_set_ps(e32, e22, e12, e02);
-		col[2] = _mm_set_ps(e33, e23, e13, e03);
+		elements = {e00, e10, e20, e30,
+					e01, e11, e21, e31,
+					e02, e12, e22, e32,
+					e03, e13, e23, e33};
 	}
 
 	template <typename T>
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Vector3.hpp"
 #include "Matrix3.hpp"
+#include "FastMath.hpp"
 #include <cmath>
 #include <array>
 namespace RealSix
@@ -98,9 +99,9 @@ namespace RealSix
 	inline Quaternion<T>::Quaternion(const Vector3<T> &axis, T radian)
 	{
 		Vector3 axis_nor = Vector3<T>::Normalize(axis);
-		float sca = Math::Sin(radian / 2);
+		float sca = HotMath::Sin(radian / 2);
 		vec = axis_nor * sca;
-		scalar = Math::Cos(radian / 2);
+		scalar = HotMath::Cos(radian / 2);
 	}
 
 	template <typename T>
@@ -361,10 +362,10 @@ namespace RealSix
 
 		if (cosom < 0.9999f)
 		{
-			const float omega = Math::ArcCos(cosom);
-			const float invSin = 1.0f / Math::Sin(omega);
-			scale0 = Math::Sin((1.0f - factor) * omega) * invSin;
-			scale1 = Math::Sin(factor * omega) * invSin;
+			const float omega = HotMath::ArcCos(cosom);
+			const float invSin = 1.0f / HotMath::Sin(omega);
+			scale0 = HotMath::Sin((1.0f - factor) * omega) * invSin;
+			scale1 = HotMath::Sin(factor * omega) * invSin;
 		}
 		else
 		{
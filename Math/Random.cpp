@@ -1,28 +1,269 @@
 #include "Random.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <random>
+#include "FastMath.hpp"
+#include "Core/Marco.hpp"
 namespace RealSix
 {
-	std::mt19937 Random::mRandomNumGenerator;
+	namespace
+	{
+		constexpr float UINT24_TO_FLOAT = 1.0f / 16777216.0f;
+
+		uint64_t RotateLeft(uint64_t value, uint32_t shift)
+		{
+			return (value << shift) | (value >> (64 - shift));
+		}
+
+		uint64_t SplitMix64(uint64_t &state)
+		{
+			uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			return z ^ (z >> 31);
+		}
+
+		// One xoshiro256** step of every lane, laid out as structure of arrays so the compiler keeps
+		// each state word of all lanes in vector registers
+		inline void Step(uint64_t (&state)[4][RandomStream::LANES], uint32_t *out)
+		{
+			uint64_t *s0 = state[0];
+			uint64_t *s1 = state[1];
+			uint64_t *s2 = state[2];
+			uint64_t *s3 = state[3];
+			for (size_t lane = 0; lane < RandomStream::LANES; ++lane)
+			{
+				const uint64_t result = RotateLeft(s1[lane] * 5, 7) * 9;
+				const uint64_t t = s1[lane] << 17;
+				s2[lane] ^= s0[lane];
+				s3[lane] ^= s1[lane];
+				s1[lane] ^= s2[lane];
+				s0[lane] ^= s3[lane];
+				s2[lane] ^= t;
+				s3[lane] = RotateLeft(s3[lane], 45);
+
+				out[lane * 2] = static_cast<uint32_t>(result);
+				out[lane * 2 + 1] = static_cast<uint32_t>(result >> 32);
+			}
+		}
+
+		float ToFloat01(uint32_t value)
+		{
+			return static_cast<float>(value >> 8) * UINT24_TO_FLOAT;
+		}
+
+		// Multiply shift mapping into [0, range), the bias is below range / 2^32
+		uint32_t ToRange(uint32_t value, uint64_t range)
+		{
+			return static_cast<uint32_t>((value * range) >> 32);
+		}
+
+		uint64_t GetRange(int32_t min, int32_t max)
+		{
+			return static_cast<uint64_t>(static_cast<int64_t>(max) - static_cast<int64_t>(min)) + 1;
+		}
+
+		// z uniform in [-1, 1) and a uniform angle around it give a uniform point on the sphere
+		Vector3f ToUnitVector(uint32_t zValue, uint32_t angleValue)
+		{
+			const float z = ToFloat01(zValue) * 2.0f - 1.0f;
+			const float angle = ToFloat01(angleValue) * Math::TWO_PI;
+			const float radius = Math::Sqrt(Math::Max(1.0f - z * z, 0.0f));
+			return Vector3f(radius * FastMath::Cos(angle), radius * FastMath::Sin(angle), z);
+		}
+
+		std::atomic<uint64_t> gSeed{0};
+		std::atomic<uint64_t> gSeedGeneration{0};
+		std::atomic<uint64_t> gNextStreamId{0};
+	}
+
+	RandomStream::RandomStream(uint64_t seed, uint64_t streamId)
+	{
+		Seed(seed, streamId);
+	}
+
+	void RandomStream::Seed(uint64_t seed, uint64_t streamId)
+	{
+		uint64_t idState = streamId;
+		uint64_t state = seed ^ SplitMix64(idState);
+		for (size_t word = 0; word < 4; ++word)
+			for (size_t lane = 0; lane < LANES; ++lane)
+				mState[word][lane] = SplitMix64(state);
+		mBufferIndex = VALUES_PER_STEP;
+	}
+
+	void RandomStream::Refill()
+	{
+		Step(mState, mBuffer);
+		mBufferIndex = 0;
+	}
+
+	uint32_t RandomStream::NextUInt32()
+	{
+		if (mBufferIndex == VALUES_PER_STEP)
+			Refill();
+		return mBuffer[mBufferIndex++];
+	}
+
+	float RandomStream::NextFloat01()
+	{
+		return ToFloat01(NextUInt32());
+	}
+
+	float RandomStream::NextFloat(float min, float max)
+	{
+		return min + (max - min) * NextFloat01();
+	}
+
+	int32_t RandomStream::NextInt(int32_t min, int32_t max)
+	{
+		return static_cast<int32_t>(static_cast<int64_t>(min) + ToRange(NextUInt32(), GetRange(min, max)));
+	}
+
+	Vector3f RandomStream::NextUnitVector()
+	{
+		const uint32_t zValue = NextUInt32();
+		return ToUnitVector(zValue, NextUInt32());
+	}
+
+	// Radius from the inverse of the r^3 volume distribution instead of rejection sampling the cube
+	Vector3f RandomStream::NextVector3InUnitBall()
+	{
+		const Vector3f direction = NextUnitVector();
+		return direction * std::cbrt(NextFloat01());
+	}
+
+	REALSIX_TARGET_CLONES void RandomStream::FillUInt32(std::span<uint32_t> out)
+	{
+		size_t i = 0;
+		for (; i < out.size() && mBufferIndex < VALUES_PER_STEP; ++i)
+			out[i] = mBuffer[mBufferIndex++];
+		for (; i + VALUES_PER_STEP <= out.size(); i += VALUES_PER_STEP)
+			Step(mState, out.data() + i);
+		if (i < out.size())
+		{
+			Refill();
+			for (; i < out.size(); ++i)
+				out[i] = mBuffer[mBufferIndex++];
+		}
+	}
+
+	// Draws the values of up to a block of items at a time and hands them to convert(values, first item, item count)
+	template <typename Convert>
+	void RandomStream::Fill(uint32_t valuesPerItem, size_t count, Convert &&convert)
+	{
+		constexpr size_t BLOCK_SIZE = VALUES_PER_STEP * 32;
+		alignas(64) uint32_t values[BLOCK_SIZE];
+		for (size_t begin = 0; begin < count;)
+		{
+			const size_t items = std::min(count - begin, BLOCK_SIZE / valuesPerItem);
+			FillUInt32({values, items * valuesPerItem});
+			convert(values, begin, items);
+			begin += items;
+		}
+	}
+
+	REALSIX_TARGET_CLONES void RandomStream::FillFloat01(std::span<float> out)
+	{
+		Fill(1, out.size(), [&](const uint32_t *values, size_t begin, size_t items)
+			 {
+				 for (size_t i = 0; i < items; ++i)
+					 out[begin + i] = ToFloat01(values[i]); });
+	}
+
+	REALSIX_TARGET_CLONES void RandomStream::FillFloat(std::span<float> out, float min, float max)
+	{
+		const float scale = max - min;
+		Fill(1, out.size(), [&](const uint32_t *values, size_t begin, size_t items)
+			 {
+				 for (size_t i = 0; i < items; ++i)
+					 out[begin + i] = min + scale * ToFloat01(values[i]); });
+	}
+
+	REALSIX_TARGET_CLONES void RandomStream::FillInt(std::span<int32_t> out, int32_t min, int32_t max)
+	{
+		const uint64_t range = GetRange(min, max);
+		Fill(1, out.size(), [&](const uint32_t *values, size_t begin, size_t items)
+			 {
+				 for (size_t i = 0; i < items; ++i)
+					 out[begin + i] = static_cast<int32_t>(static_cast<uint32_t>(min) + ToRange(values[i], range)); });
+	}
+
+	REALSIX_TARGET_CLONES void RandomStream::FillUnitVectors(const Vector3fStream &out)
+	{
+		assert(out.y.size() == out.Size() && out.z.size() == out.Size());
+
+		Fill(2, out.Size(), [&](const uint32_t *values, size_t begin, size_t items)
+			 {
+				 size_t i = 0;
+				 for (; i + 4 <= items; i += 4)
+				 {
+					 alignas(16) float z[4], angle[4];
+					 for (size_t lane = 0; lane < 4; ++lane)
+					 {
+						 z[lane] = ToFloat01(values[(i + lane) * 2]) * 2.0f - 1.0f;
+						 angle[lane] = ToFloat01(values[(i + lane) * 2 + 1]) * Math::TWO_PI;
+					 }
+					 const Simd::Float4 zs = Simd::Load(z);
+					 const Simd::Float4 angles = Simd::Load(angle);
+					 const Simd::Float4 radius = Simd::Sqrt(Simd::Max(Simd::Sub(Simd::Splat(1.0f), Simd::Mul(zs, zs)), Simd::Splat(0.0f)));
+					 Simd::Store(out.x.data() + begin + i, Simd::Mul(radius, FastMath::Cos(angles)));
+					 Simd::Store(out.y.data() + begin + i, Simd::Mul(radius, FastMath::Sin(angles)));
+					 Simd::Store(out.z.data() + begin + i, zs);
+				 }
+				 for (; i < items; ++i)
+				 {
+					 const Vector3f vector = ToUnitVector(values[i * 2], values[i * 2 + 1]);
+					 out.x[begin + i] = vector.x;
+					 out.y[begin + i] = vector.y;
+					 out.z[begin + i] = vector.z;
+				 } });
+	}
 
 	void Random::Init()
 	{
 		std::random_device rd;
-		mRandomNumGenerator.seed(rd());
+		Init((static_cast<uint64_t>(rd()) << 32) | rd());
+	}
+
+	void Random::Init(uint64_t seed)
+	{
+		gSeed.store(seed, std::memory_order_relaxed);
+		gNextStreamId.store(0, std::memory_order_relaxed);
+		gSeedGeneration.fetch_add(1, std::memory_order_release);
+	}
+
+	RandomStream &Random::GetThreadStream()
+	{
+		struct ThreadStream
+		{
+			RandomStream stream;
+			uint64_t generation{~0ull};
+		};
+		thread_local ThreadStream threadStream;
+
+		const uint64_t generation = gSeedGeneration.load(std::memory_order_acquire);
+		if (threadStream.generation != generation)
+		{
+			threadStream.stream.Seed(gSeed.load(std::memory_order_relaxed), gNextStreamId.fetch_add(1, std::memory_order_relaxed));
+			threadStream.generation = generation;
+		}
+		return threadStream.stream;
 	}
 
 	float Random::GetFloat(float min, float max)
 	{
-		std::uniform_real_distribution<float> dis(min, max);
-		return dis(mRandomNumGenerator);
+		return GetThreadStream().NextFloat(min, max);
 	}
 
 	float Random::GetFloat01()
 	{
-		return GetFloat(0.0f, 1.0f);
+		return GetThreadStream().NextFloat01();
 	}
 
 	int Random::GetInt(int min, int max)
 	{
-		std::uniform_int_distribution<int> dis(min, max);
-		return dis(mRandomNumGenerator);
+		return GetThreadStream().NextInt(min, max);
 	}
-}
\ No newline at end of file
+}
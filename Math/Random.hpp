@@ -1,13 +1,65 @@
 #pragma once
-#include <random>
+#include <cstdint>
+#include <span>
 #include "Vector2.hpp"
 #include "Vector3.hpp"
+#include "BatchMath.hpp"
 namespace RealSix
 {
+	// xoshiro256** run as LANES interleaved generators, so the bulk fills advance all of them in
+	// one SIMD step. Every function draws from the same sequence of 32 bit values: lane l of step n
+	// yields values 16n + 2l and 16n + 2l + 1, which keeps the output identical on every CPU and
+	// mixing single draws with fills deterministic for a given seed and stream id
+	class RandomStream
+	{
+	public:
+		static constexpr size_t LANES = 8;
+		static constexpr size_t VALUES_PER_STEP = LANES * 2;
+
+		RandomStream(uint64_t seed = 0, uint64_t streamId = 0);
+
+		// Streams with the same seed and different ids are independent, use one per job or thread
+		void Seed(uint64_t seed, uint64_t streamId);
+
+		uint32_t NextUInt32();
+		// [0, 1) with 24 bits of resolution
+		float NextFloat01();
+		float NextFloat(float min, float max);
+		// [min, max], max included like std::uniform_int_distribution
+		int32_t NextInt(int32_t min, int32_t max);
+		// Uniform on the unit sphere
+		Vector3f NextUnitVector();
+		// Uniform inside the unit ball
+		Vector3f NextVector3InUnitBall();
+
+		void FillUInt32(std::span<uint32_t> out);
+		void FillFloat01(std::span<float> out);
+		void FillFloat(std::span<float> out, float min, float max);
+		void FillInt(std::span<int32_t> out, int32_t min, int32_t max);
+		void FillUnitVectors(const Vector3fStream &out);
+
+	private:
+		void Refill();
+		template <typename Convert>
+		void Fill(uint32_t valuesPerItem, size_t count, Convert &&convert);
+
+		alignas(64) uint64_t mState[4][LANES];
+		alignas(64) uint32_t mBuffer[VALUES_PER_STEP];
+		uint32_t mBufferIndex;
+	};
+
+	// Convenience front end over one RandomStream per thread, so callers on different threads
+	// never contend. Thread streams take ids in the order threads first draw, results that must be
+	// reproducible across threads should own a RandomStream seeded with a fixed id instead
 	class Random
 	{
 	public:
+		// Seeds from std::random_device
 		static void Init();
+		// Reseeds every thread stream lazily on its next draw, call it before starting workers
+		static void Init(uint64_t seed);
+
+		static RandomStream &GetThreadStream();
 
 		static float GetFloat(float min, float max);
 
@@ -19,10 +71,7 @@ namespace RealSix
 		template <typename T>
 		static Vector3<T> GetVector3(const Vector3<T> &min, const Vector3<T> &max);
 		template <typename T>
-		Vector3<T> GetVector3InUnitDisk();
-
-	private:
-		static std::mt19937 mRandomNumGenerator;
+		static Vector3<T> GetVector3InUnitDisk();
 	};
 	template <typename T>
 	Vector2<T> Random::GetVector2(const Vector2<T> &min, const Vector2<T> &max)
@@ -40,11 +89,7 @@ namespace RealSix
 	template <typename T>
 	Vector3<T> Random::GetVector3InUnitDisk()
 	{
-		Vector3<T> result;
-		do
-		{
-			result = GetVector3<T>(Vector3<T>(-1.0f, -1.0f, -1.0f), Vector3<T>(1.0f, 1.0f, 1.0f));
-		} while (result.Length() > 1);
-		return result;
+		Vector3f result = GetThreadStream().NextVector3InUnitBall();
+		return Vector3<T>(result.x, result.y, result.z);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,379 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REALSIX_SIMD_SSE
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define REALSIX_SIMD_AVX
+#include <immintrin.h>
+#endif
+#if defined(__FMA__) || defined(__AVX2__)
+#define REALSIX_SIMD_FMA
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define REALSIX_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Four float lanes on SSE, NEON or plain scalar code, the building blocks of the Matrix4 kernels
+namespace RealSix::Simd
+{
+#if defined(REALSIX_SIMD_SSE)
+	using Float4 = __m128;
+	// All bits set in the lanes where a comparison held
+	using Mask4 = __m128;
+	// Significant bits of RSqrtEstimate
+	constexpr uint32_t RSQRT_ESTIMATE_BITS = 12;
+#elif defined(REALSIX_SIMD_NEON)
+	using Float4 = float32x4_t;
+	using Mask4 = uint32x4_t;
+	constexpr uint32_t RSQRT_ESTIMATE_BITS = 8;
+#else
+	struct alignas(16) Float4
+	{
+		float lanes[4];
+	};
+	struct Mask4
+	{
+		bool lanes[4];
+	};
+	constexpr uint32_t RSQRT_ESTIMATE_BITS = 23;
+#endif
+
+	// Storage of four lanes of T, a SIMD register for float and a plain array for the other types
+	template <typename T>
+	struct Lane4
+	{
+		using Type = std::array<T, 4>;
+	};
+
+	template <>
+	struct Lane4<float>
+	{
+		using Type = Float4;
+	};
+
+	inline Float4 Set(float x, float y, float z, float w)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_setr_ps(x, y, z, w);
+#elif defined(REALSIX_SIMD_NEON)
+		const float lanes[4] = {x, y, z, w};
+		return vld1q_f32(lanes);
+#else
+		return Float4{{x, y, z, w}};
+#endif
+	}
+
+	inline Float4 Splat(float value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_set_ps1(value);
+#elif defined(REALSIX_SIMD_NEON)
+		return vdupq_n_f32(value);
+#else
+		return Float4{{value, value, value, value}};
+#endif
+	}
+
+	// Unaligned load and store of four consecutive floats
+	inline Float4 Load(const float *src)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_loadu_ps(src);
+#elif defined(REALSIX_SIMD_NEON)
+		return vld1q_f32(src);
+#else
+		return Float4{{src[0], src[1], src[2], src[3]}};
+#endif
+	}
+
+	inline void Store(float *dst, Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		_mm_storeu_ps(dst, value);
+#elif defined(REALSIX_SIMD_NEON)
+		vst1q_f32(dst, value);
+#else
+		for (uint8_t i = 0; i < 4; ++i)
+			dst[i] = value.lanes[i];
+#endif
+	}
+
+	inline float GetX(Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_cvtss_f32(value);
+#elif defined(REALSIX_SIMD_NEON)
+		return vgetq_lane_f32(value, 0);
+#else
+		return value.lanes[0];
+#endif
+	}
+
+	inline Float4 Add(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_add_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vaddq_f32(left, right);
+#else
+		return Float4{{left.lanes[0] + right.lanes[0], left.lanes[1] + right.lanes[1], left.lanes[2] + right.lanes[2], left.lanes[3] + right.lanes[3]}};
+#endif
+	}
+
+	inline Float4 Sub(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_sub_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vsubq_f32(left, right);
+#else
+		return Float4{{left.lanes[0] - right.lanes[0], left.lanes[1] - right.lanes[1], left.lanes[2] - right.lanes[2], left.lanes[3] - right.lanes[3]}};
+#endif
+	}
+
+	inline Float4 Mul(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_mul_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vmulq_f32(left, right);
+#else
+		return Float4{{left.lanes[0] * right.lanes[0], left.lanes[1] * right.lanes[1], left.lanes[2] * right.lanes[2], left.lanes[3] * right.lanes[3]}};
+#endif
+	}
+
+	inline Float4 Div(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_div_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON) && defined(__aarch64__)
+		return vdivq_f32(left, right);
+#else
+		alignas(16) float l[4], r[4];
+		Store(l, left);
+		Store(r, right);
+		return Set(l[0] / r[0], l[1] / r[1], l[2] / r[2], l[3] / r[3]);
+#endif
+	}
+
+	// a * b + c, fused where the target has it
+	inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)
+	{
+#if defined(REALSIX_SIMD_FMA)
+		return _mm_fmadd_ps(a, b, c);
+#elif defined(REALSIX_SIMD_NEON)
+		return vmlaq_f32(c, a, b);
+#else
+		return Add(Mul(a, b), c);
+#endif
+	}
+
+	inline Float4 Min(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_min_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vminq_f32(left, right);
+#else
+		return Float4{{std::fmin(left.lanes[0], right.lanes[0]), std::fmin(left.lanes[1], right.lanes[1]), std::fmin(left.lanes[2], right.lanes[2]), std::fmin(left.lanes[3], right.lanes[3])}};
+#endif
+	}
+
+	inline Float4 Max(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_max_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vmaxq_f32(left, right);
+#else
+		return Float4{{std::fmax(left.lanes[0], right.lanes[0]), std::fmax(left.lanes[1], right.lanes[1]), std::fmax(left.lanes[2], right.lanes[2]), std::fmax(left.lanes[3], right.lanes[3])}};
+#endif
+	}
+
+	inline Float4 Abs(Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_andnot_ps(_mm_set_ps1(-0.0f), value);
+#elif defined(REALSIX_SIMD_NEON)
+		return vabsq_f32(value);
+#else
+		return Float4{{std::fabs(value.lanes[0]), std::fabs(value.lanes[1]), std::fabs(value.lanes[2]), std::fabs(value.lanes[3])}};
+#endif
+	}
+
+	inline Float4 Sqrt(Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_sqrt_ps(value);
+#elif defined(REALSIX_SIMD_NEON) && defined(__aarch64__)
+		return vsqrtq_f32(value);
+#else
+		alignas(16) float v[4];
+		Store(v, value);
+		return Set(std::sqrt(v[0]), std::sqrt(v[1]), std::sqrt(v[2]), std::sqrt(v[3]));
+#endif
+	}
+
+	// Approximate 1 / sqrt(value) good to RSQRT_ESTIMATE_BITS, refine it with Newton-Raphson steps for more
+	inline Float4 RSqrtEstimate(Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_rsqrt_ps(value);
+#elif defined(REALSIX_SIMD_NEON)
+		return vrsqrteq_f32(value);
+#else
+		alignas(16) float v[4];
+		Store(v, value);
+		return Set(1.0f / std::sqrt(v[0]), 1.0f / std::sqrt(v[1]), 1.0f / std::sqrt(v[2]), 1.0f / std::sqrt(v[3]));
+#endif
+	}
+
+	// Nearest integer, ties to even, for |value| < 2^31
+	inline Float4 Round(Float4 value)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_cvtepi32_ps(_mm_cvtps_epi32(value));
+#elif defined(REALSIX_SIMD_NEON) && defined(__aarch64__)
+		return vrndnq_f32(value);
+#else
+		alignas(16) float v[4];
+		Store(v, value);
+		return Set(std::nearbyint(v[0]), std::nearbyint(v[1]), std::nearbyint(v[2]), std::nearbyint(v[3]));
+#endif
+	}
+
+	// 2^n for integral n in [-126, 127], built straight in the exponent bits
+	inline Float4 Pow2(Float4 n)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23));
+#elif defined(REALSIX_SIMD_NEON)
+		return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+#else
+		Float4 result;
+		for (uint8_t i = 0; i < 4; ++i)
+			result.lanes[i] = std::bit_cast<float>(static_cast<uint32_t>(static_cast<int32_t>(n.lanes[i]) + 127) << 23);
+		return result;
+#endif
+	}
+
+	// Splits positive normal floats into a mantissa in [1, 2), the return value, and the unbiased exponent
+	inline Float4 SplitExponent(Float4 value, Float4 &exponent)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		const __m128i bits = _mm_castps_si128(value);
+		exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+		return _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+#elif defined(REALSIX_SIMD_NEON)
+		const uint32x4_t bits = vreinterpretq_u32_f32(value);
+		exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+		return vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+#else
+		Float4 mantissa;
+		for (uint8_t i = 0; i < 4; ++i)
+		{
+			const uint32_t bits = std::bit_cast<uint32_t>(value.lanes[i]);
+			exponent.lanes[i] = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+			mantissa.lanes[i] = std::bit_cast<float>((bits & 0x007fffff) | 0x3f800000);
+		}
+		return mantissa;
+#endif
+	}
+
+	inline Mask4 Less(Float4 left, Float4 right)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_cmplt_ps(left, right);
+#elif defined(REALSIX_SIMD_NEON)
+		return vcltq_f32(left, right);
+#else
+		return Mask4{{left.lanes[0] < right.lanes[0], left.lanes[1] < right.lanes[1], left.lanes[2] < right.lanes[2], left.lanes[3] < right.lanes[3]}};
+#endif
+	}
+
+	inline Mask4 Greater(Float4 left, Float4 right)
+	{
+		return Less(right, left);
+	}
+
+	// Per lane mask ? ifTrue : ifFalse
+	inline Float4 Select(Mask4 mask, Float4 ifTrue, Float4 ifFalse)
+	{
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+#elif defined(REALSIX_SIMD_NEON)
+		return vbslq_f32(mask, ifTrue, ifFalse);
+#else
+		return Float4{{mask.lanes[0] ? ifTrue.lanes[0] : ifFalse.lanes[0], mask.lanes[1] ? ifTrue.lanes[1] : ifFalse.lanes[1], mask.lanes[2] ? ifTrue.lanes[2] : ifFalse.lanes[2], mask.lanes[3] ? ifTrue.lanes[3] : ifFalse.lanes[3]}};
+#endif
+	}
+
+	// Lanes X and Y of left followed by lanes Z and W of right, like _mm_shuffle_ps
+	template <uint32_t X, uint32_t Y, uint32_t Z, uint32_t W>
+	inline Float4 Shuffle(Float4 left, Float4 right)
+	{
+		static_assert(X < 4 && Y < 4 && Z < 4 && W < 4, "Lane index out of range");
+#if defined(REALSIX_SIMD_SSE)
+		return _mm_shuffle_ps(left, right, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(REALSIX_SIMD_NEON)
+		return vsetq_lane_f32(vgetq_lane_f32(right, W),
+							  vsetq_lane_f32(vgetq_lane_f32(right, Z),
+											 vsetq_lane_f32(vgetq_lane_f32(left, Y),
+															vmovq_n_f32(vgetq_lane_f32(left, X)), 1),
+											 2),
+							  3);
+#else
+		return Float4{{left.lanes[X], left.lanes[Y], right.lanes[Z], right.lanes[W]}};
+#endif
+	}
+
+	template <uint32_t X, uint32_t Y, uint32_t Z, uint32_t W>
+	inline Float4 Swizzle(Float4 value)
+	{
+		return Shuffle<X, Y, Z, W>(value, value);
+	}
+
+	template <uint32_t Lane>
+	inline Float4 SplatLane(Float4 value)
+	{
+#if defined(REALSIX_SIMD_NEON) && defined(__aarch64__)
+		return vdupq_laneq_f32(value, Lane);
+#else
+		return Swizzle<Lane, Lane, Lane, Lane>(value);
+#endif
+	}
+
+	// Sum of all four lanes in every lane
+	inline Float4 HorizontalAdd(Float4 value)
+	{
+		value = Add(value, Swizzle<1, 0, 3, 2>(value));
+		return Add(value, Swizzle<2, 3, 0, 1>(value));
+	}
+
+	// Treats c0..c3 as the rows (or columns) of a 4x4 matrix and transposes it in place
+	inline void Transpose(Float4 &c0, Float4 &c1, Float4 &c2, Float4 &c3)
+	{
+		Float4 t0 = Shuffle<0, 1, 0, 1>(c0, c1);
+		Float4 t1 = Shuffle<2, 3, 2, 3>(c0, c1);
+		Float4 t2 = Shuffle<0, 1, 0, 1>(c2, c3);
+		Float4 t3 = Shuffle<2, 3, 2, 3>(c2, c3);
+		c0 = Shuffle<0, 2, 0, 2>(t0, t2);
+		c1 = Shuffle<1, 3, 1, 3>(t0, t2);
+		c2 = Shuffle<0, 2, 0, 2>(t1, t3);
+		c3 = Shuffle<1, 3, 1, 3>(t1, t3);
+	}
+
+	// left.yzx * right.zxy - left.zxy * right.yzx, w stays 0 for directions
+	inline Float4 Cross3(Float4 left, Float4 right)
+	{
+		return Sub(Mul(Swizzle<1, 2, 0, 3>(left), Swizzle<2, 0, 1, 3>(right)),
+				   Mul(Swizzle<2, 0, 1, 3>(left), Swizzle<1, 2, 0, 3>(right)));
+	}
+}
@@ -149,7 +149,7 @@ namespace RealSix
 	template <typename T>
 	inline Vector3<T> TransformPoint(const DualQuaternion<T> &dq, const Vector3<T> &b)
 	{
-		Quaternion<T> d = Quaternion<T>::Conjuate(dq.real) * (dq.dual * 2.0f);
+		Quaternion<T> d = Quaternion<T>::Conjugate(dq.real) * (dq.dual * 2.0f);
 		Vector3<T> t = d.vec;
 		return dq.real * b + t;
 	}
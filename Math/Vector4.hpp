@@ -1,7 +1,9 @@
 #pragma once
 #include <array>
 #include <cassert>
+#include <type_traits>
 #include "Math.hpp"
+#include "Simd.hpp"
 
 namespace RealSix
 {
@@ -206,6 +208,18 @@ namespace RealSix
 	template <typename T, typename T2>
 	inline Vector4<T> operator*(const Matrix4<T> &matrix, const Vector4<T2> &vec)
 	{
+		if constexpr (std::is_same_v<T, float> && std::is_same_v<T2, float>)
+		{
+			Simd::Float4 result = Simd::Mul(matrix.col[0], Simd::Splat(vec.x));
+			result = Simd::MulAdd(matrix.col[1], Simd::Splat(vec.y), result);
+			result = Simd::MulAdd(matrix.col[2], Simd::Splat(vec.z), result);
+			result = Simd::MulAdd(matrix.col[3], Simd::Splat(vec.w), result);
+
+			Vector4<T> tmp;
+			Simd::Store(tmp.valuesRawArray, result);
+			return tmp;
+		}
+
 		T x = matrix.elements[0] * vec.x + matrix.elements[4] * vec.y + matrix.elements[8] * vec.z + matrix.elements[12] * vec.w;
 		T y = matrix.elements[1] * vec.x + matrix.elements[5] * vec.y + matrix.elements[9] * vec.z + matrix.elements[13] * vec.w;
 		T z = matrix.elements[2] * vec.x + matrix.elements[6] * vec.y + matrix.elements[10] * vec.z + matrix.elements[14] * vec.w;
@@ -0,0 +1,146 @@
+#include "CpuProbe.hpp"
+#include <cstring>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define REALSIX_CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+namespace RealSix
+{
+    namespace
+    {
+        struct CpuProbeResult
+        {
+            CpuFeatures features;
+            CpuManufacturer manufacturer{CpuManufacturer::UNKNOWN};
+            char brandName[49]{};
+        };
+
+#if defined(REALSIX_CPU_X86)
+        void CpuId(uint32_t leaf, uint32_t subLeaf, uint32_t registers[4])
+        {
+#if defined(_MSC_VER)
+            int32_t values[4];
+            __cpuidex(values, static_cast<int32_t>(leaf), static_cast<int32_t>(subLeaf));
+            for (uint8_t i = 0; i < 4; ++i)
+                registers[i] = static_cast<uint32_t>(values[i]);
+#else
+            __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+        }
+
+        // Register state the OS saves on context switches, only readable when cpuid reports OSXSAVE
+        uint64_t ReadXcr0()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+        }
+
+        bool HasBit(uint32_t value, uint32_t bit)
+        {
+            return (value & (1u << bit)) != 0;
+        }
+#endif
+
+        CpuProbeResult Probe()
+        {
+            CpuProbeResult result;
+#if defined(REALSIX_CPU_X86)
+            enum
+            {
+                EAX,
+                EBX,
+                ECX,
+                EDX
+            };
+
+            uint32_t registers[4];
+            CpuId(0, 0, registers);
+            const uint32_t maxLeaf = registers[EAX];
+
+            char vendor[13]{};
+            std::memcpy(vendor, &registers[EBX], 4);
+            std::memcpy(vendor + 4, &registers[EDX], 4);
+            std::memcpy(vendor + 8, &registers[ECX], 4);
+            if (std::strcmp(vendor, "GenuineIntel") == 0)
+                result.manufacturer = CpuManufacturer::INTEL;
+            else if (std::strcmp(vendor, "AuthenticAMD") == 0)
+                result.manufacturer = CpuManufacturer::AMD;
+
+            if (maxLeaf >= 1)
+            {
+                CpuId(1, 0, registers);
+                result.features.sse41 = HasBit(registers[ECX], 19);
+                result.features.sse42 = HasBit(registers[ECX], 20);
+
+                const bool osxsave = HasBit(registers[ECX], 27);
+                const uint64_t xcr0 = osxsave ? ReadXcr0() : 0;
+                const bool osAvx = (xcr0 & 0x6) == 0x6;      // xmm and ymm
+                const bool osAvx512 = (xcr0 & 0xe6) == 0xe6; // plus opmask and zmm
+                result.features.avx = osAvx && HasBit(registers[ECX], 28);
+                result.features.fma = osAvx && HasBit(registers[ECX], 12);
+
+                if (maxLeaf >= 7)
+                {
+                    CpuId(7, 0, registers);
+                    result.features.avx2 = osAvx && HasBit(registers[EBX], 5);
+                    result.features.avx512f = osAvx512 && HasBit(registers[EBX], 16);
+                    result.features.avx512dq = osAvx512 && HasBit(registers[EBX], 17);
+                    result.features.avx512bw = osAvx512 && HasBit(registers[EBX], 30);
+                    result.features.avx512vl = osAvx512 && HasBit(registers[EBX], 31);
+                }
+            }
+
+            CpuId(0x80000000, 0, registers);
+            if (registers[EAX] >= 0x80000004)
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    CpuId(0x80000002 + i, 0, registers);
+                    std::memcpy(result.brandName + i * 16, registers, 16);
+                }
+            }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+            result.features.neon = true;
+#if defined(__APPLE__)
+            result.manufacturer = CpuManufacturer::APPLE;
+#else
+            result.manufacturer = CpuManufacturer::ARM;
+#endif
+#endif
+            return result;
+        }
+
+        const CpuProbeResult &GetProbeResult()
+        {
+            static const CpuProbeResult result = Probe();
+            return result;
+        }
+    }
+
+    const CpuFeatures &CpuProbe::GetFeatures()
+    {
+        return GetProbeResult().features;
+    }
+
+    CpuManufacturer CpuProbe::GetManufacturer()
+    {
+        return GetProbeResult().manufacturer;
+    }
+
+    const char *CpuProbe::GetBrandName()
+    {
+        const char *name = GetProbeResult().brandName;
+        while (*name == ' ')
+            ++name;
+        return name;
+    }
+}
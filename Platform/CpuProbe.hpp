@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+namespace RealSix
+{
+    enum class CpuManufacturer
+    {
+        UNKNOWN,
+        INTEL,
+        AMD,
+        ARM,
+        APPLE,
+    };
+
+    // Instruction set extensions usable by the running process, the wide register ones are only reported
+    // when the OS also saves their state on context switches
+    struct CpuFeatures
+    {
+        bool sse41{false};
+        bool sse42{false};
+        bool avx{false};
+        bool avx2{false};
+        bool fma{false};
+        bool avx512f{false};
+        bool avx512dq{false};
+        bool avx512bw{false};
+        bool avx512vl{false};
+        bool neon{false};
+    };
+
+    // Queries the CPU once on first use, it does not need PlatformInfo to be initialized
+    // so Math can pick its kernels before the App starts
+    class CpuProbe
+    {
+    public:
+        static const CpuFeatures &GetFeatures();
+        static CpuManufacturer GetManufacturer();
+        // Processor brand string like "Intel(R) Core(TM) i7-9700K CPU @ 3.60GHz", empty when the CPU does not report one
+        static const char *GetBrandName();
+    };
+}
@@ -7,6 +7,7 @@ namespace RealSix
 #if defined(PLATFORM_WINDOWS) || defined(PLATFORM_LINUX)
         auto sdl3HardwareInfo = new SDL3HardwareInfo();
         sdl3HardwareInfo->ObtainDisplayInfo();
+        sdl3HardwareInfo->ObtainCpuInfo();
         return sdl3HardwareInfo;
 #else
 #error "Not Support Platform, only windows is available now!"
@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.h>
 #include "Core/Common.hpp"
 #include "Core/Marco.hpp"
+#include "CpuProbe.hpp"
 #include "Window.hpp"
 namespace RealSix
 {
@@ -17,21 +18,13 @@ namespace RealSix
         bool isHDR{false};
     };
 
-    enum class CpuManufacturer
-    {
-        UNKNOWN,
-        INTEL,
-        AMD,
-        ARM,
-        APPLE,
-    };
-
     struct CpuInfo
     {
         String name;
         CpuManufacturer manufacturer{CpuManufacturer::UNKNOWN};
         uint8_t logicCoreCount{0};
         uint8_t physicalCoreCount{0};
+        CpuFeatures features;
     };
 
     struct MemoryInfo
@@ -57,11 +50,23 @@ namespace RealSix
             return mDisplayInfos;
         }
 
+        const CpuInfo &GetCpuInfo() const
+        {
+            return mCpuInfo;
+        }
+
     protected:
         virtual void ObtainDisplayInfo() = 0;
 
+        // Name, manufacturer and instruction set extensions from CpuProbe, derived classes add the core counts
+        virtual void ObtainCpuInfo()
+        {
+            mCpuInfo.name = CpuProbe::GetBrandName();
+            mCpuInfo.manufacturer = CpuProbe::GetManufacturer();
+            mCpuInfo.features = CpuProbe::GetFeatures();
+        }
+
         //TODO: Implement these methods in derived classes
-        // virtual void ObtainCpuInfo() = 0;
         // virtual void ObtainMemoryInfo() = 0;
 
         std::vector<DisplayInfo> mDisplayInfos;
@@ -63,5 +63,11 @@ namespace RealSix
                 mDisplayInfos.push_back(info);
             }
         }
+
+        void ObtainCpuInfo() override
+        {
+            HardwareInfo::ObtainCpuInfo();
+            mCpuInfo.logicCoreCount = static_cast<uint8_t>(SDL_GetNumLogicalCPUCores());
+        }
     };
 }
\ No newline at end of file
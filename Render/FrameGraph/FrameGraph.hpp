@@ -7,6 +7,7 @@
 #include "FrameGraphRenderTask.hpp"
 #include "Core/Common.hpp"
 #include "Core/Logger.hpp"
+#include "Core/Memory.hpp"
 
 namespace RealSix
 {
@@ -149,8 +150,11 @@ namespace RealSix
                 resource.second->mRefCount = resource.second->mReaders.size();
             }
 
+            // The work lists live on the thread's scratch arena, only the timeline outlives Compile.
+            ScratchScope scratch;
+
             // Culling via flood fill from unreferenced resources.
-            std::stack<FrameGraphResourceBase *> unreferencedResources;
+            std::stack<FrameGraphResourceBase *, ScratchVector<FrameGraphResourceBase *>> unreferencedResources(scratch.GetAllocator<FrameGraphResourceBase *>());
 
             for (auto &resource : mResources)
             {
@@ -237,7 +241,7 @@ namespace RealSix
                     }
                 }
 
-                auto reads_writes = renderTask->mResourceReads;
+                ScratchVector<FrameGraphResourceBase *> reads_writes(renderTask->mResourceReads.begin(), renderTask->mResourceReads.end(), scratch.GetAllocator<FrameGraphResourceBase *>());
                 reads_writes.insert(reads_writes.end(), renderTask->mResourceWrites.begin(), renderTask->mResourceWrites.end());
                 for (auto resource : reads_writes)
                 {
@@ -275,7 +279,7 @@ namespace RealSix
                         derealizedResources.push_back(const_cast<FrameGraphResourceBase *>(resource));
                 }
 
-                mTimeline.emplace_back(Step{renderTask.get(), realizedResources, derealizedResources});
+                mTimeline.emplace_back(Step{renderTask.get(), std::move(realizedResources), std::move(derealizedResources)});
             }
         }
 
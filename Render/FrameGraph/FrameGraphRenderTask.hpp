@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include "Core/Common.hpp"
+#include "Core/SmallVector.hpp"
 
 namespace RealSix
 {
@@ -29,9 +30,9 @@ namespace RealSix
 
         String mName;
         bool mPersistent;
-        std::vector<FrameGraphResourceBase *> mResourceCreates;
-        std::vector<FrameGraphResourceBase *> mResourceReads;
-        std::vector<FrameGraphResourceBase *> mResourceWrites;
+        SmallVector<FrameGraphResourceBase *, 8> mResourceCreates;
+        SmallVector<FrameGraphResourceBase *, 8> mResourceReads;
+        SmallVector<FrameGraphResourceBase *, 8> mResourceWrites;
         size_t mRefCount;
     };
 
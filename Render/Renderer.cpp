@@ -1,5 +1,6 @@
 #include "Renderer.hpp"
 #include "Core/Config.hpp"
+#include "Core/Memory.hpp"
 
 namespace RealSix
 {
@@ -31,6 +32,8 @@ namespace RealSix
     void Renderer::BeginFrame()
     {
         mGfxDevice->BeginFrame();
+        // After the device waited for the frame in flight, so the GPU is done with what the older frame allocated
+        FrameAllocator::GetInstance().BeginFrame();
     }
 
     void Renderer::Render()
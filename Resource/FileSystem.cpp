@@ -8,6 +8,16 @@
 #define STB_IMAGE_IMPLEMENTATION
 #endif
 #include <stb_image.h>
+#if defined(PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 namespace RealSix::FileSystem
 {
     bool Exists(StringView path)
@@ -90,6 +100,117 @@ namespace RealSix::FileSystem
         return sstream.str();
     }
 
+    MappedFile::MappedFile(StringView path)
+    {
+        Open(path);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(StringView path)
+    {
+        Close();
+#if defined(PLATFORM_WINDOWS)
+        HANDLE file = CreateFileA(path.CString(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            REALSIX_LOG_WARN("Failed to open file:{}", path);
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            REALSIX_LOG_WARN("Failed to map empty file:{}", path);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            REALSIX_LOG_WARN("Failed to map file:{}", path);
+            return false;
+        }
+
+        mData = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!mData)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            REALSIX_LOG_WARN("Failed to map file:{}", path);
+            return false;
+        }
+
+        mFileHandle = file;
+        mMappingHandle = mapping;
+        mSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int32_t fd = open(path.CString(), O_RDONLY);
+        if (fd < 0)
+        {
+            REALSIX_LOG_WARN("Failed to open file:{}", path);
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            close(fd);
+            REALSIX_LOG_WARN("Failed to map empty file:{}", path);
+            return false;
+        }
+
+        void *data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED)
+        {
+            REALSIX_LOG_WARN("Failed to map file:{}", path);
+            return false;
+        }
+
+        mData = static_cast<const uint8_t *>(data);
+        mSize = static_cast<size_t>(fileStat.st_size);
+#endif
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!mData)
+            return;
+#if defined(PLATFORM_WINDOWS)
+        UnmapViewOfFile(mData);
+        CloseHandle(mMappingHandle);
+        CloseHandle(mFileHandle);
+        mMappingHandle = nullptr;
+        mFileHandle = nullptr;
+#else
+        munmap(const_cast<uint8_t *>(mData), mSize);
+#endif
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    bool MappedFile::IsValid() const
+    {
+        return mData != nullptr;
+    }
+
+    const uint8_t *MappedFile::GetData() const
+    {
+        return mData;
+    }
+
+    size_t MappedFile::GetSize() const
+    {
+        return mSize;
+    }
+
     GfxTextureDesc ReadTexture(StringView path)
     {
         stbi_uc *pixels = nullptr;
@@ -16,5 +16,32 @@ namespace RealSix::FileSystem
     void WriteBinaryFile(StringView path, StringView content);
     String ReadBinaryFile(StringView path);
 
+    // Read-only memory mapping of a whole file, the mapped bytes stay valid until the object is destroyed
+    class REALSIX_API MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(StringView path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool Open(StringView path);
+        void Close();
+
+        bool IsValid() const;
+        const uint8_t *GetData() const;
+        size_t GetSize() const;
+
+    private:
+        const uint8_t *mData{nullptr};
+        size_t mSize{0};
+#if defined(PLATFORM_WINDOWS)
+        void *mFileHandle{nullptr};
+        void *mMappingHandle{nullptr};
+#endif
+    };
+
     GfxTextureDesc ReadTexture(StringView path);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Allocator.hpp"
 #include "VM.hpp"
+#include "FiberScheduler.hpp"
 #include "Core/Logger.hpp"
 
 namespace RealSix::Script
@@ -18,7 +19,10 @@ namespace RealSix::Script
 
         mOpenUpValues = nullptr;
 
+        mCurrentFiber = nullptr;
+
         memset(mGlobalValueList, 0, sizeof(Value) * VARIABLE_MAX);
+        mGlobalValueCount = 0;
         memset(mStaticValueList, 0, sizeof(StaticValue) * VARIABLE_MAX);
     }
 
@@ -162,11 +166,15 @@ namespace RealSix::Script
 
     Value *Allocator::GetGlobalValueRef(size_t idx)
     {
+        if (idx >= mGlobalValueCount)
+            mGlobalValueCount = idx + 1;
         return &mGlobalValueList[idx];
     }
 
     void Allocator::SetGlobalValue(size_t idx, const Value &v)
     {
+        if (idx >= mGlobalValueCount)
+            mGlobalValueCount = idx + 1;
         mGlobalValueList[idx] = v;
     }
 
@@ -196,6 +204,7 @@ namespace RealSix::Script
         }
 #endif
 
+        ++mGCCycle;
         MarkRootObjects();
         MarkGrayObjects();
         Sweep();
@@ -218,8 +227,11 @@ namespace RealSix::Script
             slot->closure->Mark();
         for (UpValueObject *upvalue = mOpenUpValues; upvalue != nullptr; upvalue = upvalue->nextUpValue)
             upvalue->Mark();
+        if (mCurrentFiber)
+            mCurrentFiber->Mark();
+        FiberScheduler::GetInstance().MarkFibers();
 
-        for (int32_t i = 0; i < VARIABLE_MAX; ++i)
+        for (size_t i = 0; i < mGlobalValueCount; ++i)
             if (mGlobalValueList[i] != Value())
                 mGlobalValueList[i].Mark();
     }
@@ -11,11 +11,11 @@ namespace RealSix::Script
     struct CallFrame
     {
         CallFrame() = default;
-        CallFrame(ClosureObject *closure, Value *slots) : closure(closure), slots(slots), ip(closure->function->chunk.opCodes.data()), argumentsHash(0) {}
+        CallFrame(ClosureObject *closure, Value *slots) : closure(closure), slots(slots), ip(closure->function->chunk.GetOpCodes()), argumentsHash(0) {}
         ~CallFrame() = default;
 
         ClosureObject *closure = nullptr;
-        uint8_t *ip = nullptr;
+        const uint8_t *ip = nullptr;
         Value *slots = nullptr;
 
         // ++ Function cache relative
@@ -41,8 +41,16 @@ namespace RealSix::Script
         template <class T, typename... Args>
         T *CreateObject(Args &&...params)
         {
-            T *object = new T(std::forward<Args>(params)...);
-            size_t objBytes = sizeof(*object);
+            T *object;
+            size_t objBytes = sizeof(T);
+            if constexpr (std::is_same_v<T, ClosureObject>)
+            {
+                // The upvalue array is allocated inline behind the closure
+                object = new (params...) T(std::forward<Args>(params)...);
+                objBytes += object->GetUpValueCount() * sizeof(UpValueObject *);
+            }
+            else
+                object = new T(std::forward<Args>(params)...);
             mBytesAllocated += objBytes;
 #ifndef NDEBUG
             if (ScriptConfig::GetInstance().IsStressGC())
@@ -87,6 +95,8 @@ namespace RealSix::Script
         void SetGlobalValue(size_t idx, const Value &v);
 
         StaticValue *GetStaticValueRef(size_t idx);
+
+        uint64_t GetGCCycle() const { return mGCCycle; }
     private:
         friend class VM;
         friend class Compiler;
@@ -114,7 +124,8 @@ namespace RealSix::Script
         void Sweep();
 
         Value mGlobalValueList[VARIABLE_MAX];
-        StaticValue mStaticValueList[VARIABLE_MAX]; 
+        size_t mGlobalValueCount; // one past the highest global slot touched, bounds the root scan
+        StaticValue mStaticValueList[VARIABLE_MAX];
 
         Value *mStackTop;
         Value mValueStack[STACK_MAX];
@@ -124,12 +135,15 @@ namespace RealSix::Script
 
         UpValueObject *mOpenUpValues;
 
+        FiberObject *mCurrentFiber;
+
         friend struct Object;
 
         Object *mObjectChain;
         std::vector<Object *> mGrayObjects;
         size_t mBytesAllocated;
         size_t mNextGCByteSize;
+        uint64_t mGCCycle{0};
     };
 
 #define GET_GLOBAL_VALUE_REF(idx) (Allocator::GetInstance().GetGlobalValueRef(idx))
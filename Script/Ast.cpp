@@ -528,6 +528,45 @@ namespace RealSix::Script
 		return result + ")";
 	}
 #endif
+
+	YieldExpr::YieldExpr(Token *tagToken)
+		: Expr(tagToken, AstKind::YIELD), expr(nullptr)
+	{
+	}
+	YieldExpr::YieldExpr(Token *tagToken, Expr *expr)
+		: Expr(tagToken, AstKind::YIELD), expr(expr)
+	{
+	}
+	YieldExpr::~YieldExpr()
+	{
+		SAFE_DELETE(expr);
+	}
+#ifndef NDEBUG
+	String YieldExpr::ToString()
+	{
+		return expr ? "yield " + expr->ToString() : "yield";
+	}
+#endif
+
+	ResumeExpr::ResumeExpr(Token *tagToken)
+		: Expr(tagToken, AstKind::RESUME), fiber(nullptr), value(nullptr)
+	{
+	}
+	ResumeExpr::ResumeExpr(Token *tagToken, Expr *fiber, Expr *value)
+		: Expr(tagToken, AstKind::RESUME), fiber(fiber), value(value)
+	{
+	}
+	ResumeExpr::~ResumeExpr()
+	{
+		SAFE_DELETE(fiber);
+		SAFE_DELETE(value);
+	}
+#ifndef NDEBUG
+	String ResumeExpr::ToString()
+	{
+		return "resume(" + fiber->ToString() + (value ? "," + value->ToString() : "") + ")";
+	}
+#endif
 	//----------------------Statements-----------------------------
 
 	ExprStmt::ExprStmt(Token *tagToken)
@@ -8,6 +8,8 @@
 #include "Utils.hpp"
 namespace RealSix::Script
 {
+	struct ClassLayout;
+
 	enum class AstKind
 	{
 		// expr
@@ -34,6 +36,8 @@ namespace RealSix::Script
 		VAR_ARG,
 		FACTORIAL,
 		APPREGATE,
+		YIELD,
+		RESUME,
 		// stmt
 		VAR,
 		EXPR,
@@ -271,6 +275,9 @@ namespace RealSix::Script
 
 		Expr *callee;
 		IdentifierExpr *callMember;
+		// Slot of the member in the class layout of callee, resolved by TypeCheckAndResolvePass
+		ClassLayout *memberLayout{nullptr};
+		int32_t memberSlot{-1};
 	};
 
 	struct NewExpr : public Expr
@@ -363,6 +370,29 @@ namespace RealSix::Script
 		std::vector<Expr *> exprs;
 	};
 
+	struct YieldExpr : public Expr
+	{
+		YieldExpr(Token *tagToken);
+		YieldExpr(Token *tagToken, Expr *expr);
+		~YieldExpr() override;
+#ifndef NDEBUG
+		String ToString() override;
+#endif
+		Expr *expr; // nullptr for a bare 'yield'
+	};
+
+	struct ResumeExpr : public Expr
+	{
+		ResumeExpr(Token *tagToken);
+		ResumeExpr(Token *tagToken, Expr *fiber, Expr *value);
+		~ResumeExpr() override;
+#ifndef NDEBUG
+		String ToString() override;
+#endif
+		Expr *fiber;
+		Expr *value; // nullptr when no value is passed in
+	};
+
 	struct Stmt : public AstNode
 	{
 		Stmt(Token *tagToken, AstKind kind) : AstNode(tagToken, kind) {}
@@ -567,6 +597,8 @@ namespace RealSix::Script
 		std::vector<std::pair<MemberPrivilege, VarDecl *>> constants;
 		std::vector<std::pair<MemberPrivilege, FunctionMember>> functions;
 		std::vector<std::pair<MemberPrivilege, EnumDecl *>> enumerations;
+
+		std::shared_ptr<ClassLayout> layout; // set by TypeCheckAndResolvePass when every parent and member can be laid out
 	};
 
 	struct ModuleDecl : public Stmt
@@ -144,6 +144,10 @@ namespace RealSix::Script
                 return ExecuteFactorialExpr((FactorialExpr *)expr);
             case AstKind::APPREGATE:
                 return ExecuteAppregateExpr((AppregateExpr *)expr);
+            case AstKind::YIELD:
+                return ExecuteYieldExpr((YieldExpr *)expr);
+            case AstKind::RESUME:
+                return ExecuteResumeExpr((ResumeExpr *)expr);
             default:
                 return expr;
             }
@@ -171,6 +175,8 @@ namespace RealSix::Script
         virtual Expr *ExecuteBaseExpr(BaseExpr *expr) { return expr; }
         virtual Expr *ExecuteFactorialExpr(FactorialExpr *expr) { return expr; }
         virtual Expr *ExecuteVarDescExpr(VarDescExpr *expr) { return expr; }
+        virtual Expr *ExecuteYieldExpr(YieldExpr *expr) { return expr; }
+        virtual Expr *ExecuteResumeExpr(ResumeExpr *expr) { return expr; }
 
     protected:
         template <typename T>
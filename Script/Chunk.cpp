@@ -1,6 +1,9 @@
 #include "Chunk.hpp"
 #include <iomanip>
 #include <sstream>
+#include <unordered_set>
+#include <cstring>
+#include <bit>
 #include "Core/String.hpp"
 #include <format>
 #include "Version.hpp"
@@ -9,7 +12,86 @@
 #include "Logger.hpp"
 namespace RealSix::Script
 {
-	Chunk::Chunk(const OpCodeList &opcodes, const std::vector<Value> &constants)
+	uint32_t ConstantPool::Add(const Value &value)
+	{
+		auto iter = mIndices.find(value);
+		if (iter != mIndices.end())
+			return iter->second;
+
+		auto index = Append(value);
+		mIndices[value] = index;
+		return index;
+	}
+
+	uint32_t ConstantPool::Append(const Value &value)
+	{
+		mValues.emplace_back(value);
+		return static_cast<uint32_t>(mValues.size() - 1);
+	}
+
+	void ConstantPool::Reserve(size_t count)
+	{
+		mValues.reserve(count);
+		mIndices.reserve(count);
+	}
+
+	void ConstantPool::Mark(uint64_t gcCycle) const
+	{
+		if (mMarkedGCCycle == gcCycle)
+			return;
+		mMarkedGCCycle = gcCycle;
+		for (const auto &value : mValues)
+			value.Mark();
+	}
+
+	size_t ConstantPool::ConstantHash::operator()(const Value &value) const
+	{
+		size_t hash = std::hash<uint8_t>()(value.kind) ^ (std::hash<uint8_t>()(static_cast<uint8_t>(value.permission)) << 1);
+		switch (value.kind)
+		{
+		case ValueKind::INT:
+			return hash ^ std::hash<int64_t>()(value.integer);
+		case ValueKind::FLOAT:
+			return hash ^ std::hash<uint64_t>()(std::bit_cast<uint64_t>(value.floating));
+		case ValueKind::BOOL:
+			return hash ^ std::hash<bool>()(value.boolean);
+		case ValueKind::OBJECT:
+			if (IS_STR_VALUE(value))
+				return hash ^ TO_STR_VALUE(value)->GetValue().GetHash();
+			return hash ^ std::hash<Object *>()(value.object);
+		default:
+			return hash;
+		}
+	}
+
+	bool ConstantPool::ConstantEqual::operator()(const Value &left, const Value &right) const
+	{
+		if (left.kind != right.kind || left.permission != right.permission)
+			return false;
+
+		switch (left.kind)
+		{
+		case ValueKind::INT:
+			return left.integer == right.integer;
+		case ValueKind::FLOAT:
+			return std::bit_cast<uint64_t>(left.floating) == std::bit_cast<uint64_t>(right.floating);
+		case ValueKind::BOOL:
+			return left.boolean == right.boolean;
+		case ValueKind::OBJECT:
+			if (IS_STR_VALUE(left) && IS_STR_VALUE(right))
+				return TO_STR_VALUE(left)->GetValue().GetRawData() == TO_STR_VALUE(right)->GetValue().GetRawData();
+			return left.object == right.object;
+		default:
+			return true;
+		}
+	}
+
+	bool operator==(const ConstantPool &left, const ConstantPool &right)
+	{
+		return left.Size() == right.Size() && std::equal(left.begin(), left.end(), right.begin());
+	}
+
+	Chunk::Chunk(const OpCodeList &opcodes, const std::shared_ptr<ConstantPool> &constants)
 		: opCodes(opcodes), constants(constants)
 	{
 	}
@@ -17,80 +99,426 @@ namespace RealSix::Script
 #ifndef NDEBUG
 	String Chunk::ToString() const
 	{
-		String result = OpCodeToString(opCodes);
-		for (const auto &c : constants)
+		String result = OpCodeToString(GetOpCodes(), GetOpCodeCount());
+		if (!constants)
+			return result;
+
+		// The pool is shared by the whole program, so list its functions flat instead of recursing into each of them
+		for (const auto &c : *constants)
 		{
-			if (IS_FUNCTION_VALUE(c))
-				result += TO_FUNCTION_VALUE(c)->ToStringWithChunk();
+			if (IS_FUNCTION_VALUE(c) && &TO_FUNCTION_VALUE(c)->chunk != this)
+			{
+				const Chunk &chunk = TO_FUNCTION_VALUE(c)->chunk;
+				result += TO_FUNCTION_VALUE(c)->ToString() + "\n" + chunk.OpCodeToString(chunk.GetOpCodes(), chunk.GetOpCodeCount());
+			}
 		}
 		return result;
 	}
 #endif
 
-	std::vector<uint8_t> Chunk::Serialize() const
+	namespace
 	{
-		std::vector<uint8_t> result;
+		// Every record is 8 bytes aligned and every offset is relative to the image start,
+		// so the image can be used in place from a read-only mapping.
+		constexpr size_t IMAGE_ALIGNMENT = 8;
 
-		auto magNumberBytes = ByteConverter::ToU32ByteList(REALSIX_SCRIPT_BINARY_FILE_MAGIC_NUMBER);
-		result.insert(result.end(), magNumberBytes.begin(), magNumberBytes.end());
+		struct ImageHeader
+		{
+			uint32_t magicNumber;
+			uint32_t version;
+			uint32_t functionCount;
+			uint32_t constantCount;
+			uint32_t functionTableOffset;
+			uint32_t constantTableOffset;
+			uint32_t dataPoolOffset;
+			uint32_t imageSize;
+		};
+
+		struct ImageFunction
+		{
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t opCodeOffset;
+			uint32_t opCodeCount;
+			uint32_t constantBegin;
+			uint32_t constantCount;
+			uint32_t relatedTokenCount;
+			uint8_t arity;
+			uint8_t varArg;
+			uint8_t upValueCount;
+			uint8_t hasCapturedLocals;
+		};
+
+		struct ImageConstant
+		{
+			uint8_t kind;
+			uint8_t permission;
+			uint8_t objectKind;
+			uint8_t padding[5];
+			// int/float/bool bits, (offset << 32 | length) of a string, function index or offset of an enum record
+			uint64_t payload;
+		};
+
+		struct ImageEnum
+		{
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t pairCount;
+			uint32_t padding;
+		};
 
-		auto versionBytes = ByteConverter::ToU32ByteList(REALSIX_VERSION_BINARY);
-		result.insert(result.end(), versionBytes.begin(), versionBytes.end());
+		struct ImageEnumPair
+		{
+			uint32_t keyOffset;
+			uint32_t keyLength;
+			ImageConstant value;
+		};
 
-		auto opCodeCount = ByteConverter::ToU32ByteList(opCodes.size());
-		result.insert(result.end(), opCodeCount.begin(), opCodeCount.end());
+		size_t AlignUp(size_t value)
+		{
+			return (value + IMAGE_ALIGNMENT - 1) & ~(IMAGE_ALIGNMENT - 1);
+		}
 
-		result.insert(result.end(), opCodes.begin(), opCodes.end());
+		class ImageWriter
+		{
+		public:
+			std::vector<uint8_t> Write(const Chunk *root)
+			{
+				mChunks.emplace_back(root);
+				mOwners.emplace_back(nullptr);
+				std::unordered_set<const ConstantPool *> visitedPools;
+				for (size_t i = 0; i < mChunks.size(); ++i)
+				{
+					const ConstantPool *pool = mChunks[i]->constants.get();
+					if (!pool || !visitedPools.insert(pool).second)
+						continue;
 
-		auto constantsCount = ByteConverter::ToU32ByteList(constants.size());
-		result.insert(result.end(), constantsCount.begin(), constantsCount.end());
+					for (const auto &c : *pool)
+					{
+						if (IS_FUNCTION_VALUE(c) && !mFunctionIndices.contains(TO_FUNCTION_VALUE(c)))
+						{
+							mFunctionIndices[TO_FUNCTION_VALUE(c)] = static_cast<uint32_t>(mChunks.size());
+							mChunks.emplace_back(&TO_FUNCTION_VALUE(c)->chunk);
+							mOwners.emplace_back(TO_FUNCTION_VALUE(c));
+						}
+					}
+				}
 
-		for (const auto &constant : constants)
-		{
-			auto bytes = constant.Serialize();
+				std::vector<ImageFunction> functions(mChunks.size());
+				std::vector<uint8_t> opCodes;
+				for (size_t i = 0; i < mChunks.size(); ++i)
+				{
+					const Chunk *chunk = mChunks[i];
+					ImageFunction &function = functions[i];
+					memset(&function, 0, sizeof(ImageFunction));
 
-			auto size = ByteConverter::ToU32ByteList(bytes.size());
-			result.insert(result.end(), size.begin(), size.end());
+					if (mOwners[i])
+					{
+						function.nameOffset = AddString(mOwners[i]->name);
+						function.nameLength = static_cast<uint32_t>(mOwners[i]->name.Size());
+						function.arity = mOwners[i]->arity;
+						function.varArg = static_cast<uint8_t>(mOwners[i]->varArg);
+						function.upValueCount = mOwners[i]->upValueCount;
+						function.hasCapturedLocals = mOwners[i]->hasCapturedLocals;
+					}
 
-			result.insert(result.end(), bytes.begin(), bytes.end());
-		}
+					function.opCodeOffset = static_cast<uint32_t>(opCodes.size());
+					function.opCodeCount = static_cast<uint32_t>(chunk->GetOpCodeCount());
+					opCodes.insert(opCodes.end(), chunk->GetOpCodes(), chunk->GetOpCodes() + chunk->GetOpCodeCount());
 
-		return result;
+					if (chunk->constants)
+					{
+						auto iter = mPoolBegins.find(chunk->constants.get());
+						if (iter == mPoolBegins.end())
+						{
+							iter = mPoolBegins.emplace(chunk->constants.get(), static_cast<uint32_t>(mConstants.size())).first;
+							for (const auto &c : *chunk->constants)
+								mConstants.emplace_back(EncodeConstant(c));
+						}
+						function.constantBegin = iter->second;
+						function.constantCount = static_cast<uint32_t>(chunk->constants->Size());
+					}
+
+					// The related token index is a single byte, indices beyond it are never referenced
+					function.relatedTokenCount = static_cast<uint32_t>(std::min<size_t>(chunk->opCodeRelatedTokens.size(), UINT8_COUNT));
+				}
+
+				ImageHeader header;
+				header.magicNumber = REALSIX_SCRIPT_BINARY_FILE_MAGIC_NUMBER;
+				header.version = REALSIX_VERSION_BINARY;
+				header.functionCount = static_cast<uint32_t>(functions.size());
+				header.constantCount = static_cast<uint32_t>(mConstants.size());
+				header.functionTableOffset = static_cast<uint32_t>(AlignUp(sizeof(ImageHeader)));
+				header.constantTableOffset = static_cast<uint32_t>(AlignUp(header.functionTableOffset + functions.size() * sizeof(ImageFunction)));
+				size_t opCodeSectionOffset = AlignUp(header.constantTableOffset + mConstants.size() * sizeof(ImageConstant));
+				header.dataPoolOffset = static_cast<uint32_t>(AlignUp(opCodeSectionOffset + opCodes.size()));
+				header.imageSize = static_cast<uint32_t>(header.dataPoolOffset + mDataPool.size());
+
+				for (auto &function : functions)
+					function.opCodeOffset += static_cast<uint32_t>(opCodeSectionOffset);
+
+				std::vector<uint8_t> result(header.imageSize, 0);
+				memcpy(result.data(), &header, sizeof(ImageHeader));
+				memcpy(result.data() + header.functionTableOffset, functions.data(), functions.size() * sizeof(ImageFunction));
+				memcpy(result.data() + header.constantTableOffset, mConstants.data(), mConstants.size() * sizeof(ImageConstant));
+				memcpy(result.data() + opCodeSectionOffset, opCodes.data(), opCodes.size());
+				memcpy(result.data() + header.dataPoolOffset, mDataPool.data(), mDataPool.size());
+				return result;
+			}
+
+		private:
+			ImageConstant EncodeConstant(const Value &value)
+			{
+				ImageConstant result;
+				memset(&result, 0, sizeof(ImageConstant));
+				result.kind = value.kind;
+				result.permission = static_cast<uint8_t>(value.permission);
+
+				switch (value.kind)
+				{
+				case ValueKind::INT:
+					result.payload = static_cast<uint64_t>(TO_INT_VALUE(value));
+					break;
+				case ValueKind::FLOAT:
+					memcpy(&result.payload, &TO_FLOAT_VALUE(value), sizeof(double));
+					break;
+				case ValueKind::BOOL:
+					result.payload = TO_BOOL_VALUE(value) ? 1 : 0;
+					break;
+				case ValueKind::OBJECT:
+				{
+					result.objectKind = value.object->kind;
+					if (IS_STR_VALUE(value))
+					{
+						const String &str = TO_STR_VALUE(value)->GetValue();
+						result.payload = (static_cast<uint64_t>(AddString(str)) << 32) | static_cast<uint32_t>(str.Size());
+					}
+					else if (IS_FUNCTION_VALUE(value))
+						result.payload = mFunctionIndices[TO_FUNCTION_VALUE(value)];
+					else if (IS_ENUM_VALUE(value))
+						result.payload = AddEnum(TO_ENUM_VALUE(value));
+					else
+						REALSIX_LOG_ERROR("Cannot serialize constant:{}", value.ToString());
+					break;
+				}
+				default:
+					break;
+				}
+				return result;
+			}
+
+			uint32_t AddString(const String &str)
+			{
+				auto iter = mStringOffsets.find(str.GetRawData());
+				if (iter != mStringOffsets.end())
+					return iter->second;
+
+				auto offset = static_cast<uint32_t>(mDataPool.size());
+				mDataPool.insert(mDataPool.end(), str.CString(), str.CString() + str.Size());
+				mStringOffsets[str.GetRawData()] = offset;
+				return offset;
+			}
+
+			uint32_t AddEnum(const EnumObject *enumObject)
+			{
+				ImageEnum record;
+				memset(&record, 0, sizeof(ImageEnum));
+				record.nameOffset = AddString(enumObject->name);
+				record.nameLength = static_cast<uint32_t>(enumObject->name.Size());
+				record.pairCount = static_cast<uint32_t>(enumObject->pairs.size());
+
+				std::vector<ImageEnumPair> pairs;
+				for (const auto &[k, v] : enumObject->pairs)
+				{
+					ImageEnumPair pair;
+					pair.keyOffset = AddString(k);
+					pair.keyLength = static_cast<uint32_t>(k.Size());
+					pair.value = EncodeConstant(v);
+					pairs.emplace_back(pair);
+				}
+
+				mDataPool.resize(AlignUp(mDataPool.size()), 0);
+				auto offset = static_cast<uint32_t>(mDataPool.size());
+				mDataPool.resize(offset + sizeof(ImageEnum) + pairs.size() * sizeof(ImageEnumPair));
+				memcpy(mDataPool.data() + offset, &record, sizeof(ImageEnum));
+				memcpy(mDataPool.data() + offset + sizeof(ImageEnum), pairs.data(), pairs.size() * sizeof(ImageEnumPair));
+				return offset;
+			}
+
+			std::vector<const Chunk *> mChunks;
+			std::vector<const FunctionObject *> mOwners;
+			std::unordered_map<const FunctionObject *, uint32_t> mFunctionIndices;
+			std::unordered_map<const ConstantPool *, uint32_t> mPoolBegins;
+			std::vector<ImageConstant> mConstants;
+			std::vector<uint8_t> mDataPool;
+			std::unordered_map<std::string, uint32_t> mStringOffsets;
+		};
 	}
 
-	void Chunk::Deserialize(const std::vector<uint8_t> &data)
+	class ChunkImageReader
 	{
-		auto magicNumber = ByteConverter::GetU32Integer(data, 0);
-		if (magicNumber != REALSIX_SCRIPT_BINARY_FILE_MAGIC_NUMBER)
-			REALSIX_LOG_ERROR("Invalid RealSix binary file,cannot deserialize from this file");
+	public:
+		ChunkImageReader(const uint8_t *data, size_t size)
+			: mData(data), mSize(size)
+		{
+		}
 
-		auto versionNumber = ByteConverter::GetU32Integer(data, 4);
-		if (versionNumber != REALSIX_VERSION_BINARY)
-			REALSIX_LOG_ERROR("Invalid RealSix binary file version of {},current version is {}", versionNumber, REALSIX_VERSION_BINARY);
+		void Read(Chunk *root)
+		{
+			if (mSize < sizeof(ImageHeader) || reinterpret_cast<uintptr_t>(mData) % IMAGE_ALIGNMENT != 0)
+				REALSIX_LOG_ERROR("Invalid RealSix binary file,cannot deserialize from this file");
+
+			mHeader = reinterpret_cast<const ImageHeader *>(mData);
+			if (mHeader->magicNumber != REALSIX_SCRIPT_BINARY_FILE_MAGIC_NUMBER)
+				REALSIX_LOG_ERROR("Invalid RealSix binary file,cannot deserialize from this file");
+			if (mHeader->version != REALSIX_VERSION_BINARY)
+				REALSIX_LOG_ERROR("Invalid RealSix binary file version of {},current version is {}", mHeader->version, REALSIX_VERSION_BINARY);
+			if (mHeader->imageSize > mSize || mHeader->functionCount == 0 ||
+				!InRange(mHeader->functionTableOffset, mHeader->functionCount * sizeof(ImageFunction)) ||
+				!InRange(mHeader->constantTableOffset, mHeader->constantCount * sizeof(ImageConstant)) ||
+				!InRange(mHeader->dataPoolOffset, 0))
+				REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+
+			const auto *records = reinterpret_cast<const ImageFunction *>(mData + mHeader->functionTableOffset);
+			mConstants = reinterpret_cast<const ImageConstant *>(mData + mHeader->constantTableOffset);
+
+			// Create every function up front, constants may reference functions stored later in the table
+			mFunctions.resize(mHeader->functionCount, nullptr);
+			for (uint32_t i = 1; i < mHeader->functionCount; ++i)
+			{
+				mFunctions[i] = new FunctionObject(GetString(records[i].nameOffset, records[i].nameLength));
+				mFunctions[i]->arity = records[i].arity;
+				mFunctions[i]->varArg = static_cast<VarArg>(records[i].varArg);
+				mFunctions[i]->upValueCount = records[i].upValueCount;
+				mFunctions[i]->hasCapturedLocals = records[i].hasCapturedLocals != 0;
+			}
 
-		auto opCodesCount = ByteConverter::GetU32Integer(data, 8);
+			for (uint32_t i = 0; i < mHeader->functionCount; ++i)
+			{
+				const ImageFunction &record = records[i];
+				if (!InRange(record.opCodeOffset, record.opCodeCount) ||
+					static_cast<uint64_t>(record.constantBegin) + record.constantCount > mHeader->constantCount)
+					REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+
+				Chunk *chunk = (i == 0) ? root : &mFunctions[i]->chunk;
+				chunk->opCodes.clear();
+				chunk->mMappedOpCodes = mData + record.opCodeOffset;
+				chunk->mMappedOpCodeCount = record.opCodeCount;
+
+				// Functions referencing the same constant range share one pool again
+				auto &pool = mPools[(static_cast<uint64_t>(record.constantBegin) << 32) | record.constantCount];
+				if (!pool)
+				{
+					pool = std::make_shared<ConstantPool>();
+					pool->Reserve(record.constantCount);
+					for (uint32_t j = 0; j < record.constantCount; ++j)
+						pool->Append(DecodeConstant(mConstants[record.constantBegin + j])); // keep the image layout, literals may repeat
+				}
+				chunk->constants = pool;
 
-		opCodes.insert(opCodes.end(), data.begin() + 12, data.begin() + 12 + opCodesCount);
+				// Source tokens are not part of the image, runtime errors report an anonymous location
+				chunk->opCodeRelatedTokens.assign(record.relatedTokenCount, &gImageRelatedToken);
+			}
+		}
 
-		auto idx = 12 + opCodesCount;
+	private:
+		bool InRange(uint64_t offset, uint64_t length) const
+		{
+			return offset + length <= mHeader->imageSize;
+		}
 
-		auto constantsCount = ByteConverter::GetU32Integer(data, idx);
-		idx += 4;
-		for (int32_t i = 0; i < constantsCount; ++i)
+		StringView GetString(uint32_t offset, uint32_t length) const
 		{
-			auto constantSize = ByteConverter::GetU32Integer(data, idx);
-			idx += 4;
+			if (!InRange(static_cast<uint64_t>(mHeader->dataPoolOffset) + offset, length))
+				REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+			return std::string_view(reinterpret_cast<const char *>(mData + mHeader->dataPoolOffset + offset), length);
+		}
 
-			std::vector<uint8_t> constantBytes(data.begin() + idx, data.begin() + idx + constantSize);
+		Value DecodeConstant(const ImageConstant &constant) const
+		{
+			Value result;
+			switch (constant.kind)
+			{
+			case ValueKind::INT:
+				result = Value(static_cast<int64_t>(constant.payload));
+				break;
+			case ValueKind::FLOAT:
+			{
+				double floating;
+				memcpy(&floating, &constant.payload, sizeof(double));
+				result = Value(floating);
+				break;
+			}
+			case ValueKind::BOOL:
+				result = Value(constant.payload != 0);
+				break;
+			case ValueKind::OBJECT:
+			{
+				if (constant.objectKind == ObjectKind::STR)
+					result = new StrObject(GetString(static_cast<uint32_t>(constant.payload >> 32), static_cast<uint32_t>(constant.payload)));
+				else if (constant.objectKind == ObjectKind::FUNCTION && constant.payload > 0 && constant.payload < mFunctions.size())
+					result = mFunctions[constant.payload];
+				else if (constant.objectKind == ObjectKind::ENUM)
+					result = DecodeEnum(static_cast<uint32_t>(constant.payload));
+				else
+					REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+				break;
+			}
+			default:
+				break;
+			}
+			result.permission = static_cast<Permission>(constant.permission);
+			return result;
+		}
 
-			Value v;
-			v.Deserialize(constantBytes);
+		EnumObject *DecodeEnum(uint32_t offset) const
+		{
+			if (offset % IMAGE_ALIGNMENT != 0 || !InRange(static_cast<uint64_t>(mHeader->dataPoolOffset) + offset, sizeof(ImageEnum)))
+				REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+
+			const auto *record = reinterpret_cast<const ImageEnum *>(mData + mHeader->dataPoolOffset + offset);
+			if (!InRange(static_cast<uint64_t>(mHeader->dataPoolOffset) + offset + sizeof(ImageEnum), static_cast<uint64_t>(record->pairCount) * sizeof(ImageEnumPair)))
+				REALSIX_LOG_ERROR("Corrupted RealSix binary file,cannot deserialize from this file");
+
+			const auto *pairRecords = reinterpret_cast<const ImageEnumPair *>(record + 1);
+			std::unordered_map<String, Value> pairs;
+			for (uint32_t i = 0; i < record->pairCount; ++i)
+				pairs[GetString(pairRecords[i].keyOffset, pairRecords[i].keyLength)] = DecodeConstant(pairRecords[i].value);
 
-			constants.emplace_back(v);
+			return new EnumObject(GetString(record->nameOffset, record->nameLength), pairs);
 		}
+
+		inline static const Token gImageRelatedToken{TokenKind::END, "", SourceLocation{"interpreter", ""}};
+
+		const uint8_t *mData;
+		size_t mSize;
+		const ImageHeader *mHeader{nullptr};
+		const ImageConstant *mConstants{nullptr};
+		std::vector<FunctionObject *> mFunctions;
+		std::unordered_map<uint64_t, std::shared_ptr<ConstantPool>> mPools;
+	};
+
+	std::vector<uint8_t> Chunk::Serialize() const
+	{
+		return ImageWriter().Write(this);
+	}
+
+	void Chunk::Deserialize(const uint8_t *data, size_t size)
+	{
+		ChunkImageReader(data, size).Read(this);
+	}
+
+	const uint8_t *Chunk::GetOpCodes() const
+	{
+		return mMappedOpCodes ? mMappedOpCodes : opCodes.data();
+	}
+
+	size_t Chunk::GetOpCodeCount() const
+	{
+		return mMappedOpCodes ? mMappedOpCodeCount : opCodes.size();
 	}
 
-	String Chunk::OpCodeToString(const OpCodeList &opcodes) const
+	String Chunk::OpCodeToString(const uint8_t *opcodes, size_t count) const
 	{
 #define CASE(opCode)                                                         \
 	case opCode:                                                             \
@@ -116,9 +544,28 @@ namespace RealSix::Script
 		break;                                                                                                \
 	}
 
+#define CASE_JUMP_LONG(opCode, op)                                                                    \
+	case opCode:                                                                                      \
+	{                                                                                                 \
+		uint32_t addressOffset = opcodes[i + 1] << 24 | opcodes[i + 2] << 16 | opcodes[i + 3] << 8 | opcodes[i + 4]; \
+		i += 4;                                                                                       \
+		auto targetAddr = i op addressOffset + 3;                                                     \
+		stream << std::format("{}{:08}    {}    {}->{}\n", tokStr, instrLoc, #opCode, i, targetAddr); \
+		break;                                                                                        \
+	}
+
+#define CASE_2(opCode)                                                                  \
+	case opCode:                                                                        \
+	{                                                                                   \
+		uint16_t pos = opcodes[i + 1] << 8 | opcodes[i + 2];                            \
+		i += 2;                                                                         \
+		stream << std::format("{}{:08}    {}    {}\n", tokStr, instrLoc, #opCode, pos); \
+		break;                                                                          \
+	}
+
 		const uint32_t maxTokenShowSize = GetBiggestTokenLength() + 4; // 4 for a gap "    "
 		std::stringstream stream;
-		for (int32_t i = 0; i < opcodes.size(); ++i)
+		for (size_t i = 0; i < count; ++i)
 		{
 			auto instrLoc = i;
 			auto tokStr = opCodeRelatedTokens[opcodes[++i]]->ToString();
@@ -151,6 +598,8 @@ namespace RealSix::Script
 				CASE(OP_GET_BASE)
 				CASE(OP_SET_PROPERTY)
 				CASE(OP_GET_PROPERTY)
+				CASE(OP_YIELD)
+				CASE(OP_RESUME)
 				CASE_JUMP(OP_JUMP_IF_FALSE, +)
 				CASE_JUMP(OP_JUMP, +)
 				CASE_JUMP(OP_LOOP, -)
@@ -177,13 +626,44 @@ namespace RealSix::Script
 				CASE_1(OP_APPREGATE_RESOLVE)
 				CASE_1(OP_APPREGATE_RESOLVE_VAR_ARG)
 				CASE_1(OP_INIT_VAR_ARG)
+				CASE_2(OP_SET_GLOBAL_LONG)
+				CASE_2(OP_GET_GLOBAL_LONG)
+				CASE_2(OP_REF_GLOBAL_LONG)
+				CASE_2(OP_REF_INDEX_GLOBAL_LONG)
+				CASE_2(OP_SET_LOCAL_LONG)
+				CASE_2(OP_GET_LOCAL_LONG)
+				CASE_2(OP_REF_LOCAL_LONG)
+				CASE_2(OP_REF_INDEX_LOCAL_LONG)
+				CASE_2(OP_DEF_STATIC_LONG)
+				CASE_2(OP_SET_STATIC_LONG)
+				CASE_2(OP_GET_STATIC_LONG)
+				CASE_JUMP_LONG(OP_JUMP_IF_FALSE_LONG, +)
+				CASE_JUMP_LONG(OP_JUMP_LONG, +)
+				CASE_JUMP_LONG(OP_LOOP_LONG, -)
 			case OP_CONSTANT:
 			{
 				auto pos = opcodes[++i];
-				String constantStr = constants[pos].ToString();
+				String constantStr = (*constants)[pos].ToString();
 				stream << std::format("{}{:08}    OP_CONSTANT    {}    '{}'\n", tokStr, instrLoc, pos, constantStr);
 				break;
 			}
+			case OP_CONSTANT_LONG:
+			{
+				uint32_t pos = opcodes[i + 1] << 16 | opcodes[i + 2] << 8 | opcodes[i + 3];
+				i += 3;
+				String constantStr = (*constants)[pos].ToString();
+				stream << std::format("{}{:08}    OP_CONSTANT_LONG    {}    '{}'\n", tokStr, instrLoc, pos, constantStr);
+				break;
+			}
+			case OP_GET_PROPERTY_SLOT:
+			{
+				uint32_t pos = opcodes[i + 1] << 16 | opcodes[i + 2] << 8 | opcodes[i + 3];
+				uint16_t slot = opcodes[i + 4] << 8 | opcodes[i + 5];
+				auto fallbackSize = opcodes[i + 6];
+				i += 6;
+				stream << std::format("{}{:08}    OP_GET_PROPERTY_SLOT    {}    {}    {}    '<fn {}>'\n", tokStr, instrLoc, pos, slot, fallbackSize, TO_FUNCTION_VALUE((*constants)[pos])->name);
+				break;
+			}
 			case OP_CLASS:
 			{
 				auto constructorCount = opcodes[++i];
@@ -198,11 +678,11 @@ namespace RealSix::Script
 			case OP_CLOSURE:
 			{
 				auto pos = opcodes[++i];
-				String funcStr = ("<fn " + TO_FUNCTION_VALUE(constants[pos])->name + ":0x" + PointerAddressToString((void *)TO_FUNCTION_VALUE(constants[pos])) + ">");
+				String funcStr = ("<fn " + TO_FUNCTION_VALUE((*constants)[pos])->name + ":0x" + PointerAddressToString((void *)TO_FUNCTION_VALUE((*constants)[pos])) + ">");
 
 				stream << std::format("{}{:08}    OP_CLOSURE    {}    {}\n", tokStr, i, pos, funcStr);
 
-				auto upvalueCount = TO_FUNCTION_VALUE(constants[pos])->upValueCount;
+				auto upvalueCount = TO_FUNCTION_VALUE((*constants)[pos])->upValueCount;
 				if (upvalueCount > 0)
 				{
 					stream << "        upvalues:" << std::endl;
@@ -210,7 +690,30 @@ namespace RealSix::Script
 					{
 						stream << "                 location  " << opcodes[++i];
 						stream << " | ";
-						stream << "depth  " << opcodes[++i] << std::endl;
+						stream << "kind  " << GetUpValueKindName(opcodes[++i]) << std::endl;
+					}
+				}
+				break;
+			}
+			case OP_CLOSURE_LONG:
+			{
+				uint32_t pos = opcodes[i + 1] << 16 | opcodes[i + 2] << 8 | opcodes[i + 3];
+				i += 3;
+				String funcStr = ("<fn " + TO_FUNCTION_VALUE((*constants)[pos])->name + ":0x" + PointerAddressToString((void *)TO_FUNCTION_VALUE((*constants)[pos])) + ">");
+
+				stream << std::format("{}{:08}    OP_CLOSURE_LONG    {}    {}\n", tokStr, i, pos, funcStr);
+
+				auto upvalueCount = TO_FUNCTION_VALUE((*constants)[pos])->upValueCount;
+				if (upvalueCount > 0)
+				{
+					stream << "        upvalues:" << std::endl;
+					for (auto j = 0; j < upvalueCount; ++j)
+					{
+						uint16_t location = opcodes[i + 1] << 8 | opcodes[i + 2];
+						i += 2;
+						stream << "                 location  " << location;
+						stream << " | ";
+						stream << "kind  " << GetUpValueKindName(opcodes[++i]) << std::endl;
 					}
 				}
 				break;
@@ -232,6 +735,219 @@ namespace RealSix::Script
 		return stream.str();
 	}
 
+	OpCode GetWideOpCode(OpCode opCode)
+	{
+		switch (opCode)
+		{
+		case OP_CONSTANT:
+			return OP_CONSTANT_LONG;
+		case OP_SET_GLOBAL:
+			return OP_SET_GLOBAL_LONG;
+		case OP_GET_GLOBAL:
+			return OP_GET_GLOBAL_LONG;
+		case OP_REF_GLOBAL:
+			return OP_REF_GLOBAL_LONG;
+		case OP_REF_INDEX_GLOBAL:
+			return OP_REF_INDEX_GLOBAL_LONG;
+		case OP_SET_LOCAL:
+			return OP_SET_LOCAL_LONG;
+		case OP_GET_LOCAL:
+			return OP_GET_LOCAL_LONG;
+		case OP_REF_LOCAL:
+			return OP_REF_LOCAL_LONG;
+		case OP_REF_INDEX_LOCAL:
+			return OP_REF_INDEX_LOCAL_LONG;
+		case OP_DEF_STATIC:
+			return OP_DEF_STATIC_LONG;
+		case OP_SET_STATIC:
+			return OP_SET_STATIC_LONG;
+		case OP_GET_STATIC:
+			return OP_GET_STATIC_LONG;
+		case OP_JUMP_IF_FALSE:
+			return OP_JUMP_IF_FALSE_LONG;
+		case OP_JUMP:
+			return OP_JUMP_LONG;
+		case OP_LOOP:
+			return OP_LOOP_LONG;
+		case OP_CLOSURE:
+			return OP_CLOSURE_LONG;
+		default:
+			return opCode;
+		}
+	}
+
+	const char *GetOpCodeName(OpCode opCode)
+	{
+		switch (opCode)
+		{
+		case OP_CONSTANT:
+			return "OP_CONSTANT";
+		case OP_NULL:
+			return "OP_NULL";
+		case OP_ADD:
+			return "OP_ADD";
+		case OP_SUB:
+			return "OP_SUB";
+		case OP_MUL:
+			return "OP_MUL";
+		case OP_DIV:
+			return "OP_DIV";
+		case OP_MOD:
+			return "OP_MOD";
+		case OP_EQUAL:
+			return "OP_EQUAL";
+		case OP_GREATER:
+			return "OP_GREATER";
+		case OP_LESS:
+			return "OP_LESS";
+		case OP_NOT:
+			return "OP_NOT";
+		case OP_MINUS:
+			return "OP_MINUS";
+		case OP_BIT_AND:
+			return "OP_BIT_AND";
+		case OP_BIT_OR:
+			return "OP_BIT_OR";
+		case OP_BIT_XOR:
+			return "OP_BIT_XOR";
+		case OP_BIT_NOT:
+			return "OP_BIT_NOT";
+		case OP_BIT_LEFT_SHIFT:
+			return "OP_BIT_LEFT_SHIFT";
+		case OP_BIT_RIGHT_SHIFT:
+			return "OP_BIT_RIGHT_SHIFT";
+		case OP_RETURN:
+			return "OP_RETURN";
+		case OP_FACTORIAL:
+			return "OP_FACTORIAL";
+		case OP_ARRAY:
+			return "OP_ARRAY";
+		case OP_DICT:
+			return "OP_DICT";
+		case OP_GET_INDEX:
+			return "OP_GET_INDEX";
+		case OP_SET_INDEX:
+			return "OP_SET_INDEX";
+		case OP_JUMP_IF_FALSE:
+			return "OP_JUMP_IF_FALSE";
+		case OP_JUMP:
+			return "OP_JUMP";
+		case OP_LOOP:
+			return "OP_LOOP";
+		case OP_POP:
+			return "OP_POP";
+		case OP_SET_GLOBAL:
+			return "OP_SET_GLOBAL";
+		case OP_GET_GLOBAL:
+			return "OP_GET_GLOBAL";
+		case OP_SET_LOCAL:
+			return "OP_SET_LOCAL";
+		case OP_GET_LOCAL:
+			return "OP_GET_LOCAL";
+		case OP_DEF_STATIC:
+			return "OP_DEF_STATIC";
+		case OP_SET_STATIC:
+			return "OP_SET_STATIC";
+		case OP_GET_STATIC:
+			return "OP_GET_STATIC";
+		case OP_GET_UPVALUE:
+			return "OP_GET_UPVALUE";
+		case OP_SET_UPVALUE:
+			return "OP_SET_UPVALUE";
+		case OP_CLOSE_UPVALUE:
+			return "OP_CLOSE_UPVALUE";
+		case OP_REF_GLOBAL:
+			return "OP_REF_GLOBAL";
+		case OP_REF_LOCAL:
+			return "OP_REF_LOCAL";
+		case OP_REF_INDEX_GLOBAL:
+			return "OP_REF_INDEX_GLOBAL";
+		case OP_REF_INDEX_LOCAL:
+			return "OP_REF_INDEX_LOCAL";
+		case OP_REF_UPVALUE:
+			return "OP_REF_UPVALUE";
+		case OP_REF_INDEX_UPVALUE:
+			return "OP_REF_INDEX_UPVALUE";
+		case OP_CALL:
+			return "OP_CALL";
+		case OP_CLASS:
+			return "OP_CLASS";
+		case OP_STRUCT:
+			return "OP_STRUCT";
+		case OP_SET_PROPERTY:
+			return "OP_SET_PROPERTY";
+		case OP_GET_PROPERTY:
+			return "OP_GET_PROPERTY";
+		case OP_GET_PROPERTY_SLOT:
+			return "OP_GET_PROPERTY_SLOT";
+		case OP_GET_BASE:
+			return "OP_GET_BASE";
+		case OP_CLOSURE:
+			return "OP_CLOSURE";
+		case OP_APPREGATE_RESOLVE:
+			return "OP_APPREGATE_RESOLVE";
+		case OP_APPREGATE_RESOLVE_VAR_ARG:
+			return "OP_APPREGATE_RESOLVE_VAR_ARG";
+		case OP_MODULE:
+			return "OP_MODULE";
+		case OP_INIT_VAR_ARG:
+			return "OP_INIT_VAR_ARG";
+		case OP_YIELD:
+			return "OP_YIELD";
+		case OP_RESUME:
+			return "OP_RESUME";
+		case OP_CONSTANT_LONG:
+			return "OP_CONSTANT_LONG";
+		case OP_SET_GLOBAL_LONG:
+			return "OP_SET_GLOBAL_LONG";
+		case OP_GET_GLOBAL_LONG:
+			return "OP_GET_GLOBAL_LONG";
+		case OP_REF_GLOBAL_LONG:
+			return "OP_REF_GLOBAL_LONG";
+		case OP_REF_INDEX_GLOBAL_LONG:
+			return "OP_REF_INDEX_GLOBAL_LONG";
+		case OP_SET_LOCAL_LONG:
+			return "OP_SET_LOCAL_LONG";
+		case OP_GET_LOCAL_LONG:
+			return "OP_GET_LOCAL_LONG";
+		case OP_REF_LOCAL_LONG:
+			return "OP_REF_LOCAL_LONG";
+		case OP_REF_INDEX_LOCAL_LONG:
+			return "OP_REF_INDEX_LOCAL_LONG";
+		case OP_DEF_STATIC_LONG:
+			return "OP_DEF_STATIC_LONG";
+		case OP_SET_STATIC_LONG:
+			return "OP_SET_STATIC_LONG";
+		case OP_GET_STATIC_LONG:
+			return "OP_GET_STATIC_LONG";
+		case OP_JUMP_IF_FALSE_LONG:
+			return "OP_JUMP_IF_FALSE_LONG";
+		case OP_JUMP_LONG:
+			return "OP_JUMP_LONG";
+		case OP_LOOP_LONG:
+			return "OP_LOOP_LONG";
+		case OP_CLOSURE_LONG:
+			return "OP_CLOSURE_LONG";
+		default:
+			return "OP_UNKNOWN";
+		}
+	}
+
+	const char *GetUpValueKindName(uint8_t kind)
+	{
+		switch (kind)
+		{
+		case UPVALUE_ENCLOSING:
+			return "ENCLOSING";
+		case UPVALUE_LOCAL:
+			return "LOCAL";
+		case UPVALUE_LOCAL_VALUE:
+			return "LOCAL_VALUE";
+		default:
+			return "UNKNOWN";
+		}
+	}
+
 	uint32_t Chunk::GetBiggestTokenLength() const
 	{
 		uint32_t length = 0;
@@ -246,14 +962,13 @@ namespace RealSix::Script
 
 	bool operator==(const Chunk &left, const Chunk &right)
 	{
-		if (left.opCodes != right.opCodes)
+		if (!std::equal(left.GetOpCodes(), left.GetOpCodes() + left.GetOpCodeCount(), right.GetOpCodes(), right.GetOpCodes() + right.GetOpCodeCount()))
 			return false;
 
-		if (!((left.constants.size() == right.constants.size()) &&
-			  (std::equal(left.constants.begin(), left.constants.end(), right.constants.begin()))))
+		if (left.constants != right.constants && (!left.constants || !right.constants || !(*left.constants == *right.constants)))
 			return false;
 
-		if (!((left.opCodeRelatedTokens.size() == right.constants.size()) &&
+		if (!((left.opCodeRelatedTokens.size() == right.opCodeRelatedTokens.size()) &&
 			  (std::equal(left.opCodeRelatedTokens.begin(), left.opCodeRelatedTokens.end(), right.opCodeRelatedTokens.begin()))))
 			return false;
 
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include "Value.hpp"
 #include "Token.hpp"
 namespace RealSix::Script
@@ -61,29 +63,118 @@ namespace RealSix::Script
         OP_APPREGATE_RESOLVE_VAR_ARG,
         OP_MODULE,
         OP_INIT_VAR_ARG,
+        OP_YIELD,
+        OP_RESUME,
+        OP_GET_PROPERTY_SLOT, // 24 bit constant of the class body function, 16 bit slot of its layout, 8 bit size of the
+                              // member name constant and OP_GET_PROPERTY following it, which run when the layout differs
+
+        // Wide operand variants, used by the compiler only when the narrow operand does not fit
+        OP_CONSTANT_LONG,      // 24 bit constant index
+        OP_SET_GLOBAL_LONG,    // 16 bit global index
+        OP_GET_GLOBAL_LONG,
+        OP_REF_GLOBAL_LONG,
+        OP_REF_INDEX_GLOBAL_LONG,
+        OP_SET_LOCAL_LONG,     // 16 bit slot index
+        OP_GET_LOCAL_LONG,
+        OP_REF_LOCAL_LONG,
+        OP_REF_INDEX_LOCAL_LONG,
+        OP_DEF_STATIC_LONG,    // 16 bit static index
+        OP_SET_STATIC_LONG,
+        OP_GET_STATIC_LONG,
+        OP_JUMP_IF_FALSE_LONG, // 32 bit offset
+        OP_JUMP_LONG,
+        OP_LOOP_LONG,
+        OP_CLOSURE_LONG,       // 24 bit constant index, 16 bit upvalue locations
     };
 
+    // Second operand of every upvalue of OP_CLOSURE, where the upvalue of the created closure comes from
+    enum UpValueKind : uint8_t
+    {
+        UPVALUE_ENCLOSING,   // the upvalue of the enclosing closure at the location
+        UPVALUE_LOCAL,       // the local slot of the enclosing frame, shared until the slot is closed
+        UPVALUE_LOCAL_VALUE, // a copy of the immutable local slot, closed from the start
+    };
+
+    OpCode GetWideOpCode(OpCode opCode);
+    const char *GetOpCodeName(OpCode opCode);
+    const char *GetUpValueKindName(uint8_t kind);
+
     using OpCodeList = std::vector<uint8_t>;
 
+    // Constant table shared by every chunk of a compiled program, equal constants added through Add are stored only once
+    class REALSIX_API ConstantPool
+    {
+    public:
+        ConstantPool() = default;
+        ~ConstantPool() = default;
+
+        // Return the index of the constant equal to value, appending value only if there is none yet
+        uint32_t Add(const Value &value);
+        // Always append, for constants that must not alias another use site
+        uint32_t Append(const Value &value);
+        void Reserve(size_t count);
+
+        // Every function of a program holds the same pool, only the first one reached in a gc cycle walks it
+        void Mark(uint64_t gcCycle) const;
+
+        size_t Size() const { return mValues.size(); }
+        Value &operator[](size_t index) { return mValues[index]; }
+        const Value &operator[](size_t index) const { return mValues[index]; }
+
+        std::vector<Value>::const_iterator begin() const { return mValues.begin(); }
+        std::vector<Value>::const_iterator end() const { return mValues.end(); }
+
+    private:
+        // Strings compare by content, numbers by kind and bits, other objects by identity
+        struct ConstantHash
+        {
+            size_t operator()(const Value &value) const;
+        };
+        struct ConstantEqual
+        {
+            bool operator()(const Value &left, const Value &right) const;
+        };
+
+        std::vector<Value> mValues;
+        std::unordered_map<Value, uint32_t, ConstantHash, ConstantEqual> mIndices;
+        mutable uint64_t mMarkedGCCycle{0};
+    };
+
+    bool operator==(const ConstantPool &left, const ConstantPool &right);
+
     class REALSIX_API Chunk
     {
     public:
         Chunk() = default;
-        Chunk(const OpCodeList &opcodes, const std::vector<Value> &constants);
+        Chunk(const OpCodeList &opcodes, const std::shared_ptr<ConstantPool> &constants);
         ~Chunk() = default;
 #ifndef NDEBUG
+        // Dump this chunk followed by every function in its constant pool
         String ToString() const;
 #endif
+        // Serialize this chunk and every function reachable from its constants into a position independent image,
+        // functions sharing a constant pool share one constant range of the image
         std::vector<uint8_t> Serialize() const;
-        void Deserialize(const std::vector<uint8_t> &data);
+        // Load an image produced by Serialize. Opcodes are executed in place from the image memory,
+        // so the image (e.g. a FileSystem::MappedFile) must outlive this chunk and every function loaded from it.
+        // There is no overload taking a vector on purpose, a temporary buffer would be gone before the first run
+        void Deserialize(const uint8_t *data, size_t size);
+
+        const uint8_t *GetOpCodes() const;
+        size_t GetOpCodeCount() const;
 
         OpCodeList opCodes;
-        std::vector<Value> constants;
+        std::shared_ptr<ConstantPool> constants;
         std::vector<const Token *> opCodeRelatedTokens;
 
     private:
-        String OpCodeToString(const OpCodeList &opcodes) const;
+        friend class ChunkImageReader;
+
+        String OpCodeToString(const uint8_t *opcodes, size_t count) const;
         uint32_t GetBiggestTokenLength() const;
+
+        const uint8_t *mMappedOpCodes{nullptr};
+        size_t mMappedOpCodeCount{0};
     };
 
     bool operator==(const Chunk &left, const Chunk &right);
@@ -18,8 +18,8 @@ namespace RealSix::Script
 	struct UpValue
 	{
 		uint8_t index = 0;
-		uint8_t location = 0;
-		uint8_t depth = -1;
+		uint16_t location = 0; // local slot or upvalue index of the enclosing function, depending on kind
+		UpValueKind kind = UPVALUE_ENCLOSING;
 	};
 
 	struct FunctionSymbolInfo
@@ -41,11 +41,12 @@ namespace RealSix::Script
 		String name;
 		SymbolLocation location = SymbolLocation::GLOBAL;
 		Permission permission = Permission::IMMUTABLE;
-		uint8_t index = 0;
+		uint16_t index = 0;
 		int8_t scopeDepth = -1;
 		FunctionSymbolInfo functionSymInfo;
 		UpValue upvalue; // available only while type is SymbolLocation::UPVALUE
-		bool isCaptured = false;
+		bool isCaptured = false;        // captured by reference, the slot has to be closed when it goes away
+		bool isValueCapturable = false; // immutable and initialized before any closure can capture it, closures copy it
 		const Token *relatedToken;
 	};
 
@@ -60,7 +61,6 @@ namespace RealSix::Script
 			: mName(name), mParent(parent), mIsClassOrModuleScope(isClassOrModuleScope)
 		{
 			mScopeDepth = parent->mScopeDepth + 1;
-			mTableDepth = parent->mTableDepth + 1;
 		}
 		~SymbolTable()
 		{
@@ -69,9 +69,11 @@ namespace RealSix::Script
 
 		Symbol Define(const Token *relatedToken, Permission permission, const String &name, const FunctionSymbolInfo &functionInfo = {}, bool isStatic = false)
 		{
-			if (mSymbolCount >= mSymbols.size())
+			if (mSymbolCount >= VARIABLE_MAX || (isStatic && mStaticSymbolCount >= VARIABLE_MAX))
 				REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Too many symbols in current scope.");
-			for (int16_t i = mSymbolCount - 1; i >= 0; --i)
+			if (mScopeDepth > 0 && !isStatic && mSymbolCount >= STACK_MAX) // locals live on the value stack, which is smaller than the slot range
+				REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Too many local variables in function.");
+			for (int32_t i = static_cast<int32_t>(mSymbolCount) - 1; i >= 0; --i)
 			{
 				auto isSameParamCount = (mSymbols[i].functionSymInfo.paramCount < 0 || functionInfo.paramCount < 0) ? true : mSymbols[i].functionSymInfo.paramCount == functionInfo.paramCount;
 				if (mSymbols[i].scopeDepth == -1 || mSymbols[i].scopeDepth < mScopeDepth)
@@ -80,6 +82,9 @@ namespace RealSix::Script
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Redefinition symbol:{}", name);
 			}
 
+			if (mSymbolCount == mSymbols.size())
+				mSymbols.emplace_back();
+
 			auto *symbol = &mSymbols[mSymbolCount++];
 			symbol->name = name;
 			symbol->permission = permission;
@@ -87,6 +92,8 @@ namespace RealSix::Script
 			symbol->functionSymInfo = functionInfo;
 			symbol->scopeDepth = mScopeDepth;
 			symbol->relatedToken = relatedToken;
+			symbol->isCaptured = false;
+			symbol->isValueCapturable = false;
 
 			if (mScopeDepth == 0)
 				symbol->location = isStatic ? SymbolLocation::GLOBAL_STATIC : SymbolLocation::GLOBAL;
@@ -97,7 +104,7 @@ namespace RealSix::Script
 
 		Symbol Resolve(const Token *relatedToken, const String &name, int8_t paramCount = -1, int8_t d = 0)
 		{
-			for (int16_t i = mSymbolCount - 1; i >= 0; --i)
+			for (int32_t i = static_cast<int32_t>(mSymbolCount) - 1; i >= 0; --i)
 			{
 				auto isSameParamCount = (mSymbols[i].functionSymInfo.paramCount < 0 || paramCount < 0) ? true : mSymbols[i].functionSymInfo.paramCount == paramCount;
 
@@ -108,7 +115,7 @@ namespace RealSix::Script
 						if (mSymbols[i].scopeDepth == -1)
 							REALSIX_SCRIPT_LOG_ERROR(relatedToken, "symbol not defined yet!");
 
-						if (d == 1)
+						if (d > 0 && !mSymbols[i].isValueCapturable)
 							mSymbols[i].isCaptured = true;
 
 						return mSymbols[i];
@@ -118,12 +125,14 @@ namespace RealSix::Script
 
 			if (mParent)
 			{
-				Symbol result = mParent->Resolve(relatedToken, name, paramCount, ++d);
-				if (d > 0 && result.location != SymbolLocation::GLOBAL)
+				Symbol result = mParent->Resolve(relatedToken, name, paramCount, d + 1);
+				if (result.location == SymbolLocation::LOCAL)
 				{
 					result.location = SymbolLocation::UPVALUE;
-					result.upvalue = AddUpValue(relatedToken, result.index, mParent->mTableDepth);
+					result.upvalue = AddUpValue(relatedToken, result.index, result.isValueCapturable ? UPVALUE_LOCAL_VALUE : UPVALUE_LOCAL);
 				}
+				else if (result.location == SymbolLocation::UPVALUE) // a local of a function further out, goes through the upvalue of the parent
+					result.upvalue = AddUpValue(relatedToken, result.upvalue.index, UPVALUE_ENCLOSING);
 				return result;
 			}
 
@@ -131,9 +140,17 @@ namespace RealSix::Script
 			return Symbol(); // Return an empty symbol, this should never be reached
 		}
 
-		StringView mName;
-		std::array<Symbol, UINT8_COUNT> mSymbols;
-		uint8_t mSymbolCount{0};
+		bool HasCapturedSymbols() const
+		{
+			for (uint32_t i = 0; i < mSymbolCount; ++i)
+				if (mSymbols[i].isCaptured)
+					return true;
+			return false;
+		}
+
+		String mName;
+		std::vector<Symbol> mSymbols;
+		uint32_t mSymbolCount{0};
 		std::array<UpValue, UINT8_COUNT> mUpValues;
 		int32_t mUpValueCount{0};
 		uint8_t mScopeDepth{0}; // Depth of scope nesting(related to code {} scope)
@@ -141,26 +158,25 @@ namespace RealSix::Script
 		bool mIsClassOrModuleScope{false};
 
 	private:
-		UpValue AddUpValue(const Token *relatedToken, uint8_t location, uint8_t depth)
+		UpValue AddUpValue(const Token *relatedToken, uint16_t location, UpValueKind kind)
 		{
 			for (int32_t i = 0; i < mUpValueCount; ++i)
 			{
 				UpValue *upvalue = &mUpValues[i];
-				if (upvalue->location == location && upvalue->depth == depth)
+				if (upvalue->location == location && upvalue->kind == kind)
 					return *upvalue;
 			}
 
-			if (mUpValueCount == UINT8_COUNT)
+			if (mUpValueCount == UINT8_MAX)
 				REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Too many closure upvalues in function.");
 			mUpValues[mUpValueCount].location = location;
-			mUpValues[mUpValueCount].depth = depth;
+			mUpValues[mUpValueCount].kind = kind;
 			mUpValues[mUpValueCount].index = mUpValueCount;
 			mUpValueCount++;
 			return mUpValues[mUpValueCount - 1];
 		}
-		uint8_t mTableDepth; // Depth of symbol table nesting(related to symboltable's parent)
 
-		static inline uint8_t mStaticSymbolCount{0};
+		static inline uint32_t mStaticSymbolCount{0};
 	};
 
 	Compiler::Compiler()
@@ -188,6 +204,10 @@ namespace RealSix::Script
 
 		EmitReturn(0, stmt->tagToken);
 
+		CurFunction()->hasCapturedLocals = mSymbolTable->HasCapturedSymbols();
+
+		RelaxJumps();
+
 		return CurFunction();
 	}
 
@@ -198,7 +218,8 @@ namespace RealSix::Script
 		mCurContinueStmtAddress = -1;
 		mCurBreakStmtAddress = -1;
 
-		mFunctionList.emplace_back(new FunctionObject(MAIN_ENTRY_FUNCTION_NAME));
+		mConstantPool = std::make_shared<ConstantPool>();
+		PushFunction(new FunctionObject(MAIN_ENTRY_FUNCTION_NAME));
 
 		EnterNewSymbolTable(MAIN_ENTRY_FUNCTION_NAME);
 
@@ -286,7 +307,7 @@ namespace RealSix::Script
 	{
 		auto symbol = mSymbolTable->Define(decl->tagToken, Permission::IMMUTABLE, decl->name->literal);
 
-		mFunctionList.emplace_back(new FunctionObject(symbol.name));
+		PushFunction(new FunctionObject(symbol.name));
 
 		EnterNewSymbolTable(symbol.name, true);
 
@@ -368,11 +389,12 @@ namespace RealSix::Script
 		auto function = CurFunction();
 		function->arity = mSymbolTable->mSymbolCount;
 
+		RelaxJumps();
 		mFunctionList.pop_back();
 
-		EmitClosure(function, decl->tagToken);
+		EmitClosure(function, decl->tagToken, mSymbolTable);
 
-		for (int32_t i = 0; i < mSymbolTable->mSymbolCount; ++i)
+		for (uint32_t i = 0; i < mSymbolTable->mSymbolCount; ++i)
 			EmitOpCode(OP_NULL, decl->tagToken);
 
 		EmitOpCode(OP_CALL, decl->tagToken);
@@ -606,6 +628,12 @@ namespace RealSix::Script
 		case AstKind::STRUCT:
 			CompileStructExpr((StructExpr *)expr);
 			break;
+		case AstKind::YIELD:
+			CompileYieldExpr((YieldExpr *)expr);
+			break;
+		case AstKind::RESUME:
+			CompileResumeExpr((ResumeExpr *)expr);
+			break;
 		default:
 			break;
 		}
@@ -795,7 +823,7 @@ namespace RealSix::Script
 			EmitConstant(expr->boolean, expr->tagToken);
 			break;
 		case TypeKind::STR:
-			EmitConstant(new StrObject(expr->str), expr->tagToken);
+			EmitConstant(new StrObject(expr->str), expr->tagToken, false); // scripts can write into a string, each literal keeps its own object
 			break;
 		case TypeKind::CHAR:
 			break; // TODO:...
@@ -897,7 +925,7 @@ namespace RealSix::Script
 
 	void Compiler::CompileDictExpr(DictExpr *expr)
 	{
-		for (auto i = 0; i < expr->elements.size(); ++i)
+		for (size_t i = 0; i < expr->elements.size(); ++i)
 		{
 			CompileExpr(expr->elements[i].first);
 			CompileExpr(expr->elements[i].second);
@@ -980,27 +1008,31 @@ namespace RealSix::Script
 		{
 			if (symbol.permission == Permission::MUTABLE)
 			{
-				EmitOpCode(setOp, expr->tagToken);
 				if (symbol.location == SymbolLocation::UPVALUE)
+				{
+					EmitOpCode(setOp, expr->tagToken);
 					Emit(symbol.upvalue.index);
+				}
 				else
-					Emit(symbol.index);
+					EmitIndexedOpCode(setOp, symbol.index, expr->tagToken);
 			}
 			else
 				REALSIX_SCRIPT_LOG_ERROR(expr->tagToken, "{} is a constant,which cannot be assigned!", expr->ToString());
 		}
 		else
 		{
-			EmitOpCode(getOp, expr->tagToken);
 			if (symbol.location == SymbolLocation::UPVALUE)
+			{
+				EmitOpCode(getOp, expr->tagToken);
 				Emit(symbol.upvalue.index);
+			}
 			else
-				Emit(symbol.index);
+				EmitIndexedOpCode(getOp, symbol.index, expr->tagToken);
 		}
 	}
 	void Compiler::CompileLambdaExpr(LambdaExpr *expr)
 	{
-		mFunctionList.emplace_back(new FunctionObject());
+		PushFunction(new FunctionObject());
 
 		EnterNewSymbolTable("");
 
@@ -1031,12 +1063,15 @@ namespace RealSix::Script
 		if (CurChunk().opCodes[CurChunk().opCodes.size() - 2] != OP_RETURN)
 			EmitReturn(0, expr->body->stmts.back()->tagToken);
 
+		auto symbolTable = mSymbolTable;
+
 		PopupSymbolTable();
 
 		auto function = CurFunction();
+		RelaxJumps();
 		mFunctionList.pop_back();
 
-		EmitClosure(function, expr->tagToken);
+		EmitClosure(function, expr->tagToken, symbolTable);
 	}
 
 	void Compiler::CompileCompoundExpr(CompoundExpr *expr)
@@ -1071,13 +1106,11 @@ namespace RealSix::Script
 					isSatisfied = true;
 					if (state == RWState::WRITE)
 					{
-						EmitOpCode(OP_SET_STATIC, expr->callMember->tagToken);
-						Emit(symbol.index);
+						EmitIndexedOpCode(OP_SET_STATIC, symbol.index, expr->callMember->tagToken);
 					}
 					else
 					{
-						EmitOpCode(OP_GET_STATIC, expr->callMember->tagToken);
-						Emit(symbol.index);
+						EmitIndexedOpCode(OP_GET_STATIC, symbol.index, expr->callMember->tagToken);
 					}
 				}
 			}
@@ -1086,12 +1119,28 @@ namespace RealSix::Script
 		if (!isSatisfied)
 		{
 			CompileExpr(expr->callee);
+
+			// The slot read skips the member name and OP_GET_PROPERTY after it when the receiver has the resolved layout
+			uint64_t fallbackSizeAddress = 0;
+			auto classBodyIter = mClassBodies.find(expr->memberLayout);
+			bool isSlotRead = state == RWState::READ && classBodyIter != mClassBodies.end() && expr->memberSlot >= 0 && expr->memberSlot <= UINT16_MAX;
+			if (isSlotRead)
+			{
+				EmitOpCode(OP_GET_PROPERTY_SLOT, expr->callMember->tagToken);
+				EmitU24(AddConstant(classBodyIter->second, expr->callMember->tagToken));
+				EmitU16(static_cast<uint16_t>(expr->memberSlot));
+				fallbackSizeAddress = Emit(0);
+			}
+
 			EmitConstant(new StrObject(expr->callMember->literal), expr->callee->tagToken);
 
 			if (state == RWState::WRITE)
 				EmitOpCode(OP_SET_PROPERTY, expr->callMember->tagToken);
 			else
 				EmitOpCode(OP_GET_PROPERTY, expr->callMember->tagToken);
+
+			if (isSlotRead)
+				CurOpCodeList()[fallbackSizeAddress] = static_cast<uint8_t>(CurOpCodeList().size() - fallbackSizeAddress - 1);
 		}
 	}
 	void Compiler::CompileRefExpr(RefExpr *expr)
@@ -1104,13 +1153,11 @@ namespace RealSix::Script
 			symbol = mSymbolTable->Resolve(refIdxExpr->ds->tagToken, refIdxExpr->ds->ToString());
 			if (symbol.location == SymbolLocation::GLOBAL)
 			{
-				EmitOpCode(OP_REF_INDEX_GLOBAL, symbol.relatedToken);
-				Emit(symbol.index);
+				EmitIndexedOpCode(OP_REF_INDEX_GLOBAL, symbol.index, symbol.relatedToken);
 			}
 			else if (symbol.location == SymbolLocation::LOCAL)
 			{
-				EmitOpCode(OP_REF_INDEX_LOCAL, symbol.relatedToken);
-				Emit(symbol.index);
+				EmitIndexedOpCode(OP_REF_INDEX_LOCAL, symbol.index, symbol.relatedToken);
 			}
 			else if (symbol.location == SymbolLocation::UPVALUE)
 			{
@@ -1123,13 +1170,11 @@ namespace RealSix::Script
 			symbol = mSymbolTable->Resolve(expr->refExpr->tagToken, expr->refExpr->ToString());
 			if (symbol.location == SymbolLocation::GLOBAL)
 			{
-				EmitOpCode(OP_REF_GLOBAL, symbol.relatedToken);
-				Emit(symbol.index);
+				EmitIndexedOpCode(OP_REF_GLOBAL, symbol.index, symbol.relatedToken);
 			}
 			else if (symbol.location == SymbolLocation::LOCAL)
 			{
-				EmitOpCode(OP_REF_LOCAL, symbol.relatedToken);
-				Emit(symbol.index);
+				EmitIndexedOpCode(OP_REF_LOCAL, symbol.index, symbol.relatedToken);
 			}
 			else if (symbol.location == SymbolLocation::UPVALUE)
 			{
@@ -1163,13 +1208,32 @@ namespace RealSix::Script
 		EmitOpCode(OP_FACTORIAL, expr->tagToken);
 	}
 
+	void Compiler::CompileYieldExpr(YieldExpr *expr)
+	{
+		if (expr->expr)
+			CompileExpr(expr->expr);
+		else
+			EmitOpCode(OP_NULL, expr->tagToken);
+		EmitOpCode(OP_YIELD, expr->tagToken);
+	}
+
+	void Compiler::CompileResumeExpr(ResumeExpr *expr)
+	{
+		CompileExpr(expr->fiber);
+		if (expr->value)
+			CompileExpr(expr->value);
+		else
+			EmitOpCode(OP_NULL, expr->tagToken);
+		EmitOpCode(OP_RESUME, expr->tagToken);
+	}
+
 	Symbol Compiler::CompileFunction(FunctionDecl *decl, ClassDecl::FunctionKind kind)
 	{
 		auto varArg = GetVarArgFromParameterList(decl->parameters);
 
 		auto functionSymbol = mSymbolTable->Define(decl->tagToken, Permission::IMMUTABLE, decl->name->literal, FunctionSymbolInfo{(int8_t)decl->parameters.size(), varArg});
 
-		mFunctionList.emplace_back(new FunctionObject(functionSymbol.name));
+		PushFunction(new FunctionObject(functionSymbol.name));
 
 		EnterNewSymbolTable(functionSymbol.name);
 
@@ -1205,22 +1269,15 @@ namespace RealSix::Script
 			EmitReturn(1, decl->tagToken);
 		}
 
-		CurFunction()->upValueCount = mSymbolTable->mUpValueCount;
-
-		auto upvalues = mSymbolTable->mUpValues;
+		auto symbolTable = mSymbolTable;
 
 		PopupSymbolTable();
 
 		auto function = CurFunction();
+		RelaxJumps();
 		mFunctionList.pop_back();
 
-		EmitClosure(function, decl->tagToken);
-
-		for (int32_t i = 0; i < function->upValueCount; ++i)
-		{
-			Emit(upvalues[i].location);
-			Emit(upvalues[i].depth);
-		}
+		EmitClosure(function, decl->tagToken, symbolTable);
 
 		return functionSymbol;
 	}
@@ -1256,7 +1313,7 @@ namespace RealSix::Script
 					if (mSymbolTable->mParent == nullptr && mSymbolTable->mScopeDepth > 0) // local scope
 						std::reverse(arrayExpr->elements.begin(), arrayExpr->elements.end());
 
-					for (int32_t i = 0; i < arrayExpr->elements.size(); ++i)
+					for (size_t i = 0; i < arrayExpr->elements.size(); ++i)
 					{
 						Symbol symbol;
 						String literal;
@@ -1286,8 +1343,7 @@ namespace RealSix::Script
 
 						if (symbol.location == SymbolLocation::GLOBAL)
 						{
-							EmitOpCode(OP_SET_GLOBAL, symbol.relatedToken);
-							Emit(symbol.index);
+							EmitIndexedOpCode(OP_SET_GLOBAL, symbol.index, symbol.relatedToken);
 							EmitOpCode(OP_POP, symbol.relatedToken);
 						}
 						else if (mSymbolTable->mIsClassOrModuleScope)
@@ -1326,19 +1382,20 @@ namespace RealSix::Script
 					}
 
 					auto symbol = mSymbolTable->Define(token, decl->permission, literal, {}, isStatic);
+					// The initializer is compiled above, closures can copy the value instead of sharing the slot
+					if (symbol.location == SymbolLocation::LOCAL && symbol.permission == Permission::IMMUTABLE)
+						mSymbolTable->mSymbols[symbol.index].isValueCapturable = true;
 
 					if (symbol.IsStatic())
 					{
-						EmitOpCode(OP_DEF_STATIC, symbol.relatedToken);
-						Emit(symbol.index);
+						EmitIndexedOpCode(OP_DEF_STATIC, symbol.index, symbol.relatedToken);
 						EmitOpCode(OP_POP, symbol.relatedToken);
 					}
 					else
 					{
 						if (symbol.location == SymbolLocation::GLOBAL)
 						{
-							EmitOpCode(OP_SET_GLOBAL, symbol.relatedToken);
-							Emit(symbol.index);
+							EmitIndexedOpCode(OP_SET_GLOBAL, symbol.index, symbol.relatedToken);
 							EmitOpCode(OP_POP, symbol.relatedToken);
 						}
 						else if (mSymbolTable->mIsClassOrModuleScope)
@@ -1366,7 +1423,12 @@ namespace RealSix::Script
 	{
 		auto symbol = mSymbolTable->Define(decl->tagToken, Permission::IMMUTABLE, decl->name);
 
-		mFunctionList.emplace_back(new FunctionObject(symbol.name));
+		PushFunction(new FunctionObject(symbol.name));
+		if (decl->layout)
+		{
+			CurFunction()->classLayout = decl->layout;
+			mClassBodies[decl->layout.get()] = CurFunction();
+		}
 
 		EnterNewSymbolTable(symbol.name, true);
 
@@ -1436,12 +1498,15 @@ namespace RealSix::Script
 
 		EmitReturn(1, decl->tagToken);
 
+		auto symbolTable = mSymbolTable;
+
 		PopupSymbolTable();
 
 		auto function = CurFunction();
+		RelaxJumps();
 		mFunctionList.pop_back();
 
-		EmitClosure(function, decl->tagToken);
+		EmitClosure(function, decl->tagToken, symbolTable);
 
 		return symbol;
 	}
@@ -1463,19 +1528,59 @@ namespace RealSix::Script
 		return CurOpCodeList().size() - 1;
 	}
 
-	uint64_t Compiler::EmitConstant(const Value &value, const Token *token)
+	uint64_t Compiler::EmitConstant(const Value &value, const Token *token, bool isShared)
 	{
-		EmitOpCode(OP_CONSTANT, token);
-		uint8_t pos = AddConstant(value);
-		Emit(pos);
+		uint32_t pos = AddConstant(value, token, isShared);
+
+		// String constants are created per literal, drop the new object when the pool already holds an equal one
+		if (IS_STR_VALUE(value) && (*mConstantPool)[pos].object != value.object)
+			delete TO_STR_VALUE(value);
+
+		if (pos <= UINT8_MAX)
+		{
+			EmitOpCode(OP_CONSTANT, token);
+			Emit(pos);
+		}
+		else
+		{
+			EmitOpCode(OP_CONSTANT_LONG, token);
+			EmitU24(pos);
+		}
 		return CurOpCodeList().size() - 1;
 	}
 
-	uint64_t Compiler::EmitClosure(FunctionObject *function, const Token *token)
+	uint64_t Compiler::EmitClosure(FunctionObject *function, const Token *token, const SymbolTable *symbolTable)
 	{
-		uint8_t pos = AddConstant(function);
-		EmitOpCode(OP_CLOSURE, token);
-		Emit(pos);
+		function->upValueCount = static_cast<uint8_t>(symbolTable->mUpValueCount);
+		function->hasCapturedLocals = symbolTable->HasCapturedSymbols();
+		const UpValue *upvalues = symbolTable->mUpValues.data();
+
+		uint32_t pos = AddConstant(function, token);
+
+		bool isWide = pos > UINT8_MAX;
+		for (int32_t i = 0; i < function->upValueCount; ++i)
+			isWide |= upvalues[i].location > UINT8_MAX;
+
+		if (!isWide)
+		{
+			EmitOpCode(OP_CLOSURE, token);
+			Emit(pos);
+			for (int32_t i = 0; i < function->upValueCount; ++i)
+			{
+				Emit(static_cast<uint8_t>(upvalues[i].location));
+				Emit(upvalues[i].kind);
+			}
+		}
+		else
+		{
+			EmitOpCode(OP_CLOSURE_LONG, token);
+			EmitU24(pos);
+			for (int32_t i = 0; i < function->upValueCount; ++i)
+			{
+				EmitU16(upvalues[i].location);
+				Emit(upvalues[i].kind);
+			}
+		}
 		return CurOpCodeList().size() - 1;
 	}
 
@@ -1486,18 +1591,45 @@ namespace RealSix::Script
 		return CurOpCodeList().size() - 1;
 	}
 
+	uint64_t Compiler::EmitIndexedOpCode(OpCode opCode, uint16_t index, const Token *token)
+	{
+		if (index <= UINT8_MAX)
+		{
+			EmitOpCode(opCode, token);
+			return Emit(static_cast<uint8_t>(index));
+		}
+
+		EmitOpCode(GetWideOpCode(opCode), token);
+		return EmitU16(index);
+	}
+
+	uint64_t Compiler::EmitU16(uint16_t operand)
+	{
+		Emit((operand >> 8) & 0xFF);
+		return Emit(operand & 0xFF);
+	}
+
+	uint64_t Compiler::EmitU24(uint32_t operand)
+	{
+		Emit((operand >> 16) & 0xFF);
+		Emit((operand >> 8) & 0xFF);
+		return Emit(operand & 0xFF);
+	}
+
+	// Jumps are emitted in the narrow form with a 16 bit offset, their targets are recorded
+	// and RelaxJumps() widens the ones that do not fit once the function is finished.
 	uint64_t Compiler::EmitJump(OpCode opcode, const Token *token)
 	{
-		EmitOpCode(opcode, token);
+		mJumpSites[CurFunction()].emplace_back(JumpSite{EmitOpCode(opcode, token) - 1, UINT64_MAX});
 		Emit(0xFF);
 		Emit(0xFF);
 		return CurOpCodeList().size() - 2;
 	}
 
-	void Compiler::EmitLoop(uint16_t opcode, const Token *token)
+	void Compiler::EmitLoop(uint64_t loopAddress, const Token *token)
 	{
-		EmitOpCode(OP_LOOP, token);
-		uint16_t offset = static_cast<uint16_t>(CurOpCodeList().size()) - opcode + 2;
+		mJumpSites[CurFunction()].emplace_back(JumpSite{EmitOpCode(OP_LOOP, token) - 1, loopAddress});
+		uint16_t offset = static_cast<uint16_t>(CurOpCodeList().size() + 2 - loopAddress);
 
 		Emit((offset >> 8) & 0xFF);
 		Emit(offset & 0xFF);
@@ -1505,29 +1637,120 @@ namespace RealSix::Script
 
 	void Compiler::PatchJump(uint64_t offset)
 	{
+		auto &sites = mJumpSites[CurFunction()];
+		for (auto iter = sites.rbegin(); iter != sites.rend(); ++iter)
+		{
+			if (iter->address + 2 == offset)
+			{
+				iter->target = CurOpCodeList().size();
+				break;
+			}
+		}
+
 		uint16_t jumpOffset = static_cast<uint16_t>(CurOpCodeList().size() - offset - 2);
 		CurOpCodeList()[offset] = (jumpOffset >> 8) & 0xFF;
 		CurOpCodeList()[offset + 1] = (jumpOffset)&0xFF;
 	}
 
-	uint8_t Compiler::AddConstant(const Value &value)
+	void Compiler::RelaxJumps()
 	{
-		CurChunk().constants.emplace_back(value);
-		return static_cast<uint8_t>(CurChunk().constants.size()) - 1;
+		auto siteIter = mJumpSites.find(CurFunction());
+		if (siteIter == mJumpSites.end())
+			return;
+
+		auto sites = std::move(siteIter->second);
+		mJumpSites.erase(siteIter);
+
+		// Every widened jump grows by 2 bytes, which moves everything after it
+		std::vector<bool> isWide(sites.size(), false);
+		std::vector<uint64_t> shifts(sites.size() + 1, 0);
+		auto relocate = [&](uint64_t address)
+		{
+			auto count = std::lower_bound(sites.begin(), sites.end(), address, [](const JumpSite &site, uint64_t a)
+										  { return site.address < a; }) -
+						 sites.begin();
+			return address + shifts[count];
+		};
+		auto distance = [&](size_t i)
+		{
+			int64_t from = static_cast<int64_t>(relocate(sites[i].address)) + (isWide[i] ? 6 : 4);
+			return std::abs(static_cast<int64_t>(relocate(sites[i].target)) - from);
+		};
+
+		bool changed = true;
+		bool anyWide = false;
+		while (changed)
+		{
+			changed = false;
+			for (size_t i = 0; i < sites.size(); ++i)
+				shifts[i + 1] = shifts[i] + (isWide[i] ? 2 : 0);
+
+			for (size_t i = 0; i < sites.size(); ++i)
+			{
+				if (!isWide[i] && sites[i].target != UINT64_MAX && distance(i) > UINT16_MAX)
+				{
+					isWide[i] = true;
+					changed = anyWide = true;
+				}
+			}
+		}
+
+		if (!anyWide)
+			return;
+
+		const OpCodeList oldOpCodes = std::move(CurOpCodeList());
+		OpCodeList &opCodes = CurOpCodeList();
+		opCodes.clear();
+		opCodes.reserve(oldOpCodes.size() + shifts.back());
+
+		uint64_t cursor = 0;
+		for (size_t i = 0; i < sites.size(); ++i)
+		{
+			opCodes.insert(opCodes.end(), oldOpCodes.begin() + cursor, oldOpCodes.begin() + sites[i].address);
+
+			auto opCode = static_cast<OpCode>(oldOpCodes[sites[i].address]);
+			opCodes.emplace_back(isWide[i] ? GetWideOpCode(opCode) : opCode);
+			opCodes.emplace_back(oldOpCodes[sites[i].address + 1]); // related token index
+
+			if (sites[i].target == UINT64_MAX) // never patched, keep the placeholder operand
+			{
+				opCodes.insert(opCodes.end(), oldOpCodes.begin() + sites[i].address + 2, oldOpCodes.begin() + sites[i].address + 4);
+				cursor = sites[i].address + 4;
+				continue;
+			}
+
+			auto offset = static_cast<uint32_t>(distance(i));
+			if (isWide[i])
+			{
+				opCodes.emplace_back((offset >> 24) & 0xFF);
+				opCodes.emplace_back((offset >> 16) & 0xFF);
+			}
+			opCodes.emplace_back((offset >> 8) & 0xFF);
+			opCodes.emplace_back(offset & 0xFF);
+
+			cursor = sites[i].address + 4;
+		}
+		opCodes.insert(opCodes.end(), oldOpCodes.begin() + cursor, oldOpCodes.end());
+	}
+
+	uint32_t Compiler::AddConstant(const Value &value, const Token *token, bool isShared)
+	{
+		auto pos = isShared ? mConstantPool->Add(value) : mConstantPool->Append(value);
+		if (pos > 0xFFFFFF)
+			REALSIX_SCRIPT_LOG_ERROR(token, "Too many constants in program.");
+		return pos;
 	}
 
 	void Compiler::EmitSymbol(const Symbol &symbol)
 	{
 		if (symbol.location == SymbolLocation::GLOBAL)
 		{
-			EmitOpCode(OP_SET_GLOBAL, symbol.relatedToken);
-			Emit(symbol.index);
+			EmitIndexedOpCode(OP_SET_GLOBAL, symbol.index, symbol.relatedToken);
 			EmitOpCode(OP_POP, symbol.relatedToken);
 		}
 		else if (symbol.location == SymbolLocation::LOCAL)
 		{
-			EmitOpCode(OP_SET_LOCAL, symbol.relatedToken);
-			Emit(symbol.index);
+			EmitIndexedOpCode(OP_SET_LOCAL, symbol.index, symbol.relatedToken);
 		}
 	}
 
@@ -1539,7 +1762,7 @@ namespace RealSix::Script
 	{
 		mSymbolTable->mScopeDepth--;
 
-		for (int32_t i = 0; i < mSymbolTable->mSymbols.size(); ++i)
+		for (size_t i = 0; i < mSymbolTable->mSymbols.size(); ++i)
 		{
 			Symbol *symbol = &mSymbolTable->mSymbols[i];
 			if (symbol->location == SymbolLocation::LOCAL &&
@@ -1564,6 +1787,12 @@ namespace RealSix::Script
 		return nullptr;
 	}
 
+	void Compiler::PushFunction(FunctionObject *function)
+	{
+		function->chunk.constants = mConstantPool;
+		mFunctionList.emplace_back(function);
+	}
+
 	Chunk &Compiler::CurChunk()
 	{
 		return CurFunction()->chunk;
@@ -1798,6 +2027,9 @@ namespace RealSix::Script
 	{
 		SAFE_DELETE(mSymbolTable);
 		std::vector<FunctionObject *>().swap(mFunctionList);
+		mJumpSites.clear();
+		mClassBodies.clear();
+		mConstantPool.reset();
 	}
 
 	void Compiler::EnterNewSymbolTable(StringView name, bool isClassOrModuleScope)
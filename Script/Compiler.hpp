@@ -64,6 +64,8 @@ namespace RealSix::Script
 		void CompileStructExpr(StructExpr *expr);
 		void CompileVarArgExpr(VarArgExpr *expr, const RWState &state = RWState::READ);
 		void CompileFactorialExpr(FactorialExpr *expr, const RWState &state = RWState::READ);
+		void CompileYieldExpr(YieldExpr *expr);
+		void CompileResumeExpr(ResumeExpr *expr);
 
 		Symbol CompileFunction(FunctionDecl *decl, ClassDecl::FunctionKind kind = ClassDecl::FunctionKind::NONE);
 		uint32_t CompileVars(VarDecl *decl,bool isStatic = false);
@@ -71,13 +73,17 @@ namespace RealSix::Script
 
 		uint64_t EmitOpCode(OpCode opCode, const Token *token);
 		uint64_t Emit(uint8_t opcode);
-		uint64_t EmitConstant(const Value &value, const Token *token);
-		uint64_t EmitClosure(FunctionObject *function, const Token *token);
+		uint64_t EmitU16(uint16_t operand);
+		uint64_t EmitU24(uint32_t operand);
+		uint64_t EmitIndexedOpCode(OpCode opCode, uint16_t index, const Token *token);
+		uint64_t EmitConstant(const Value &value, const Token *token, bool isShared = true);
+		uint64_t EmitClosure(FunctionObject *function, const Token *token, const SymbolTable *symbolTable);
 		uint64_t EmitReturn(uint8_t retCount, const Token *token);
 		uint64_t EmitJump(OpCode opcode, const Token *token);
-		void EmitLoop(uint16_t opcode, const Token *token);
+		void EmitLoop(uint64_t loopAddress, const Token *token);
 		void PatchJump(uint64_t offset);
-		uint8_t AddConstant(const Value &value);
+		void RelaxJumps();
+		uint32_t AddConstant(const Value &value, const Token *token, bool isShared = true);
 
 		void EmitSymbol(const Symbol &symbol);
 
@@ -86,6 +92,7 @@ namespace RealSix::Script
 
 		SymbolTable * GetLegacySymbolTable(StringView name);
 		
+		void PushFunction(FunctionObject *function);
 		Chunk &CurChunk();
 		FunctionObject *CurFunction();
 		OpCodeList &CurOpCodeList();
@@ -100,9 +107,20 @@ namespace RealSix::Script
 		void PopupSymbolTable();
 
 		std::vector<FunctionObject *> mFunctionList;
+		std::shared_ptr<ConstantPool> mConstantPool;
 		SymbolTable *mSymbolTable;
 
 		std::vector<SymbolTable *> mLegacySymbolTables;
 		int64_t mCurBreakStmtAddress, mCurContinueStmtAddress;
+
+		struct JumpSite
+		{
+			uint64_t address; // address of the jump opcode
+			uint64_t target;
+		};
+		std::unordered_map<FunctionObject *, std::vector<JumpSite>> mJumpSites;
+
+		// Class body function of every class laid out by TypeCheckAndResolvePass, OP_GET_PROPERTY_SLOT refers to it
+		std::unordered_map<const ClassLayout *, FunctionObject *> mClassBodies;
 	};
 }
\ No newline at end of file
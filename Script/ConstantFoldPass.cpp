@@ -227,6 +227,21 @@ namespace RealSix::Script
 		return expr;
 	}
 
+	Expr *ConstantFoldPass::ExecuteYieldExpr(YieldExpr *expr)
+	{
+		if (expr->expr)
+			expr->expr = ExecuteExpr(expr->expr);
+		return expr;
+	}
+
+	Expr *ConstantFoldPass::ExecuteResumeExpr(ResumeExpr *expr)
+	{
+		expr->fiber = ExecuteExpr(expr->fiber);
+		if (expr->value)
+			expr->value = ExecuteExpr(expr->value);
+		return expr;
+	}
+
 	Expr *ConstantFoldPass::ExecuteRefExpr(RefExpr *expr)
 	{
 		expr->refExpr = (IdentifierExpr *)ExecuteExpr(expr->refExpr);
@@ -51,6 +51,8 @@ namespace RealSix::Script
         Expr *ExecuteBaseExpr(BaseExpr *expr) override;
         Expr *ExecuteFactorialExpr(FactorialExpr *expr) override;
         Expr *ExecuteVarDescExpr(VarDescExpr *expr) override;
+        Expr *ExecuteYieldExpr(YieldExpr *expr) override;
+        Expr *ExecuteResumeExpr(ResumeExpr *expr) override;
 
         Expr *ConstantFold(Expr *expr);
     };
@@ -1,6 +1,10 @@
 #include "Context.hpp"
 #include "library/LibraryManager.hpp"
 #include "Allocator.hpp"
+#include "FiberScheduler.hpp"
+#include "Profiler.hpp"
+#include "Instrument.hpp"
+#include "Logger.hpp"
 namespace RealSix::Script
 {
     void Context::Init()
@@ -14,9 +18,25 @@ namespace RealSix::Script
             ModuleObject *lib = LibraryManager::GetInstance().GetLibraries()[i];
             Allocator::GetInstance().SetGlobalValue(i, lib);
         }
+
+        if (ScriptConfig::GetInstance().IsProfile())
+            Profiler::GetInstance().Start(ScriptConfig::GetInstance().GetProfileSampleInterval());
     }
     void Context::CleanUp()
     {
+        if (Profiler::GetInstance().IsRunning())
+        {
+            Profiler::GetInstance().Stop();
+            Logger::Println("{}", Profiler::GetInstance().ToReport());
+            if (!ScriptConfig::GetInstance().GetProfileFilePath().Empty())
+                Profiler::GetInstance().ExportCollapsedStacks(ScriptConfig::GetInstance().GetProfileFilePath());
+        }
+
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+        Logger::Println("{}", Instrument::GetInstance().ToReport());
+#endif
+
+        FiberScheduler::GetInstance().CleanUp();
         LibraryManager::GetInstance().CleanUp();
         Allocator::GetInstance().CleanUp();
     }
@@ -0,0 +1,72 @@
+#include "FiberScheduler.hpp"
+#include <chrono>
+#include "Object.hpp"
+#include "VM.hpp"
+namespace RealSix::Script
+{
+	static double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void FiberScheduler::Start(FiberObject *fiber)
+	{
+		mTasks.emplace_back(Task{fiber, 0.0});
+	}
+
+	void FiberScheduler::Tick()
+	{
+		if (mTasks.empty())
+			return;
+
+		// A resumed fiber can call fiber.tick again, only the outermost tick removes finished fibers
+		bool isOutermost = !mTicking;
+		mTicking = true;
+
+		double now = Now();
+		VM vm;
+		static const Token tickToken{TokenKind::END, "", SourceLocation{"FiberScheduler::Tick", ""}};
+
+		// Fibers started by the resumed ones are appended and first run on the next tick
+		size_t taskCount = mTasks.size();
+		for (size_t i = 0; i < taskCount; ++i)
+		{
+			auto fiber = mTasks[i].fiber;
+			if (fiber->status != FiberStatus::SUSPENDED || mTasks[i].wakeUpTime > now)
+				continue;
+
+			Value yielded;
+			vm.Resume(fiber, Value(), &tickToken, yielded);
+
+			if (IS_INT_VALUE(yielded))
+				mTasks[i].wakeUpTime = now + TO_INT_VALUE(yielded);
+			else if (IS_FLOAT_VALUE(yielded))
+				mTasks[i].wakeUpTime = now + TO_FLOAT_VALUE(yielded);
+			else
+				mTasks[i].wakeUpTime = 0.0;
+		}
+
+		if (!isOutermost)
+			return;
+		mTicking = false;
+
+		std::erase_if(mTasks, [](const Task &task)
+					  { return task.fiber->status == FiberStatus::DEAD; });
+	}
+
+	void FiberScheduler::CleanUp()
+	{
+		std::vector<Task>().swap(mTasks);
+	}
+
+	size_t FiberScheduler::GetFiberCount() const
+	{
+		return mTasks.size();
+	}
+
+	void FiberScheduler::MarkFibers()
+	{
+		for (const auto &task : mTasks)
+			task.fiber->Mark();
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include "Core/Marco.hpp"
+#include "Core/Common.hpp"
+namespace RealSix::Script
+{
+    struct FiberObject;
+
+    // Resumes started fibers once per App::Tick.
+    // A fiber yielding a number sleeps for that many seconds, any other yielded value resumes it again on the
+    // next tick. It leaves the scheduler when its function returns.
+    class REALSIX_API FiberScheduler : public Singleton<FiberScheduler>
+    {
+    public:
+        void Start(FiberObject *fiber);
+        void Tick();
+        void CleanUp();
+
+        size_t GetFiberCount() const;
+
+    private:
+        friend class Allocator;
+        void MarkFibers();
+
+        struct Task
+        {
+            FiberObject *fiber{nullptr};
+            double wakeUpTime{0.0}; // seconds on the steady clock
+        };
+
+        std::vector<Task> mTasks;
+        bool mTicking{false};
+    };
+}
@@ -0,0 +1,76 @@
+#include "Instrument.hpp"
+#include <algorithm>
+#include <format>
+#include <vector>
+#include "Chunk.hpp"
+#include "Object.hpp"
+namespace RealSix::Script
+{
+	void Instrument::EndOpCode()
+	{
+		if (mIsTiming)
+			mOpCodeCycles[mCurOpCode] += ReadCycleCounter() - mLastCycle;
+		mIsTiming = false;
+	}
+
+	void Instrument::RecordCall(const FunctionObject *function)
+	{
+		auto [iter, isNew] = mFunctionCalls.try_emplace(function->id);
+		if (isNew)
+			iter->second.name = function->name.Empty() ? String("<lambda>") : function->name;
+		iter->second.count++;
+	}
+
+	void Instrument::Reset()
+	{
+		mOpCodeCounts.fill(0);
+		mOpCodeCycles.fill(0);
+		mFunctionCalls.clear();
+		mNativeCallCount = 0;
+		mFiberResumeCount = 0;
+		mIsTiming = false;
+	}
+
+	String Instrument::ToReport(size_t maxFunctionCount) const
+	{
+		uint64_t totalCount = 0;
+		uint64_t totalCycles = 0;
+		std::vector<uint8_t> opCodes;
+		for (size_t i = 0; i < UINT8_COUNT; ++i)
+		{
+			totalCount += mOpCodeCounts[i];
+			totalCycles += mOpCodeCycles[i];
+			if (mOpCodeCounts[i] > 0)
+				opCodes.emplace_back(static_cast<uint8_t>(i));
+		}
+
+		std::sort(opCodes.begin(), opCodes.end(), [this](uint8_t left, uint8_t right)
+				  { return mOpCodeCycles[left] > mOpCodeCycles[right]; });
+
+		String result = std::format("{} opcodes executed in {} cycles\n", totalCount, totalCycles);
+		result += std::format("{:<28}{:>14}{:>9}{:>18}{:>9}{:>12}\n", "opcode", "count", "count%", "cycles", "cycles%", "cycles/op");
+		for (auto opCode : opCodes)
+		{
+			auto count = mOpCodeCounts[opCode];
+			auto cycles = mOpCodeCycles[opCode];
+			result += std::format("{:<28}{:>14}{:>8.2f}%{:>18}{:>8.2f}%{:>12.1f}\n",
+								  GetOpCodeName(static_cast<OpCode>(opCode)),
+								  count,
+								  totalCount > 0 ? 100.0 * count / totalCount : 0.0,
+								  cycles,
+								  totalCycles > 0 ? 100.0 * cycles / totalCycles : 0.0,
+								  static_cast<double>(cycles) / count);
+		}
+
+		std::vector<const FunctionCalls *> functions;
+		for (const auto &[id, calls] : mFunctionCalls)
+			functions.emplace_back(&calls);
+		std::sort(functions.begin(), functions.end(), [](const FunctionCalls *left, const FunctionCalls *right)
+				  { return left->count > right->count; });
+
+		result += std::format("{} functions called, {} native calls, {} fiber resumes\n", functions.size(), mNativeCallCount, mFiberResumeCount);
+		for (size_t i = 0; i < std::min(functions.size(), maxFunctionCount); ++i)
+			result += std::format("{:<42}{:>14}\n", functions[i]->name.GetRawData(), functions[i]->count);
+		return result;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <unordered_map>
+#include "Core/Marco.hpp"
+#include "Core/Common.hpp"
+#include "Core/String.hpp"
+#include "Utils.hpp"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+namespace RealSix::Script
+{
+    struct FunctionObject;
+
+    inline uint64_t ReadCycleCounter()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Per opcode execution counters and cycle accounting for tuning the interpreter.
+    // VM::Execute only feeds it when built with the REALSIX_SCRIPT_INSTRUMENT cmake option,
+    // the report is printed by Context::CleanUp.
+    class REALSIX_API Instrument : public Singleton<Instrument>
+    {
+    public:
+        // Charge the cycles elapsed since the previous opcode began to it, then start timing opCode
+        inline void BeginOpCode(uint8_t opCode)
+        {
+            uint64_t now = ReadCycleCounter();
+            if (mIsTiming)
+                mOpCodeCycles[mCurOpCode] += now - mLastCycle;
+            mOpCodeCounts[opCode]++;
+            mCurOpCode = opCode;
+            mLastCycle = now;
+            mIsTiming = true;
+        }
+
+        // Charge the running opcode, call when the vm leaves the dispatch loop
+        void EndOpCode();
+
+        // Script calls from OP_CALL, VM::Call and the start of a fiber
+        void RecordCall(const FunctionObject *function);
+        inline void RecordNativeCall()
+        {
+            mNativeCallCount++;
+        }
+        inline void RecordFiberResume()
+        {
+            mFiberResumeCount++;
+        }
+
+        void Reset();
+
+        // Opcodes sorted by total cycles followed by the most called functions
+        String ToReport(size_t maxFunctionCount = 20) const;
+
+    private:
+        std::array<uint64_t, UINT8_COUNT> mOpCodeCounts{};
+        std::array<uint64_t, UINT8_COUNT> mOpCodeCycles{};
+        struct FunctionCalls
+        {
+            String name;
+            uint64_t count{0};
+        };
+        // Keyed by FunctionObject::id, the function may be freed before the report
+        std::unordered_map<uint64_t, FunctionCalls> mFunctionCalls;
+        uint64_t mNativeCallCount{0};
+        uint64_t mFiberResumeCount{0};
+
+        uint8_t mCurOpCode{0};
+        uint64_t mLastCycle{0};
+        bool mIsTiming{false};
+    };
+}
@@ -51,6 +51,8 @@ namespace RealSix::Script
 		{"any", TokenKind::ANY},
 		{"as", TokenKind::AS},
 		{"new", TokenKind::NEW},
+		{"yield", TokenKind::YIELD},
+		{"resume", TokenKind::RESUME},
 		{"struct", TokenKind::STRUCT},
 	};
 
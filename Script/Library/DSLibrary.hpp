@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include "Allocator.hpp"
+#include "VM.hpp"
 
 namespace RealSix::Script
 {
@@ -15,17 +18,17 @@ namespace RealSix::Script
 
                                                                      if (IS_ARRAY_VALUE(args[0]))
                                                                      {
-                                                                         result = Value((int64_t)TO_ARRAY_VALUE(args[0])->elements.size());
+                                                                         result = Value((int64_t)TO_ARRAY_VALUE(args[0])->elements.Size());
                                                                          return true;
                                                                      }
                                                                      else if (IS_DICT_VALUE(args[0]))
                                                                      {
-                                                                         result = Value((int64_t)TO_DICT_VALUE(args[0])->elements.size());
+                                                                         result = Value((int64_t)TO_DICT_VALUE(args[0])->elements.Size());
                                                                          return true;
                                                                      }
                                                                      else if (IS_STR_VALUE(args[0]))
                                                                      {
-                                                                         result = Value((int64_t)TO_STR_VALUE(args[0])->value.Size());
+                                                                         result = Value((int64_t)TO_STR_VALUE(args[0])->Size());
                                                                          return true;
                                                                      }
                                                                      else
@@ -47,24 +50,21 @@ namespace RealSix::Script
 
                                                                          int64_t iIndex = TO_INT_VALUE(args[1]);
 
-                                                                         if (iIndex < 0 || iIndex >= (int64_t)array->elements.size())
+                                                                         if (iIndex < 0 || iIndex > (int64_t)array->elements.Size()) // inserting at the size appends
                                                                              REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Index out of array's range");
 
-                                                                         array->elements.insert(array->elements.begin() + iIndex, 1, args[2]);
+                                                                         array->elements.Insert(iIndex, args[2]);
                                                                      }
                                                                      else if (IS_DICT_VALUE(args[0]))
                                                                      {
                                                                          DictObject *dict = TO_DICT_VALUE(args[0]);
 
-                                                                         for (auto [key, value] : dict->elements)
-                                                                             if (key == args[1])
-                                                                                 REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Already exist value in the dict object of arg1" + args[1].ToString());
-
-                                                                         dict->elements[args[1]] = args[2];
+                                                                         if (!dict->elements.Set(args[1], args[2]))
+                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Already exist value in the dict object of arg1" + args[1].ToString());
                                                                      }
                                                                      else if (IS_STR_VALUE(args[0]))
                                                                      {
-                                                                         auto &string = TO_STR_VALUE(args[0])->value;
+                                                                         const auto &string = TO_STR_VALUE(args[0])->GetValue();
                                                                          if (!IS_INT_VALUE(args[1]))
                                                                              REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Arg1 must be integer type while insert to a array");
 
@@ -73,7 +73,11 @@ namespace RealSix::Script
                                                                          if (iIndex < 0 || iIndex >= (int64_t)string.Size())
                                                                              REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Index out of array's range");
 
-                                                                         string.Insert(iIndex, args[2].ToString());
+                                                                         // The string may be a literal or part of other values, the result is a new string
+                                                                         String inserted = string;
+                                                                         inserted.Insert(iIndex, args[2].ToString());
+                                                                         result = Allocator::GetInstance().CreateObject<StrObject>(std::move(inserted));
+                                                                         return true;
                                                                      }
                                                                      else
                                                                          REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'insert']:Expect a array,dict ot string argument.");
@@ -95,31 +99,21 @@ namespace RealSix::Script
 
                                                                         int64_t iIndex = TO_INT_VALUE(args[1]);
 
-                                                                        if (iIndex < 0 || iIndex >= (int64_t)array->elements.size())
+                                                                        if (iIndex < 0 || iIndex >= (int64_t)array->elements.Size())
                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'erase']:Index out of array's range");
 
-                                                                        array->elements.erase(array->elements.begin() + iIndex);
+                                                                        array->elements.Erase(iIndex);
                                                                     }
                                                                     else if (IS_DICT_VALUE(args[0]))
                                                                     {
                                                                         DictObject *dict = TO_DICT_VALUE(args[0]);
 
-                                                                        bool hasValue = false;
-
-                                                                        for (auto it = dict->elements.begin(); it != dict->elements.end(); ++it)
-                                                                            if (it->first == args[1])
-                                                                            {
-                                                                                dict->elements.erase(it);
-                                                                                hasValue = true;
-                                                                                break;
-                                                                            }
-
-                                                                        if (!hasValue)
+                                                                        if (!dict->elements.Erase(args[1]))
                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'erase']:No corresponding index in dict.");
                                                                     }
                                                                     else if (IS_STR_VALUE(args[0]))
                                                                     {
-                                                                        String &string = TO_STR_VALUE(args[0])->value;
+                                                                        const String &string = TO_STR_VALUE(args[0])->GetValue();
                                                                         if (!IS_INT_VALUE(args[1]))
                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'erase']:Arg1 must be integer type while insert to a array");
 
@@ -128,7 +122,10 @@ namespace RealSix::Script
                                                                         if (iIndex < 0 || iIndex >= (int64_t)string.Size())
                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'erase']:Index out of array's range");
 
-                                                                        string.Erase(iIndex);
+                                                                        String erased = string;
+                                                                        erased.Erase(iIndex);
+                                                                        result = Allocator::GetInstance().CreateObject<StrObject>(std::move(erased));
+                                                                        return true;
                                                                     }
                                                                     else
                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'erase']:Expect a array,dict ot string argument.");
@@ -137,9 +134,232 @@ namespace RealSix::Script
                                                                     return true;
                                                                 });
 
+            const auto MapFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                              {
+                                                                  if (args == nullptr || argCount != 2 || !IS_ARRAY_VALUE(args[0]))
+                                                                      REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'map']:Expect 2 arguments,the arg0 must be array object.The arg1 is the function applied to each element.");
+
+                                                                  const auto &elements = TO_ARRAY_VALUE(args[0])->elements;
+                                                                  auto mapped = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                  PUSH_STACK(mapped); // keep the result alive while the callback runs
+                                                                  mapped->elements.Reserve(elements.Size());
+
+                                                                  VM vm;
+                                                                  for (size_t i = 0; i < elements.Size(); ++i)
+                                                                  {
+                                                                      Value element = elements.Get(i), mappedElement;
+                                                                      vm.Call(args[1], &element, 1, relatedToken, mappedElement);
+                                                                      mapped->elements.Push(mappedElement);
+                                                                  }
+
+                                                                  result = POP_STACK();
+                                                                  return true;
+                                                              });
+
+            const auto FilterFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount != 2 || !IS_ARRAY_VALUE(args[0]))
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'filter']:Expect 2 arguments,the arg0 must be array object.The arg1 is the predicate function.");
+
+                                                                     const auto &elements = TO_ARRAY_VALUE(args[0])->elements;
+                                                                     auto filtered = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                     PUSH_STACK(filtered); // keep the result alive while the callback runs
+
+                                                                     VM vm;
+                                                                     for (size_t i = 0; i < elements.Size(); ++i)
+                                                                     {
+                                                                         Value element = elements.Get(i), isKept;
+                                                                         vm.Call(args[1], &element, 1, relatedToken, isKept);
+                                                                         if (!vm.IsFalsey(isKept))
+                                                                             filtered->elements.Push(element);
+                                                                     }
+
+                                                                     result = POP_STACK();
+                                                                     return true;
+                                                                 });
+
+            const auto ReduceFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount != 3 || !IS_ARRAY_VALUE(args[0]))
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'reduce']:Expect 3 arguments,the arg0 must be array object.The arg1 is the function(accumulator,element).The arg2 is the initial accumulator.");
+
+                                                                     const auto &elements = TO_ARRAY_VALUE(args[0])->elements;
+
+                                                                     VM vm;
+                                                                     Value callArgs[2] = {args[2], Value()};
+                                                                     for (size_t i = 0; i < elements.Size(); ++i)
+                                                                     {
+                                                                         callArgs[1] = elements.Get(i);
+                                                                         vm.Call(args[1], callArgs, 2, relatedToken, callArgs[0]);
+                                                                     }
+
+                                                                     result = callArgs[0];
+                                                                     return true;
+                                                                 });
+
+            const auto SortFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                               {
+                                                                   if (args == nullptr || (argCount != 1 && argCount != 2) || !IS_ARRAY_VALUE(args[0]))
+                                                                       REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'sort']:Expect 1 or 2 arguments,the arg0 must be array object.The optional arg1 is the function(left,right) returning true when left goes first.");
+
+                                                                   auto &elements = TO_ARRAY_VALUE(args[0])->elements;
+                                                                   result = args[0];
+                                                                   if (argCount == 1 && elements.SortPacked())
+                                                                       return true;
+
+                                                                   // The array keeps the elements alive while the comparison callback runs
+                                                                   std::vector<Value> sorted(elements.Size());
+                                                                   for (size_t i = 0; i < sorted.size(); ++i)
+                                                                       sorted[i] = elements.Get(i);
+
+                                                                   if (argCount == 2)
+                                                                   {
+                                                                       VM vm;
+                                                                       std::stable_sort(sorted.begin(), sorted.end(), [&](const Value &left, const Value &right)
+                                                                                        {
+                                                                                            Value callArgs[2] = {left, right}, isLess;
+                                                                                            vm.Call(args[1], callArgs, 2, relatedToken, isLess);
+                                                                                            return !vm.IsFalsey(isLess); });
+                                                                   }
+                                                                   else
+                                                                   {
+                                                                       std::stable_sort(sorted.begin(), sorted.end(), [&](const Value &left, const Value &right)
+                                                                                        {
+                                                                                            if (IS_INT_VALUE(left) && IS_INT_VALUE(right))
+                                                                                                return TO_INT_VALUE(left) < TO_INT_VALUE(right);
+                                                                                            if ((IS_INT_VALUE(left) || IS_FLOAT_VALUE(left)) && (IS_INT_VALUE(right) || IS_FLOAT_VALUE(right)))
+                                                                                                return (IS_INT_VALUE(left) ? TO_INT_VALUE(left) : TO_FLOAT_VALUE(left)) < (IS_INT_VALUE(right) ? TO_INT_VALUE(right) : TO_FLOAT_VALUE(right));
+                                                                                            if (IS_STR_VALUE(left) && IS_STR_VALUE(right))
+                                                                                                return TO_STR_VALUE(left)->GetValue() < TO_STR_VALUE(right)->GetValue();
+                                                                                            REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'sort']:Only numbers or strings can be sorted without a comparison function: {},{}", left.ToString(), right.ToString());
+                                                                                            return false; });
+                                                                   }
+
+                                                                   for (size_t i = 0; i < sorted.size(); ++i)
+                                                                       elements.Set(i, sorted[i]);
+                                                                   return true;
+                                                               });
+
+            const auto SliceFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                {
+                                                                    if (args == nullptr || (argCount != 2 && argCount != 3) || !IS_INT_VALUE(args[1]) || (argCount == 3 && !IS_INT_VALUE(args[2])))
+                                                                        REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'slice']:Expect 2 or 3 arguments,the arg0 must be array or string object.The arg1 is the begin index.The optional arg2 is the end index(exclusive).");
+
+                                                                    if (IS_ARRAY_VALUE(args[0]))
+                                                                    {
+                                                                        const auto &elements = TO_ARRAY_VALUE(args[0])->elements;
+                                                                        int64_t begin = TO_INT_VALUE(args[1]);
+                                                                        int64_t end = argCount == 3 ? TO_INT_VALUE(args[2]) : (int64_t)elements.Size();
+                                                                        if (begin < 0 || begin > end || end > (int64_t)elements.Size())
+                                                                            REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'slice']:Index out of array's range");
+
+                                                                        auto slice = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                        slice->elements.Append(elements, begin, end);
+                                                                        result = slice;
+                                                                    }
+                                                                    else if (IS_STR_VALUE(args[0]))
+                                                                    {
+                                                                        const auto &string = TO_STR_VALUE(args[0])->GetValue();
+                                                                        int64_t begin = TO_INT_VALUE(args[1]);
+                                                                        int64_t end = argCount == 3 ? TO_INT_VALUE(args[2]) : (int64_t)string.Size();
+                                                                        if (begin < 0 || begin > end || end > (int64_t)string.Size())
+                                                                            REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'slice']:Index out of string's range");
+
+                                                                        result = Allocator::GetInstance().CreateObject<StrObject>(string.SubStr(begin, end - begin));
+                                                                    }
+                                                                    else
+                                                                        REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'slice']:Expect a array or string argument.");
+
+                                                                    return true;
+                                                                });
+
+            const auto ConcatFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount < 2)
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'concat']:Expect at least 2 arguments,all of them array objects.");
+
+                                                                     size_t size = 0;
+                                                                     for (uint32_t i = 0; i < argCount; ++i)
+                                                                     {
+                                                                         if (!IS_ARRAY_VALUE(args[i]))
+                                                                             REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'concat']:Arg{} is not a array object.", i);
+                                                                         size += TO_ARRAY_VALUE(args[i])->elements.Size();
+                                                                     }
+
+                                                                     auto concatenated = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                     concatenated->elements.Reserve(size);
+                                                                     for (uint32_t i = 0; i < argCount; ++i)
+                                                                     {
+                                                                         const auto &elements = TO_ARRAY_VALUE(args[i])->elements;
+                                                                         concatenated->elements.Append(elements, 0, elements.Size());
+                                                                     }
+
+                                                                     result = concatenated;
+                                                                     return true;
+                                                                 });
+
+            const auto ReserveFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                  {
+                                                                      if (args == nullptr || argCount != 2 || !IS_INT_VALUE(args[1]) || TO_INT_VALUE(args[1]) < 0)
+                                                                          REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'reserve']:Expect 2 arguments,the arg0 must be array or dict object.The arg1 is the non negative element count.");
+
+                                                                      if (IS_ARRAY_VALUE(args[0]))
+                                                                          TO_ARRAY_VALUE(args[0])->elements.Reserve(TO_INT_VALUE(args[1]));
+                                                                      else if (IS_DICT_VALUE(args[0]))
+                                                                      {
+                                                                          auto &elements = TO_DICT_VALUE(args[0])->elements;
+                                                                          if (TO_INT_VALUE(args[1]) > (int64_t)elements.Size())
+                                                                              elements.Reserve(TO_INT_VALUE(args[1]) - elements.Size());
+                                                                      }
+                                                                      else
+                                                                          REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'reserve']:Expect a array or dict argument.");
+
+                                                                      result = args[0];
+                                                                      return true;
+                                                                  });
+
+            const auto KeysFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                               {
+                                                                   if (args == nullptr || argCount != 1 || !IS_DICT_VALUE(args[0]))
+                                                                       REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'keys']:Expect a dict argument.");
+
+                                                                   const auto &elements = TO_DICT_VALUE(args[0])->elements;
+                                                                   auto keys = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                   keys->elements.Reserve(elements.Size());
+                                                                   for (const auto &[key, value] : elements)
+                                                                       keys->elements.Push(key);
+
+                                                                   result = keys;
+                                                                   return true;
+                                                               });
+
+            const auto ValuesFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount != 1 || !IS_DICT_VALUE(args[0]))
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'values']:Expect a dict argument.");
+
+                                                                     const auto &elements = TO_DICT_VALUE(args[0])->elements;
+                                                                     auto values = Allocator::GetInstance().CreateObject<ArrayObject>();
+                                                                     values->elements.Reserve(elements.Size());
+                                                                     for (const auto &[key, value] : elements)
+                                                                         values->elements.Push(value);
+
+                                                                     result = values;
+                                                                     return true;
+                                                                 });
+
             members["sizeof"] = SizeOfFunction;
             members["insert"] = InsertFunction;
             members["erase"] = EraseFunction;
+            members["map"] = MapFunction;
+            members["filter"] = FilterFunction;
+            members["reduce"] = ReduceFunction;
+            members["sort"] = SortFunction;
+            members["slice"] = SliceFunction;
+            members["concat"] = ConcatFunction;
+            members["reserve"] = ReserveFunction;
+            members["keys"] = KeysFunction;
+            members["values"] = ValuesFunction;
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include "Allocator.hpp"
+#include "FiberScheduler.hpp"
+
+namespace RealSix::Script
+{
+    class REALSIX_API FiberLibrary : public ModuleObject
+    {
+    public:
+        FiberLibrary()
+            : ModuleObject("fiber")
+        {
+            const auto CreateFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount != 1)
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'create']:Expect a function argument.");
+
+                                                                     result = CreateFiber(args[0], relatedToken, "create");
+                                                                     return true;
+                                                                 });
+
+            const auto StatusFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                 {
+                                                                     if (args == nullptr || argCount != 1 || !IS_FIBER_VALUE(args[0]))
+                                                                         REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'status']:Expect a fiber argument.");
+
+                                                                     StringView status = "dead";
+                                                                     if (TO_FIBER_VALUE(args[0])->status == FiberStatus::SUSPENDED)
+                                                                         status = "suspended";
+                                                                     else if (TO_FIBER_VALUE(args[0])->status == FiberStatus::RUNNING)
+                                                                         status = "running";
+
+                                                                     result = Allocator::GetInstance().CreateObject<StrObject>(status);
+                                                                     return true;
+                                                                 });
+
+            const auto StartFunction = new NativeFunctionObject([](Value *args, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                                {
+                                                                    if (args == nullptr || argCount != 1)
+                                                                        REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'start']:Expect a function or fiber argument.");
+
+                                                                    result = IS_FIBER_VALUE(args[0]) ? args[0] : CreateFiber(args[0], relatedToken, "start");
+                                                                    if (TO_FIBER_VALUE(result)->status == FiberStatus::DEAD)
+                                                                        REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'start']:Cannot start a dead fiber.");
+
+                                                                    FiberScheduler::GetInstance().Start(TO_FIBER_VALUE(result));
+                                                                    return true;
+                                                                });
+
+            const auto TickFunction = new NativeFunctionObject([](Value *, uint32_t argCount, const Token *relatedToken, Value &result) -> bool
+                                                               {
+                                                                   if (argCount != 0)
+                                                                       REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function 'tick']:Expect no argument.");
+
+                                                                   FiberScheduler::GetInstance().Tick();
+                                                                   result = Value((int64_t)FiberScheduler::GetInstance().GetFiberCount());
+                                                                   return true;
+                                                               });
+
+            members["create"] = CreateFunction;
+            members["status"] = StatusFunction;
+            members["start"] = StartFunction;
+            members["tick"] = TickFunction;
+        }
+
+    private:
+        static Value CreateFiber(const Value &function, const Token *relatedToken, const char *nativeName)
+        {
+            if (!IS_CLOSURE_VALUE(function))
+                REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function '{}']:Expect a script function argument.", nativeName);
+
+            auto closure = TO_CLOSURE_VALUE(function);
+            if (closure->function->varArg != VarArg::NONE || closure->function->arity > 1)
+                REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function '{}']:A fiber function takes at most one parameter.", nativeName);
+
+            return Allocator::GetInstance().CreateObject<FiberObject>(closure);
+        }
+    };
+}
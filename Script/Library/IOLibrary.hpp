@@ -19,7 +19,7 @@ namespace RealSix::Script
             fn("{}", args[i].ToString());                                                                     \
         return false;                                                                                         \
     }                                                                                                         \
-    String content = TO_STR_VALUE(args[0])->value;                                                            \
+    String content = TO_STR_VALUE(args[0])->GetValue();                                                            \
     if (argCount != 1) /*formatting output*/                                                                  \
     {                                                                                                         \
         size_t pos = content.Find("{}");                                                                      \
@@ -9,6 +9,8 @@
 #include "DSLibrary.hpp"
 #include "MemLibrary.hpp"
 #include "TimeLibrary.hpp"
+#include "MathLibrary.hpp"
+#include "FiberLibrary.hpp"
 
 namespace RealSix::Script
 {
@@ -34,6 +36,8 @@ namespace RealSix::Script
         mLibraries.emplace_back(new DSLibrary());
         mLibraries.emplace_back(new MemLibrary());
         mLibraries.emplace_back(new TimeLibrary());
+        mLibraries.emplace_back(new MathLibrary());
+        mLibraries.emplace_back(new FiberLibrary());
     }
 
     void LibraryManager::CleanUp()
@@ -0,0 +1,61 @@
+#pragma once
+#include "Math/Math.hpp"
+#include "Math/Matrix4.hpp"
+#include "NativeBinding.hpp"
+
+namespace RealSix::Script
+{
+    class REALSIX_API MathLibrary : public ModuleObject
+    {
+    public:
+        MathLibrary()
+            : ModuleObject("math")
+        {
+            members["lerp"] = Bind<&Math::Lerp<double, double>>();
+            members["clamp"] = Bind<&Math::Clamp<double>>();
+            members["min"] = Bind<&Math::Min<double>>();
+            members["max"] = Bind<&Math::Max<double>>();
+            members["abs"] = Bind<&Math::Abs<double>>();
+            members["floor"] = Bind<&Math::Floor<double>>();
+            members["ceil"] = Bind<&Math::Ceil<double>>();
+            members["round"] = Bind<&Math::Round<double>>();
+            members["sqrt"] = Bind<&Math::Sqrt<double>>();
+            members["pow"] = Bind<&Math::Pow<double, double>>();
+            members["sin"] = Bind<&Math::Sin<double>>();
+            members["cos"] = Bind<&Math::Cos<double>>();
+            members["tan"] = Bind<&Math::Tan<double>>();
+            members["asin"] = Bind<&Math::ArcSin<double>>();
+            members["acos"] = Bind<&Math::ArcCos<double>>();
+            members["atan"] = Bind<&Math::ArcTan<double>>();
+            members["radians"] = Bind<&Math::ToRadian<double>>();
+            members["degrees"] = Bind<&Math::ToDegree<double>>();
+
+            members["vec3"] = Bind<&MakeVec3>();
+            members["dot"] = Bind<&Vector3f::Dot<float>>();
+            members["cross"] = Bind<&Vector3f::Cross<float>>();
+            members["length"] = Bind<&Length>();
+            members["normalize"] = Bind<&Vector3f::Normalize>();
+
+            members["quat"] = Bind<&MakeQuat>();
+            members["axisAngle"] = Bind<&MakeAxisAngleQuat>();
+            members["slerp"] = Bind<&Quaternionf::Slerp<float>>();
+            members["conjugate"] = Bind<&Quaternionf::Conjugate>();
+            members["toMat4"] = Bind<&Quaternionf::ToMatrix4>();
+
+            members["identity"] = Bind<&Identity>();
+            members["translate"] = Bind<&Matrix4f::Translate>();
+            members["rotate"] = Bind<&Matrix4f::Rotate>();
+            members["scale"] = Bind<static_cast<Matrix4f (*)(const Vector3f &)>(&Matrix4f::Scale)>();
+            members["transpose"] = Bind<&Matrix4f::Transpose>();
+            members["inverse"] = Bind<&Matrix4f::Inverse>();
+            members["lookAt"] = Bind<&Matrix4f::LookAt>();
+        }
+
+    private:
+        static Vector3f MakeVec3(float x, float y, float z) { return Vector3f(x, y, z); }
+        static float Length(const Vector3f &vec) { return vec.Length(); }
+        static Quaternionf MakeQuat(float x, float y, float z, float w) { return Quaternionf(x, y, z, w); }
+        static Quaternionf MakeAxisAngleQuat(const Vector3f &axis, float radian) { return Quaternionf(axis, radian); }
+        static Matrix4f Identity() { return Matrix4f::IDENTITY; }
+    };
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "Logger.hpp"
+#include "Object.hpp"
+#include "Value.hpp"
+namespace RealSix::Script
+{
+    // Conversion of one C++ parameter or return type from and to a script value.
+    // Specialize it to expose another type to Bind().
+    template <typename T, typename = void>
+    struct NativeType;
+
+    template <typename T>
+    struct NativeType<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    {
+        static constexpr const char *NAME = "int";
+        static bool Is(const Value &value) { return IS_INT_VALUE(value); }
+        static T From(const Value &value) { return static_cast<T>(TO_INT_VALUE(value)); }
+        static Value To(T value) { return Value(static_cast<int64_t>(value)); }
+    };
+
+    template <typename T>
+    struct NativeType<T, std::enable_if_t<std::is_floating_point_v<T>>>
+    {
+        static constexpr const char *NAME = "real";
+        static bool Is(const Value &value) { return IS_FLOAT_VALUE(value) || IS_INT_VALUE(value); }
+        static T From(const Value &value) { return static_cast<T>(IS_INT_VALUE(value) ? TO_INT_VALUE(value) : TO_FLOAT_VALUE(value)); }
+        static Value To(T value) { return Value(static_cast<double>(value)); }
+    };
+
+    template <>
+    struct NativeType<bool>
+    {
+        static constexpr const char *NAME = "bool";
+        static bool Is(const Value &value) { return IS_BOOL_VALUE(value); }
+        static bool From(const Value &value) { return TO_BOOL_VALUE(value); }
+        static Value To(bool value) { return Value(value); }
+    };
+
+    template <>
+    struct NativeType<String>
+    {
+        static constexpr const char *NAME = "string";
+        static bool Is(const Value &value) { return IS_STR_VALUE(value); }
+        static const String &From(const Value &value) { return TO_STR_VALUE(value)->GetValue(); }
+        static Value To(String value) { return Allocator::GetInstance().CreateObject<StrObject>(std::move(value)); }
+    };
+
+    template <>
+    struct NativeType<StringView>
+    {
+        static constexpr const char *NAME = "string";
+        static bool Is(const Value &value) { return IS_STR_VALUE(value); }
+        static StringView From(const Value &value) { return TO_STR_VALUE(value)->GetValue(); }
+        static Value To(StringView value) { return Allocator::GetInstance().CreateObject<StrObject>(value); }
+    };
+
+    template <>
+    struct NativeType<Value>
+    {
+        static constexpr const char *NAME = "any";
+        static bool Is(const Value &) { return true; }
+        static const Value &From(const Value &value) { return value; }
+        static Value To(const Value &value) { return value; }
+    };
+
+    template <>
+    struct NativeType<Vector3f>
+    {
+        static constexpr const char *NAME = "vec3";
+        static bool Is(const Value &value) { return IS_VEC3_VALUE(value); }
+        static const Vector3f &From(const Value &value) { return TO_VEC3_VALUE(value)->value; }
+        static Value To(const Vector3f &value) { return Allocator::GetInstance().CreateObject<Vec3Object>(value); }
+    };
+
+    template <>
+    struct NativeType<Quaternionf>
+    {
+        static constexpr const char *NAME = "quat";
+        static bool Is(const Value &value) { return IS_QUAT_VALUE(value); }
+        static const Quaternionf &From(const Value &value) { return TO_QUAT_VALUE(value)->value; }
+        static Value To(const Quaternionf &value) { return Allocator::GetInstance().CreateObject<QuatObject>(value); }
+    };
+
+    template <>
+    struct NativeType<Matrix4f>
+    {
+        static constexpr const char *NAME = "mat4";
+        static bool Is(const Value &value) { return IS_MAT4_VALUE(value); }
+        static const Matrix4f &From(const Value &value) { return TO_MAT4_VALUE(value)->value; }
+        static Value To(const Matrix4f &value) { return Allocator::GetInstance().CreateObject<Mat4Object>(value); }
+    };
+
+    template <typename Fn>
+    struct NativeSignature;
+
+    template <typename R, typename... Args>
+    struct NativeSignature<R (*)(Args...)>
+    {
+        using Return = R;
+        using Params = std::tuple<std::remove_cvref_t<Args>...>;
+    };
+
+    template <typename R, typename... Args>
+    struct NativeSignature<R (*)(Args...) noexcept> : NativeSignature<R (*)(Args...)>
+    {
+    };
+
+    namespace Detail
+    {
+        template <typename T>
+        inline void CheckNativeArg(const Value &arg, size_t idx, const Token *relatedToken)
+        {
+            if (!NativeType<T>::Is(arg))
+                REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function]:Arg{} expects {} but got {}.", idx, NativeType<T>::NAME, arg.ToString());
+        }
+
+        template <auto Fn, size_t... I>
+        inline bool InvokeNative(Value *args, [[maybe_unused]] const Token *relatedToken, Value &result, std::index_sequence<I...>)
+        {
+            using Signature = NativeSignature<decltype(Fn)>;
+            using Params = typename Signature::Params;
+
+            (CheckNativeArg<std::tuple_element_t<I, Params>>(args[I], I, relatedToken), ...);
+
+            if constexpr (std::is_void_v<typename Signature::Return>)
+            {
+                Fn(NativeType<std::tuple_element_t<I, Params>>::From(args[I])...);
+                return false;
+            }
+            else
+            {
+                result = NativeType<std::remove_cvref_t<typename Signature::Return>>::To(Fn(NativeType<std::tuple_element_t<I, Params>>::From(args[I])...));
+                return true;
+            }
+        }
+    }
+
+    // Marshalling thunk generated from the signature of Fn, it checks the argument count and types,
+    // converts the arguments, calls Fn directly and converts the result back
+    template <auto Fn>
+    bool NativeThunk(Value *args, uint32_t argCount, const Token *relatedToken, Value &result)
+    {
+        constexpr size_t arity = std::tuple_size_v<typename NativeSignature<decltype(Fn)>::Params>;
+        if (argCount != arity)
+            REALSIX_SCRIPT_LOG_ERROR(relatedToken, "[Native function]:Expect {} arguments but got {}.", arity, argCount);
+        return Detail::InvokeNative<Fn>(args, relatedToken, result, std::make_index_sequence<arity>());
+    }
+
+    // Native function object calling the C++ function Fn through the raw function pointer fast path:
+    // members["lerp"] = Bind<&Math::Lerp<double, double>>();
+    template <auto Fn>
+    NativeFunctionObject *Bind()
+    {
+        return new NativeFunctionObject(&NativeThunk<Fn>);
+    }
+}
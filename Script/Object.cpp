@@ -1,4 +1,7 @@
 #include "Object.hpp"
+#include <algorithm>
+#include <atomic>
+#include <format>
 #include "Chunk.hpp"
 #include "Common.hpp"
 #include "Logger.hpp"
@@ -42,19 +45,129 @@ namespace RealSix::Script
 	}
 
 	StrObject::StrObject(StringView value)
-		: Object(ObjectKind::STR), value(value)
+		: Object(ObjectKind::STR), mValue(value)
 	{
 	}
+
+	StrObject::StrObject(String &&value)
+		: Object(ObjectKind::STR), mValue(std::move(value))
+	{
+	}
+
+	StrObject::StrObject(StrObject *left, StrObject *right)
+		: Object(ObjectKind::STR)
+	{
+		auto size = left->Size() + right->Size();
+		if (size < ROPE_MIN_SIZE)
+			mValue = left->GetValue() + right->GetValue();
+		else
+		{
+			mNode = std::make_shared<RopeNode>();
+			mNode->left = left->GetRopeNode();
+			mNode->right = right->GetRopeNode();
+			mNode->size = size;
+		}
+	}
+
+	StrObject::RopeNode::~RopeNode()
+	{
+		if (!left)
+			return;
+
+		// Release the nodes only this one holds iteratively, a string built in a loop is a rope as deep as the loop count
+		std::vector<std::shared_ptr<RopeNode>> pending{std::move(left), std::move(right)};
+		while (!pending.empty())
+		{
+			auto node = std::move(pending.back());
+			pending.pop_back();
+			if (node.use_count() == 1 && node->left)
+			{
+				pending.emplace_back(std::move(node->left));
+				pending.emplace_back(std::move(node->right));
+			}
+		}
+	}
+
 	String StrObject::ToString() const
 	{
-		return value;
+		return GetValue();
 	}
 
 	bool StrObject::IsEqualTo(Object *other)
 	{
 		if (!IS_STR_OBJ(other))
 			return false;
-		return value == TO_STR_OBJ(other)->value;
+		auto strOther = TO_STR_OBJ(other);
+		return Size() == strOther->Size() && GetValue() == strOther->GetValue();
+	}
+
+	size_t StrObject::Size() const
+	{
+		return mNode ? mNode->size : mValue.Size();
+	}
+
+	const String &StrObject::GetValue() const
+	{
+		if (!mNode)
+			return mValue;
+		if (mNode->left)
+			Flatten();
+		return mNode->value;
+	}
+
+	String &StrObject::GetMutableValue()
+	{
+		if (mNode)
+		{
+			if (mNode->left)
+				Flatten();
+			if (mNode.use_count() == 1)
+				mValue = std::move(mNode->value);
+			else
+				mValue = mNode->value;
+			mNode.reset();
+		}
+		return mValue;
+	}
+
+	const std::shared_ptr<StrObject::RopeNode> &StrObject::GetRopeNode() const
+	{
+		// A flat string hands its content over to a leaf, the leaf is copied back only if this string is written to later
+		if (!mNode)
+		{
+			mNode = std::make_shared<RopeNode>();
+			mNode->size = mValue.Size();
+			mNode->value = std::move(mValue);
+			mValue = String();
+		}
+		return mNode;
+	}
+
+	void StrObject::Flatten() const
+	{
+		// Iterative in order walk, a string built in a loop is a rope as deep as the loop count
+		std::string result;
+		result.reserve(mNode->size);
+
+		std::vector<const RopeNode *> pending{mNode->right.get(), mNode->left.get()};
+		while (!pending.empty())
+		{
+			const RopeNode *node = pending.back();
+			pending.pop_back();
+			if (node->left)
+			{
+				pending.emplace_back(node->right.get());
+				pending.emplace_back(node->left.get());
+			}
+			else
+				result += node->value.GetRawData();
+		}
+
+		// Other ropes may still share the old node, this string moves on to a leaf of its own
+		auto leaf = std::make_shared<RopeNode>();
+		leaf->value = String(std::move(result));
+		leaf->size = mNode->size;
+		mNode = std::move(leaf);
 	}
 
 	std::vector<uint8_t> StrObject::Serialize() const
@@ -75,10 +188,10 @@ namespace RealSix::Script
 	String ArrayObject::ToString() const
 	{
 		String result = "[";
-		if (!elements.empty())
+		if (!elements.Empty())
 		{
-			for (const auto &e : elements)
-				result += e.ToString() + ",";
+			for (size_t i = 0; i < elements.Size(); ++i)
+				result += elements.Get(i).ToString() + ",";
 			result = result.SubStr(0, result.Size() - 1);
 		}
 		result += "]";
@@ -88,8 +201,10 @@ namespace RealSix::Script
 	void ArrayObject::Blacken()
 	{
 		Object::Blacken();
-		for (auto &e : elements)
-			e.Mark();
+		// Packed arrays hold no objects
+		if (elements.GetKind() == ArrayElementKind::GENERIC)
+			for (size_t i = 0; i < elements.Size(); ++i)
+				elements.GetValueData()[i].Mark();
 	}
 
 	bool ArrayObject::IsEqualTo(Object *other)
@@ -99,11 +214,11 @@ namespace RealSix::Script
 
 		ArrayObject *arrayOther = TO_ARRAY_OBJ(other);
 
-		if (arrayOther->elements.size() != elements.size())
+		if (arrayOther->elements.Size() != elements.Size())
 			return false;
 
-		for (size_t i = 0; i < elements.size(); ++i)
-			if (elements[i] != arrayOther->elements[i])
+		for (size_t i = 0; i < elements.Size(); ++i)
+			if (elements.Get(i) != arrayOther->elements.Get(i))
 				return false;
 
 		return true;
@@ -119,7 +234,7 @@ namespace RealSix::Script
 		: Object(ObjectKind::DICT)
 	{
 	}
-	DictObject::DictObject(const ValueUnorderedMap &elements)
+	DictObject::DictObject(const ValueDict &elements)
 		: Object(ObjectKind::DICT), elements(elements)
 	{
 	}
@@ -151,18 +266,13 @@ namespace RealSix::Script
 
 		DictObject *dictOther = TO_TABLE_OBJ(other);
 
-		if (dictOther->elements.size() != elements.size())
+		if (dictOther->elements.Size() != elements.Size())
 			return false;
 
-		for (const auto &[k1, v1] : elements)
+		for (const auto &[k, v] : elements)
 		{
-			bool isFound = false;
-			for (const auto &[k2, v2] : dictOther->elements)
-			{
-				if (k1 == k2 && v1 == v2)
-					isFound = true;
-			}
-			if (!isFound)
+			auto otherValue = dictOther->elements.Find(k);
+			if (otherValue == nullptr || *otherValue != v)
 				return false;
 		}
 
@@ -230,12 +340,14 @@ namespace RealSix::Script
 		return std::vector<uint8_t>();
 	}
 
+	static std::atomic<uint64_t> sNextFunctionId{1};
+
 	FunctionObject::FunctionObject()
 		: FunctionObject("")
 	{
 	}
 	FunctionObject::FunctionObject(StringView name)
-		: Object(ObjectKind::FUNCTION), arity(0), upValueCount(0), name(name), varArg(VarArg::NONE)
+		: Object(ObjectKind::FUNCTION), id(sNextFunctionId.fetch_add(1, std::memory_order_relaxed)), arity(0), upValueCount(0), name(name), varArg(VarArg::NONE)
 	{
 	}
 
@@ -253,8 +365,8 @@ namespace RealSix::Script
 	void FunctionObject::Blacken()
 	{
 		Object::Blacken();
-		for (auto &c : chunk.constants)
-			c.Mark();
+		if (chunk.constants)
+			chunk.constants->Mark(Allocator::GetInstance().GetGCCycle());
 
 		// ++ Function cache relative
 		if (ScriptConfig::GetInstance().IsUseFunctionCache())
@@ -327,6 +439,8 @@ namespace RealSix::Script
 	{
 		Object::Blacken();
 		closed.Mark();
+		if (fiber)
+			fiber->Mark();
 	}
 
 	bool UpValueObject::IsEqualTo(Object *other)
@@ -351,14 +465,25 @@ namespace RealSix::Script
 		return std::vector<uint8_t>();
 	}
 
-	ClosureObject::ClosureObject()
-		: Object(ObjectKind::CLOSURE), function(nullptr)
-	{
-	}
 	ClosureObject::ClosureObject(FunctionObject *function)
 		: Object(ObjectKind::CLOSURE), function(function)
 	{
-		upvalues.resize(function->upValueCount);
+		std::fill_n(GetUpValues(), function->upValueCount, nullptr);
+	}
+
+	void *ClosureObject::operator new(size_t size, FunctionObject *function)
+	{
+		return ::operator new(size + function->upValueCount * sizeof(UpValueObject *));
+	}
+
+	void ClosureObject::operator delete(void *ptr, FunctionObject *)
+	{
+		::operator delete(ptr);
+	}
+
+	void ClosureObject::operator delete(void *ptr)
+	{
+		::operator delete(ptr);
 	}
 
 	String ClosureObject::ToString() const
@@ -370,7 +495,8 @@ namespace RealSix::Script
 	{
 		Object::Blacken();
 		function->Mark();
-		for (int32_t i = 0; i < upvalues.size(); ++i)
+		auto upvalues = GetUpValues();
+		for (int32_t i = 0; i < GetUpValueCount(); ++i)
 			if (upvalues[i])
 				upvalues[i]->Mark();
 	}
@@ -383,10 +509,10 @@ namespace RealSix::Script
 
 		if (!function->IsEqualTo(closure->function))
 			return false;
-		if (upvalues.size() != closure->upvalues.size())
+		if (GetUpValueCount() != closure->GetUpValueCount())
 			return false;
-		for (int32_t i = 0; i < upvalues.size(); ++i)
-			if (!upvalues[i]->IsEqualTo(closure->upvalues[i]))
+		for (int32_t i = 0; i < GetUpValueCount(); ++i)
+			if (!GetUpValues()[i]->IsEqualTo(closure->GetUpValues()[i]))
 				return false;
 		return true;
 	}
@@ -405,6 +531,10 @@ namespace RealSix::Script
 		: Object(ObjectKind::NATIVE_FUNCTION), fn(f)
 	{
 	}
+	NativeFunctionObject::NativeFunctionObject(NativeFunctionPtr f)
+		: Object(ObjectKind::NATIVE_FUNCTION), fnPtr(f)
+	{
+	}
 
 	String NativeFunctionObject::ToString() const
 	{
@@ -460,15 +590,20 @@ namespace RealSix::Script
 	String ClassObject::ToString() const
 	{
 		String result = "class " + name;
-		if (!parents.empty())
+		if (layout && !layout->parentNames.empty())
 		{
 			result += ":";
-			for (const auto &[k, v] : parents)
-				result += k + ",";
+			for (const auto &parentName : layout->parentNames)
+				result += parentName + ",";
 			result = result.SubStr(0, result.Size() - 1);
 		}
 		result += "\n{\n";
-		for (const auto &[k, v] : members)
+		if (layout)
+		{
+			for (auto slot : layout->declaredFieldSlots)
+				result += "  " + layout->slots[slot].name + ":" + fields[layout->slots[slot].index].ToString() + "\n";
+		}
+		for (const auto &[k, v] : overriddenMembers)
 			result += "  " + k + ":" + v.ToString() + "\n";
 
 		return result + "}\n";
@@ -477,16 +612,16 @@ namespace RealSix::Script
 	void ClassObject::Blacken()
 	{
 		Object::Blacken();
-		for (auto &[k, v] : members)
-			v.Mark();
-		for (auto &[k, v] : functions)
+		for (const auto &v : fields)
 			v.Mark();
-		for (auto &[k, v] : enums)
-			v.Mark();
-		for (auto &[k, v] : parents)
+		for (auto v : parents)
 			v->Mark();
 		for (auto &[k, v] : constructors)
 			v->Mark();
+		for (const auto &[k, v] : overriddenMembers)
+			v.Mark();
+		if (layout)
+			layout->Mark();
 	}
 
 	bool ClassObject::IsEqualTo(Object *other)
@@ -496,14 +631,14 @@ namespace RealSix::Script
 		auto klass = TO_CLASS_OBJ(other);
 		if (name != klass->name)
 			return false;
-		if (members != klass->members)
+		if (layout != klass->layout)
 			return false;
-		if (functions != klass->functions)
-			return false;
-		if (enums != klass->enums)
+		if (fields != klass->fields)
 			return false;
 		if (parents != klass->parents)
 			return false;
+		if (overriddenMembers != klass->overriddenMembers)
+			return false;
 		return true;
 	}
 
@@ -513,52 +648,252 @@ namespace RealSix::Script
 		return std::vector<uint8_t>();
 	}
 
-	bool ClassObject::GetMember(const String &name, Value &retV)
+	void ClassObject::Build(FunctionObject *function, const ClassBody &body)
 	{
+		auto isUsable = [&](const std::shared_ptr<ClassLayout> &candidate)
 		{
-			auto iter = members.find(name);
-			if (iter != members.end())
+			if (!candidate)
+				return false;
+			candidate->Bind(body);
+			return candidate->Matches(body);
+		};
+
+		if (isUsable(function->classLayout))
+			layout = function->classLayout;
+		else
+		{
+			if (!isUsable(function->runtimeClassLayout))
 			{
-				retV = iter->second;
-				return true;
+				function->runtimeClassLayout = ClassLayout::Create(body);
+				function->runtimeClassLayout->Bind(body);
 			}
+			layout = function->runtimeClassLayout;
 		}
+
+		parents.resize(layout->parentNames.size(), nullptr);
+		for (size_t pair = 0; pair < body.parentCount; ++pair)
+			parents[layout->pairParents[pair]] = TO_CLASS_VALUE(body.GetValue(pair));
+
+		// The shared values are taken again from every instance, the ones of an earlier instance may have been
+		// collected with it. Pairs of the same name write the same value, the one taken last wins like it did in a map
+		fields.resize(layout->fieldCount);
+		for (size_t pair = body.parentCount; pair < body.GetPairCount(); ++pair)
 		{
-			auto iter = functions.find(name);
-			if (iter != functions.end())
+			auto slot = layout->pairSlots[pair - body.parentCount];
+			if (slot == ClassLayout::NO_SLOT)
+				continue;
+
+			const auto &classSlot = layout->slots[slot];
+			auto &value = classSlot.kind == ClassLayout::SlotKind::FIELD ? fields[classSlot.index] : layout->values[classSlot.index];
+			value = body.GetValue(pair);
+			value.permission = pair < static_cast<size_t>(body.parentCount) + body.varCount ? Permission::MUTABLE : Permission::IMMUTABLE;
+		}
+	}
+
+	uint32_t ClassObject::FindSlot(const String &name) const
+	{
+		if (!layout)
+			return ClassLayout::NO_SLOT;
+		auto iter = layout->indices.find(name);
+		return iter == layout->indices.end() ? ClassLayout::NO_SLOT : iter->second;
+	}
+
+	bool ClassObject::GetMember(const String &name, Value &retV) const
+	{
+		auto slot = FindSlot(name);
+		if (slot == ClassLayout::NO_SLOT)
+			return false;
+		GetSlotMember(slot, retV);
+		return true;
+	}
+
+	bool ClassObject::GetParentMember(const String &name, Value &retV) const
+	{
+		for (size_t i = 0; i < parents.size(); ++i)
+		{
+			if (name == layout->parentNames[i])
+			{
+				retV = parents[i];
+				return true;
+			}
+			if (parents[i]->GetMember(name, retV))
 			{
-				retV = iter->second;
 				return true;
 			}
 		}
+
+		return false;
+	}
+
+	void ClassObject::SetSlotMember(uint32_t slot, const Value &value)
+	{
+		const auto &classSlot = layout->slots[slot];
+		if (classSlot.kind == ClassLayout::SlotKind::FIELD)
+			fields[classSlot.index] = value;
+		else // shared functions and enums are constants, only inherited members and parents get here
+			overriddenMembers[classSlot.name] = value;
+	}
+
+	std::shared_ptr<ClassLayout> ClassLayout::Create(std::vector<String> fieldNames, std::vector<String> functionNames, std::vector<String> enumNames,
+													 const std::vector<std::pair<String, std::shared_ptr<ClassLayout>>> &parents)
+	{
+		auto layout = std::make_shared<ClassLayout>();
+
+		auto addSlot = [&](const String &name, SlotKind kind, uint32_t index, uint32_t parentSlot)
+		{
+			if (layout->indices.emplace(name, static_cast<uint32_t>(layout->slots.size())).second)
+				layout->slots.emplace_back(Slot{name, kind, index, parentSlot});
+		};
+		auto addOwnSlots = [&](std::vector<String> &names, SlotKind kind, uint32_t &count)
 		{
-			auto iter = enums.find(name);
-			if (iter != enums.end())
+			std::sort(names.begin(), names.end());
+			for (const auto &name : names)
 			{
-				retV = iter->second;
-				return true;
+				if (!layout->indices.contains(name))
+					addSlot(name, kind, count++, 0);
 			}
+			return static_cast<uint32_t>(layout->slots.size());
+		};
+
+		uint32_t sharedCount = 0;
+		layout->fieldSlotEnd = addOwnSlots(fieldNames, SlotKind::FIELD, layout->fieldCount);
+		layout->functionSlotEnd = addOwnSlots(functionNames, SlotKind::SHARED, sharedCount);
+		layout->ownSlotEnd = addOwnSlots(enumNames, SlotKind::SHARED, sharedCount);
+		layout->values.resize(sharedCount);
+
+		for (const auto &[name, parentLayout] : parents)
+		{
+			// A parent listed twice is one parent, like in a map
+			if (!layout->parentNames.empty() && layout->parentNames.back() == name)
+				continue;
+
+			auto index = static_cast<uint32_t>(layout->parentNames.size());
+			layout->parentNames.emplace_back(name);
+			layout->parentLayouts.emplace_back(parentLayout);
+			addSlot(name, SlotKind::PARENT, index, 0);
+			for (uint32_t j = 0; j < parentLayout->slots.size(); ++j)
+				addSlot(parentLayout->slots[j].name, SlotKind::INHERITED, index, j);
 		}
-		return GetParentMember(name, retV);
+
+		return layout;
+	}
+
+	std::shared_ptr<ClassLayout> ClassLayout::Create(const ClassBody &body)
+	{
+		std::vector<String> fieldNames, functionNames, enumNames;
+		std::vector<std::pair<String, std::shared_ptr<ClassLayout>>> parents;
+
+		size_t pair = 0;
+		for (; pair < body.parentCount; ++pair)
+			parents.emplace_back(body.GetName(pair), TO_CLASS_VALUE(body.GetValue(pair))->layout);
+		for (size_t end = pair + body.varCount + body.constCount; pair < end; ++pair)
+			fieldNames.emplace_back(body.GetName(pair));
+		for (size_t end = pair + body.fnCount; pair < end; ++pair)
+			functionNames.emplace_back(body.GetName(pair));
+		for (; pair < body.GetPairCount(); ++pair)
+			enumNames.emplace_back(body.GetName(pair));
+
+		std::sort(parents.begin(), parents.end(), [](const auto &left, const auto &right)
+				  { return left.first < right.first; });
+
+		return Create(std::move(fieldNames), std::move(functionNames), std::move(enumNames), parents);
 	}
 
-	bool ClassObject::GetParentMember(const String &name, Value &retV)
+	void ClassLayout::Bind(const ClassBody &body)
 	{
+		if (isBound)
+			return;
+		isBound = true;
+		isComplete = true;
 
-		for (const auto &[k, v] : parents)
+		for (size_t pair = 0; pair < body.parentCount; ++pair)
 		{
-			if (name == k)
+			auto iter = std::lower_bound(parentNames.begin(), parentNames.end(), body.GetName(pair));
+			if (iter == parentNames.end() || *iter != body.GetName(pair))
 			{
-				retV = v;
-				return true;
+				pairParents.emplace_back(NO_SLOT);
+				isComplete = false;
 			}
-			if (v->GetMember(name, retV))
+			else
+				pairParents.emplace_back(static_cast<uint32_t>(iter - parentNames.begin()));
+		}
+
+		// A name taken by an earlier kind of member hides the pair, like GetMember did searching the kinds in turn
+		size_t pair = body.parentCount;
+		auto bindPairs = [&](size_t count, uint32_t slotBegin, uint32_t slotEnd)
+		{
+			for (size_t end = pair + count; pair < end; ++pair)
 			{
-				return true;
+				auto iter = indices.find(body.GetName(pair));
+				if (iter == indices.end())
+				{
+					pairSlots.emplace_back(NO_SLOT);
+					isComplete = false;
+				}
+				else
+					pairSlots.emplace_back(iter->second >= slotBegin && iter->second < slotEnd ? iter->second : NO_SLOT);
 			}
+		};
+		bindPairs(static_cast<size_t>(body.varCount) + body.constCount, 0, fieldSlotEnd);
+		auto functionPairBegin = pair;
+
+		// The class body pushes the constants and then the variables in declaration order
+		for (size_t i = functionPairBegin - body.parentCount; i > 0; --i)
+		{
+			auto slot = pairSlots[i - 1];
+			if (slot != NO_SLOT && std::find(declaredFieldSlots.begin(), declaredFieldSlots.end(), slot) == declaredFieldSlots.end())
+				declaredFieldSlots.emplace_back(slot);
 		}
 
-		return false;
+		bindPairs(body.fnCount, fieldSlotEnd, functionSlotEnd);
+		bindPairs(body.enumCount, functionSlotEnd, ownSlotEnd);
+
+		// A function capturing upvalues of an enclosing function is a new closure for every instance
+		for (pair = functionPairBegin; pair < functionPairBegin + body.fnCount; ++pair)
+		{
+			auto slot = pairSlots[pair - body.parentCount];
+			const auto &value = body.GetValue(pair);
+			if (slot != NO_SLOT && slots[slot].kind == SlotKind::SHARED && IS_CLOSURE_VALUE(value) && TO_CLOSURE_VALUE(value)->GetUpValueCount() > 0)
+			{
+				slots[slot].kind = SlotKind::FIELD;
+				slots[slot].index = fieldCount++;
+			}
+		}
+
+		// And every own slot and parent has a pair, a layout resolved at compile time may know names the class body does not have
+		std::vector<bool> isSlotPaired(ownSlotEnd, false), isParentPaired(parentNames.size(), false);
+		for (auto slot : pairSlots)
+		{
+			if (slot != NO_SLOT)
+				isSlotPaired[slot] = true;
+		}
+		for (auto parent : pairParents)
+		{
+			if (parent != NO_SLOT)
+				isParentPaired[parent] = true;
+		}
+		isComplete = isComplete && std::find(isSlotPaired.begin(), isSlotPaired.end(), false) == isSlotPaired.end() &&
+					 std::find(isParentPaired.begin(), isParentPaired.end(), false) == isParentPaired.end();
+	}
+
+	bool ClassLayout::Matches(const ClassBody &body) const
+	{
+		if (!isComplete)
+			return false;
+
+		// The member and parent names come from the class body, only the parent classes may differ
+		for (size_t pair = 0; pair < body.parentCount; ++pair)
+		{
+			if (TO_CLASS_VALUE(body.GetValue(pair))->layout != parentLayouts[pairParents[pair]])
+				return false;
+		}
+		return true;
+	}
+
+	void ClassLayout::Mark() const
+	{
+		for (const auto &v : values)
+			v.Mark();
 	}
 
 	ClassClosureBindObject::ClassClosureBindObject()
@@ -713,4 +1048,120 @@ namespace RealSix::Script
 		}
 		return false;
 	}
-}
\ No newline at end of file
+
+	// Components print like script float values so io.println shows the same digits for both
+	static String MathComponentToString(float component)
+	{
+		return Value(static_cast<double>(component)).ToString();
+	}
+
+	Vec3Object::Vec3Object(const Vector3f &value)
+		: Object(ObjectKind::VEC3), value(value)
+	{
+	}
+
+	String Vec3Object::ToString() const
+	{
+		return std::format("vec3({},{},{})", MathComponentToString(value.x), MathComponentToString(value.y), MathComponentToString(value.z));
+	}
+
+	bool Vec3Object::IsEqualTo(Object *other)
+	{
+		if (!IS_VEC3_OBJ(other))
+			return false;
+		return value == TO_VEC3_OBJ(other)->value;
+	}
+
+	std::vector<uint8_t> Vec3Object::Serialize() const
+	{
+		// TODO: Not finished yet, need to handle vec3 serialization
+		return std::vector<uint8_t>();
+	}
+
+	QuatObject::QuatObject(const Quaternionf &value)
+		: Object(ObjectKind::QUAT), value(value)
+	{
+	}
+
+	String QuatObject::ToString() const
+	{
+		return std::format("quat({},{},{},{})", MathComponentToString(value.x), MathComponentToString(value.y), MathComponentToString(value.z), MathComponentToString(value.w));
+	}
+
+	bool QuatObject::IsEqualTo(Object *other)
+	{
+		if (!IS_QUAT_OBJ(other))
+			return false;
+		return value == TO_QUAT_OBJ(other)->value;
+	}
+
+	std::vector<uint8_t> QuatObject::Serialize() const
+	{
+		// TODO: Not finished yet, need to handle quat serialization
+		return std::vector<uint8_t>();
+	}
+
+	Mat4Object::Mat4Object(const Matrix4f &value)
+		: Object(ObjectKind::MAT4), value(value)
+	{
+	}
+
+	String Mat4Object::ToString() const
+	{
+		// Row by row, the storage is column major
+		String result = "mat4(";
+		for (int32_t row = 0; row < 4; ++row)
+			result += std::format("{}[{},{},{},{}]", row == 0 ? "" : ",", MathComponentToString(value.elements[row]), MathComponentToString(value.elements[row + 4]), MathComponentToString(value.elements[row + 8]), MathComponentToString(value.elements[row + 12]));
+		return result + ")";
+	}
+
+	bool Mat4Object::IsEqualTo(Object *other)
+	{
+		if (!IS_MAT4_OBJ(other))
+			return false;
+		return value.elements == TO_MAT4_OBJ(other)->value.elements;
+	}
+
+	std::vector<uint8_t> Mat4Object::Serialize() const
+	{
+		// TODO: Not finished yet, need to handle mat4 serialization
+		return std::vector<uint8_t>();
+	}
+
+	FiberObject::FiberObject(ClosureObject *closure)
+		: Object(ObjectKind::FIBER), closure(closure)
+	{
+	}
+
+	String FiberObject::ToString() const
+	{
+		constexpr const char *statusNames[] = {"suspended", "running", "dead"};
+		return "<fiber " + closure->function->name + ":0x" + PointerAddressToString((void *)this) + " " + statusNames[static_cast<uint8_t>(status)] + ">";
+	}
+
+	void FiberObject::Blacken()
+	{
+		Object::Blacken();
+		closure->Mark();
+		for (const auto &value : stack)
+			value.Mark();
+		for (const auto &frame : frames)
+			frame.closure->Mark();
+		for (auto upValue = openUpValues; upValue != nullptr; upValue = upValue->nextUpValue)
+			upValue->Mark();
+		if (caller)
+			caller->Mark();
+		transfer.Mark();
+	}
+
+	bool FiberObject::IsEqualTo(Object *other)
+	{
+		return this == other;
+	}
+
+	std::vector<uint8_t> FiberObject::Serialize() const
+	{
+		// TODO: Not finished yet, need to handle fiber serialization
+		return std::vector<uint8_t>();
+	}
+}
@@ -4,9 +4,13 @@
 #include <vector>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include "Chunk.hpp"
 #include "Token.hpp"
 #include "Value.hpp"
+#include "ValueArray.hpp"
+#include "ValueDict.hpp"
+#include "Math/Matrix4.hpp"
 namespace RealSix::Script
 {
 #define IS_STR_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::STR)
@@ -22,6 +26,10 @@ namespace RealSix::Script
 #define IS_CLASS_CLOSURE_BIND_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::CLASS_CLOSURE_BIND)
 #define IS_ENUM_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::ENUM)
 #define IS_MODULE_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::MODULE)
+#define IS_VEC3_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::VEC3)
+#define IS_QUAT_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::QUAT)
+#define IS_MAT4_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::MAT4)
+#define IS_FIBER_OBJ(obj) ((obj)->kind == ::RealSix::Script::ObjectKind::FIBER)
 
 #define TO_STR_OBJ(obj) ((::RealSix::Script::StrObject *)(obj))
 #define TO_ARRAY_OBJ(obj) ((::RealSix::Script::ArrayObject *)(obj))
@@ -36,6 +44,10 @@ namespace RealSix::Script
 #define TO_CLASS_CLOSURE_BIND_OBJ(obj) ((::RealSix::Script::ClassClosureBindObject *)(obj))
 #define TO_ENUM_OBJ(obj) ((::RealSix::Script::EnumObject *)(obj))
 #define TO_MODULE_OBJ(obj) ((::RealSix::Script::ModuleObject *)(obj))
+#define TO_VEC3_OBJ(obj) ((::RealSix::Script::Vec3Object *)(obj))
+#define TO_QUAT_OBJ(obj) ((::RealSix::Script::QuatObject *)(obj))
+#define TO_MAT4_OBJ(obj) ((::RealSix::Script::Mat4Object *)(obj))
+#define TO_FIBER_OBJ(obj) ((::RealSix::Script::FiberObject *)(obj))
 
 #define IS_NULL_VALUE(v) ((v).kind == ::RealSix::Script::ValueKind::NIL)
 #define IS_INT_VALUE(v) ((v).kind == ::RealSix::Script::ValueKind::INT)
@@ -55,6 +67,10 @@ namespace RealSix::Script
 #define IS_CLASS_CLOSURE_BIND_VALUE(v) (IS_OBJECT_VALUE(v) && IS_CLASS_CLOSURE_BIND_OBJ((v).object))
 #define IS_ENUM_VALUE(v) (IS_OBJECT_VALUE(v) && IS_ENUM_OBJ((v).object))
 #define IS_MODULE_VALUE(v) (IS_OBJECT_VALUE(v) && IS_MODULE_OBJ((v).object))
+#define IS_VEC3_VALUE(v) (IS_OBJECT_VALUE(v) && IS_VEC3_OBJ((v).object))
+#define IS_QUAT_VALUE(v) (IS_OBJECT_VALUE(v) && IS_QUAT_OBJ((v).object))
+#define IS_MAT4_VALUE(v) (IS_OBJECT_VALUE(v) && IS_MAT4_OBJ((v).object))
+#define IS_FIBER_VALUE(v) (IS_OBJECT_VALUE(v) && IS_FIBER_OBJ((v).object))
 
 #define TO_INT_VALUE(v) ((v).integer)
 #define TO_FLOAT_VALUE(v) ((v).floating)
@@ -74,6 +90,10 @@ namespace RealSix::Script
 #define TO_CLASS_CLOSURE_BIND_VALUE(v) (TO_CLASS_CLOSURE_BIND_OBJ((v).object))
 #define TO_ENUM_VALUE(v) (TO_ENUM_OBJ((v).object))
 #define TO_MODULE_VALUE(v) (TO_MODULE_OBJ((v).object))
+#define TO_VEC3_VALUE(v) (TO_VEC3_OBJ((v).object))
+#define TO_QUAT_VALUE(v) (TO_QUAT_OBJ((v).object))
+#define TO_MAT4_VALUE(v) (TO_MAT4_OBJ((v).object))
+#define TO_FIBER_VALUE(v) (TO_FIBER_OBJ((v).object))
 
     enum REALSIX_API ObjectKind : uint8_t
     {
@@ -89,7 +109,11 @@ namespace RealSix::Script
         CLASS,
         CLASS_CLOSURE_BIND,
         ENUM,
-        MODULE
+        MODULE,
+        VEC3,
+        QUAT,
+        MAT4,
+        FIBER,
     };
 
     struct REALSIX_API Object
@@ -113,13 +137,42 @@ namespace RealSix::Script
     struct REALSIX_API StrObject : public Object
     {
         StrObject(StringView value);
+        StrObject(String &&value);
+        // Concatenation of left and right, long results stay a rope node until their content is needed
+        StrObject(StrObject *left, StrObject *right);
         ~StrObject() override = default;
 
         String ToString() const override;
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
-        String value{};
+        size_t Size() const;
+
+        // Flattens a rope node
+        const String &GetValue() const;
+        // For writing into this string, takes a private copy first if a rope still shares the content
+        String &GetMutableValue();
+
+    private:
+        // Immutable piece of a rope, concatenations share it instead of pointing at a StrObject a script can write into
+        struct RopeNode
+        {
+            ~RopeNode();
+
+            String value; // content of a leaf
+            std::shared_ptr<RopeNode> left;
+            std::shared_ptr<RopeNode> right;
+            size_t size{0};
+        };
+
+        // Results shorter than this are copied right away, a rope node costs more than the copy
+        static constexpr size_t ROPE_MIN_SIZE = 64;
+
+        const std::shared_ptr<RopeNode> &GetRopeNode() const;
+        void Flatten() const;
+
+        mutable String mValue{};
+        mutable std::shared_ptr<RopeNode> mNode; // set while the content is a rope or a leaf shared with ropes
     };
 
     struct REALSIX_API ArrayObject : public Object
@@ -133,13 +186,13 @@ namespace RealSix::Script
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
-        std::vector<struct Value> elements{};
+        ValueArray elements{};
     };
 
     struct REALSIX_API DictObject : public Object
     {
         DictObject();
-        DictObject(const ValueUnorderedMap &elements);
+        DictObject(const ValueDict &elements);
         ~DictObject() override = default;
 
         String ToString() const override;
@@ -147,7 +200,7 @@ namespace RealSix::Script
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
-        ValueUnorderedMap elements{};
+        ValueDict elements{};
     };
 
     struct REALSIX_API StructObject : public Object
@@ -164,6 +217,8 @@ namespace RealSix::Script
         std::unordered_map<String, Value> elements{};
     };
 
+    struct ClassLayout;
+
     struct REALSIX_API FunctionObject : public Object
     {
         FunctionObject();
@@ -184,13 +239,27 @@ namespace RealSix::Script
         std::unordered_map<size_t, std::vector<Value>> caches;
         // -- Function cache relative
 
+        // Never reused, unlike the address of a function the GC freed. The profiler keys its samples by it
+        const uint64_t id;
         String name{};
         uint8_t arity{0};
         VarArg varArg{VarArg::NONE};
-        int8_t upValueCount{0};
+        uint8_t upValueCount{0};
+        // Set by the compiler when a closure captures a local of this function by reference,
+        // returning from a frame of a function without it has no upvalues to close
+        bool hasCapturedLocals{false};
+        // ++ Class body relative
+        // Layout TypeCheckAndResolvePass resolved member slots against, set by the compiler.
+        // OP_GET_PROPERTY_SLOT only reads the slot of receivers with exactly this layout
+        std::shared_ptr<ClassLayout> classLayout{};
+        // Layout of the instances whose parents classLayout does not match, kept for the next one
+        std::shared_ptr<ClassLayout> runtimeClassLayout{};
+        // -- Class body relative
         Chunk chunk{};
     };
 
+    struct FiberObject;
+
     struct REALSIX_API UpValueObject : public Object
     {
         UpValueObject();
@@ -205,35 +274,72 @@ namespace RealSix::Script
         Value *location{nullptr};
         Value closed{};
         UpValueObject *nextUpValue{nullptr};
+        // The suspended fiber whose saved stack location points into, it has to outlive this upvalue
+        FiberObject *fiber{nullptr};
     };
 
+    // The upvalues are stored inline right behind the object, the array is sized from function->upValueCount
+    // when the closure is allocated so that creating a closure is a single allocation
     struct REALSIX_API ClosureObject : public Object
     {
-        ClosureObject();
         ClosureObject(FunctionObject *function);
         ~ClosureObject() override = default;
 
+        static void *operator new(size_t size, FunctionObject *function);
+        static void operator delete(void *ptr, FunctionObject *function);
+        static void operator delete(void *ptr);
+
         String ToString() const override;
         void Blacken() override;
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
+        inline UpValueObject **GetUpValues()
+        {
+            return reinterpret_cast<UpValueObject **>(this + 1);
+        }
+
+        inline uint8_t GetUpValueCount() const
+        {
+            return function->upValueCount;
+        }
+
         FunctionObject *function{nullptr};
-        std::vector<UpValueObject *> upvalues{};
     };
 
     using NativeFunction = std::function<bool(Value *, uint32_t, const Token *, Value &)>;
+    using NativeFunctionPtr = bool (*)(Value *, uint32_t, const Token *, Value &);
 
     struct REALSIX_API NativeFunctionObject : public Object
     {
         NativeFunctionObject();
         NativeFunctionObject(NativeFunction f);
+        // Fast path for captureless functions such as the thunks generated by Bind(), skips the std::function indirection
+        NativeFunctionObject(NativeFunctionPtr f);
+        // Captureless lambdas take the fast path too, anything else is stored as a NativeFunction
+        template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<bool, F, Value *, uint32_t, const Token *, Value &>>>
+        NativeFunctionObject(F &&f)
+            : Object(ObjectKind::NATIVE_FUNCTION)
+        {
+            if constexpr (std::is_convertible_v<F, NativeFunctionPtr>)
+                fnPtr = f;
+            else
+                fn = std::forward<F>(f);
+        }
         ~NativeFunctionObject() override = default;
 
         String ToString() const override;
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
+        inline bool Invoke(Value *args, uint32_t argCount, const Token *relatedToken, Value &result) const
+        {
+            if (fnPtr)
+                return fnPtr(args, argCount, relatedToken, result);
+            return fn(args, argCount, relatedToken, result);
+        }
+
+        NativeFunctionPtr fnPtr{nullptr};
         NativeFunction fn{};
     };
 
@@ -249,6 +355,91 @@ namespace RealSix::Script
         Value *pointer{nullptr};
     };
 
+    struct ClassObject;
+
+    // Operands of OP_CLASS. The parents and members lie below the stack top as name,value pairs in the order
+    // OP_CLASS takes them: the parents, then the member variables, constants, functions and enums
+    struct ClassBody
+    {
+        const Value *top{nullptr}; // one past the name of the first pair
+        uint8_t parentCount{0};
+        uint8_t varCount{0};
+        uint8_t constCount{0};
+        uint8_t fnCount{0};
+        uint8_t enumCount{0};
+
+        inline size_t GetPairCount() const
+        {
+            return static_cast<size_t>(parentCount) + varCount + constCount + fnCount + enumCount;
+        }
+        inline const String &GetName(size_t pair) const
+        {
+            return TO_STR_VALUE(top[-1 - 2 * static_cast<ptrdiff_t>(pair)])->GetValue();
+        }
+        inline const Value &GetValue(size_t pair) const
+        {
+            return top[-2 - 2 * static_cast<ptrdiff_t>(pair)];
+        }
+    };
+
+    // The member names of a class flattened with everything it inherits, one slot per name in the order
+    // GetMember searches: the own member variables and constants, functions and enums each sorted by name,
+    // then for each parent class in name order the parent itself followed by the slots of its layout that
+    // are not taken yet. One layout is shared by all instances of a class and holds the functions and enums
+    // that are the same for all of them, an instance only stores its own fields.
+    // TypeCheckAndResolvePass lays out the declared classes the same way to resolve slots at compile time
+    struct REALSIX_API ClassLayout
+    {
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+        enum class SlotKind : uint8_t
+        {
+            FIELD,     // ClassObject::fields[index]: member variables, constants and functions whose closure captures upvalues
+            SHARED,    // values[index]: the other functions and enums
+            PARENT,    // ClassObject::parents[index]
+            INHERITED, // slot parentSlot of ClassObject::parents[index]
+        };
+
+        struct Slot
+        {
+            String name;
+            SlotKind kind{SlotKind::FIELD};
+            uint32_t index{0};
+            uint32_t parentSlot{0};
+        };
+
+        // Names in any order, parents in name order
+        static std::shared_ptr<ClassLayout> Create(std::vector<String> fieldNames, std::vector<String> functionNames, std::vector<String> enumNames,
+                                                   const std::vector<std::pair<String, std::shared_ptr<ClassLayout>>> &parents);
+        static std::shared_ptr<ClassLayout> Create(const ClassBody &body);
+
+        // Maps the pairs of the class body onto the slots, once for the first instance. The names are the same
+        // for every instance of the class body
+        void Bind(const ClassBody &body);
+        // Whether an instance of the bound class body with these parent classes can use this layout
+        bool Matches(const ClassBody &body) const;
+
+        void Mark() const;
+
+        std::vector<Slot> slots;
+        std::unordered_map<String, uint32_t> indices;
+        std::vector<String> parentNames;
+        std::vector<std::shared_ptr<ClassLayout>> parentLayouts;
+        std::vector<Value> values;
+        uint32_t fieldCount{0};
+        // The own slots are the variables and constants up to fieldSlotEnd, then the functions up to functionSlotEnd, then the enums
+        uint32_t fieldSlotEnd{0};
+        uint32_t functionSlotEnd{0};
+        uint32_t ownSlotEnd{0};
+
+        // Filled by Bind, the slot of every member pair and the index of every parent pair of the class body
+        std::vector<uint32_t> pairSlots;
+        std::vector<uint32_t> pairParents;
+        std::vector<uint32_t> declaredFieldSlots; // the own variables and constants in declaration order
+        bool isBound{false};
+        bool isComplete{false}; // every member name of the class body has a slot
+    };
+
     struct REALSIX_API ClassObject : public Object
     {
         ClassObject();
@@ -260,15 +451,51 @@ namespace RealSix::Script
         bool IsEqualTo(Object *other) override;
         std::vector<uint8_t> Serialize() const override;
 
-        bool GetMember(const String &name, Value &retV);
-        bool GetParentMember(const String &name, Value &retV);
+        // Fills the instance from the class body popped by OP_CLASS, with the layout the compiler resolved
+        // slots against when the parents match it
+        void Build(FunctionObject *function, const ClassBody &body);
+
+        uint32_t FindSlot(const String &name) const;
+        bool GetMember(const String &name, Value &retV) const;
+        bool GetParentMember(const String &name, Value &retV) const;
+        void SetSlotMember(uint32_t slot, const Value &value);
+
+        inline void GetSlotMember(uint32_t slot, Value &retV) const
+        {
+            const auto &classSlot = layout->slots[slot];
+            switch (classSlot.kind)
+            {
+            case ClassLayout::SlotKind::FIELD:
+                retV = fields[classSlot.index];
+                break;
+            case ClassLayout::SlotKind::SHARED:
+                retV = layout->values[classSlot.index];
+                break;
+            default:
+                if (!overriddenMembers.empty())
+                {
+                    auto iter = overriddenMembers.find(classSlot.name);
+                    if (iter != overriddenMembers.end())
+                    {
+                        retV = iter->second;
+                        break;
+                    }
+                }
+                if (classSlot.kind == ClassLayout::SlotKind::PARENT)
+                    retV = parents[classSlot.index];
+                else
+                    parents[classSlot.index]->GetSlotMember(classSlot.parentSlot, retV);
+                break;
+            }
+        }
 
         String name{};
         std::map<int32_t, ClosureObject *> constructors{}; // argument count as key for now
-        std::unordered_map<String, Value> members{};
-        std::unordered_map<String, Value> functions{};
-        std::unordered_map<String, Value> enums{};
-        std::map<String, ClassObject *> parents{};
+        std::shared_ptr<ClassLayout> layout{};
+        std::vector<Value> fields{};
+        std::vector<ClassObject *> parents{}; // in the order of layout->parentNames
+        // Inherited members and parents assigned through this instance, they hide the ones of the parent from then on
+        std::unordered_map<String, Value> overriddenMembers{};
     };
 
     struct REALSIX_API ClassClosureBindObject : public Object
@@ -319,4 +546,91 @@ namespace RealSix::Script
         String name{};
         std::unordered_map<String, Value> members{};
     };
+
+    // Engine math values. They are immutable, every operation creates a new object, so sharing one between
+    // variables behaves like a copy. The payload is the Math/ type itself and operators call straight into it.
+    struct REALSIX_API Vec3Object : public Object
+    {
+        Vec3Object(const Vector3f &value);
+        ~Vec3Object() override = default;
+
+        String ToString() const override;
+        bool IsEqualTo(Object *other) override;
+        std::vector<uint8_t> Serialize() const override;
+
+        const Vector3f value;
+    };
+
+    struct REALSIX_API QuatObject : public Object
+    {
+        QuatObject(const Quaternionf &value);
+        ~QuatObject() override = default;
+
+        String ToString() const override;
+        bool IsEqualTo(Object *other) override;
+        std::vector<uint8_t> Serialize() const override;
+
+        const Quaternionf value;
+    };
+
+    struct REALSIX_API Mat4Object : public Object
+    {
+        Mat4Object(const Matrix4f &value);
+        ~Mat4Object() override = default;
+
+        String ToString() const override;
+        bool IsEqualTo(Object *other) override;
+        std::vector<uint8_t> Serialize() const override;
+
+        const Matrix4f value;
+    };
+
+    enum class FiberStatus : uint8_t
+    {
+        SUSPENDED, // not started yet or stopped at a yield
+        RUNNING,
+        DEAD, // its function returned
+    };
+
+    // A coroutine running a closure on its own value and call frame stack.
+    // While it runs its frames sit on top of the VM stacks like those of a normal call. A yield moves them out
+    // into stack and frames, trimmed to what the fiber actually used, so a suspended fiber costs the object
+    // plus its live slots. Resuming copies them back on top of the VM stacks of whoever resumes it.
+    struct REALSIX_API FiberObject : public Object
+    {
+        // A call frame with its slots stored as an offset into stack
+        struct Frame
+        {
+            ClosureObject *closure{nullptr};
+            const uint8_t *ip{nullptr};
+            size_t slotOffset{0};
+            size_t argumentsHash{0};
+        };
+
+        FiberObject(ClosureObject *closure);
+        ~FiberObject() override = default;
+
+        String ToString() const override;
+        void Blacken() override;
+        bool IsEqualTo(Object *other) override;
+        std::vector<uint8_t> Serialize() const override;
+
+        ClosureObject *closure{nullptr};
+        FiberStatus status{FiberStatus::SUSPENDED};
+
+        // Saved state while suspended
+        std::vector<Value> stack;
+        std::vector<Frame> frames;
+        // Upvalues capturing slots of stack, ordered like the open upvalue list of the allocator
+        UpValueObject *openUpValues{nullptr};
+
+        // Position on the VM stacks while running
+        Value *stackBottom{nullptr};
+        size_t callFrameBottom{0};
+        // The fiber running when this one was resumed
+        FiberObject *caller{nullptr};
+
+        // The value passed out by the last yield
+        Value transfer{};
+    };
 }
\ No newline at end of file
@@ -94,6 +94,8 @@ namespace RealSix::Script
 			{TokenKind::PLUS_PLUS, &Parser::ParsePrefixExpr},
 			{TokenKind::MINUS_MINUS, &Parser::ParsePrefixExpr},
 			{TokenKind::NEW, &Parser::ParseNewExpr},
+			{TokenKind::YIELD, &Parser::ParseYieldExpr},
+			{TokenKind::RESUME, &Parser::ParseResumeExpr},
 			{TokenKind::THIS, &Parser::ParseThisExpr},
 			{TokenKind::BASE, &Parser::ParseBaseExpr},
 			{TokenKind::MATCH, &Parser::ParseMatchExpr},
@@ -762,6 +764,30 @@ namespace RealSix::Script
 		return newExpr;
 	}
 
+	Expr *Parser::ParseYieldExpr()
+	{
+		auto token = Consume(TokenKind::YIELD, "Expect 'yield' keyword");
+		auto yieldExpr = new YieldExpr(token);
+
+		// A bare 'yield' suspends with null
+		if (!IsMatchCurToken(TokenKind::SEMICOLON) && !IsMatchCurToken(TokenKind::RPAREN) && !IsMatchCurToken(TokenKind::RBRACKET) && !IsMatchCurToken(TokenKind::RBRACE) && !IsMatchCurToken(TokenKind::COMMA))
+			yieldExpr->expr = ParseExpr(Precedence::ASSIGN);
+		return yieldExpr;
+	}
+
+	Expr *Parser::ParseResumeExpr()
+	{
+		auto token = Consume(TokenKind::RESUME, "Expect 'resume' keyword");
+		auto resumeExpr = new ResumeExpr(token);
+
+		Consume(TokenKind::LPAREN, "Expect '(' after 'resume' keyword");
+		resumeExpr->fiber = ParseExpr(Precedence::ASSIGN);
+		if (IsMatchCurTokenAndStepOnce(TokenKind::COMMA))
+			resumeExpr->value = ParseExpr(Precedence::ASSIGN);
+		Consume(TokenKind::RPAREN, "Expect ')' after resume expr's fiber and value");
+		return resumeExpr;
+	}
+
 	Expr *Parser::ParseThisExpr()
 	{
 		auto token = Consume(TokenKind::THIS, "Expect 'this' keyword");
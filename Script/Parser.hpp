@@ -90,6 +90,8 @@ namespace RealSix::Script
 		Expr *ParseRefExpr();
 		Expr *ParseLambdaExpr();
 		Expr *ParseNewExpr();
+		Expr *ParseYieldExpr();
+		Expr *ParseResumeExpr();
 		Expr *ParseThisExpr();
 		Expr *ParseBaseExpr();
 		Expr *ParseMatchExpr();
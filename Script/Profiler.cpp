@@ -0,0 +1,143 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <format>
+#include "Resource/FileSystem.hpp"
+#include "Allocator.hpp"
+#include "Object.hpp"
+namespace RealSix::Script
+{
+	void Profiler::Start(uint32_t sampleInterval)
+	{
+		mSampleInterval = std::max<uint32_t>(sampleInterval, 1);
+		mIsRunning = true;
+		if (mNodes.empty())
+			mNodes.emplace_back();
+	}
+
+	void Profiler::Stop()
+	{
+		mIsRunning = false;
+	}
+
+	void Profiler::Reset()
+	{
+		mSampleCount = 0;
+		std::vector<CallTreeNode>().swap(mNodes);
+		if (mIsRunning)
+			mNodes.emplace_back();
+	}
+
+	bool Profiler::IsRunning() const
+	{
+		return mIsRunning;
+	}
+
+	uint32_t Profiler::GetSampleInterval() const
+	{
+		return mSampleInterval;
+	}
+
+	uint64_t Profiler::GetSampleCount() const
+	{
+		return mSampleCount;
+	}
+
+	void Profiler::Sample()
+	{
+		if (IS_CALL_FRAME_STACK_EMPTY())
+			return;
+
+		mSampleCount++;
+
+		// Walk from the outermost frame to the innermost one
+		uint32_t nodeIdx = 0;
+		for (int32_t dist = static_cast<int32_t>(CALL_FRAME_COUNT()) - 1; dist >= 0; --dist)
+		{
+			nodeIdx = FindOrAddChild(nodeIdx, PEEK_CALL_FRAME(dist)->closure->function);
+			mNodes[nodeIdx].totalSampleCount++;
+		}
+
+		CallFrame *frame = PEEK_CALL_FRAME(0);
+		auto ip = static_cast<uint32_t>(frame->ip - frame->closure->function->chunk.GetOpCodes());
+		mNodes[nodeIdx].selfSampleCount++;
+		mNodes[nodeIdx].ipSampleCounts[ip]++;
+	}
+
+	String Profiler::ToCollapsedStacks() const
+	{
+		String result;
+		if (mNodes.empty())
+			return result;
+
+		for (auto child : mNodes[0].children)
+			CollapseNode(child, "", result);
+		return result;
+	}
+
+	void Profiler::ExportCollapsedStacks(StringView path) const
+	{
+		FileSystem::WriteBinaryFile(path, ToCollapsedStacks());
+	}
+
+	String Profiler::ToReport(size_t maxFunctionCount) const
+	{
+		struct FunctionSamples
+		{
+			String name;
+			uint64_t selfSampleCount{0};
+			std::unordered_map<uint32_t, uint64_t> ipSampleCounts;
+		};
+
+		// The same function shows up once per call path, merge them
+		std::unordered_map<uint64_t, FunctionSamples> functions;
+		for (size_t i = 1; i < mNodes.size(); ++i)
+		{
+			auto &samples = functions[mNodes[i].functionId];
+			samples.name = mNodes[i].name;
+			samples.selfSampleCount += mNodes[i].selfSampleCount;
+			for (const auto &[ip, count] : mNodes[i].ipSampleCounts)
+				samples.ipSampleCounts[ip] += count;
+		}
+
+		std::vector<const FunctionSamples *> sorted;
+		for (const auto &[k, v] : functions)
+			if (v.selfSampleCount > 0)
+				sorted.emplace_back(&v);
+		std::sort(sorted.begin(), sorted.end(), [](const FunctionSamples *left, const FunctionSamples *right)
+				  { return left->selfSampleCount > right->selfSampleCount; });
+
+		String result = std::format("{} samples, 1 per {} instructions\n", mSampleCount, mSampleInterval);
+		for (size_t i = 0; i < std::min(sorted.size(), maxFunctionCount); ++i)
+		{
+			auto hottest = std::max_element(sorted[i]->ipSampleCounts.begin(), sorted[i]->ipSampleCounts.end(), [](const auto &left, const auto &right)
+											{ return left.second < right.second; });
+			double percent = mSampleCount > 0 ? 100.0 * sorted[i]->selfSampleCount / mSampleCount : 0.0;
+			result += std::format("{:>6.2f}%    {:>10}    {}    hottest ip {}\n", percent, sorted[i]->selfSampleCount, sorted[i]->name, hottest->first);
+		}
+		return result;
+	}
+
+	uint32_t Profiler::FindOrAddChild(uint32_t parent, const FunctionObject *function)
+	{
+		for (auto child : mNodes[parent].children)
+			if (mNodes[child].functionId == function->id)
+				return child;
+
+		auto nodeIdx = static_cast<uint32_t>(mNodes.size());
+		CallTreeNode &node = mNodes.emplace_back();
+		node.functionId = function->id;
+		node.name = function->name.Empty() ? String("<lambda>") : function->name;
+		mNodes[parent].children.emplace_back(nodeIdx);
+		return nodeIdx;
+	}
+
+	void Profiler::CollapseNode(uint32_t nodeIdx, const String &prefix, String &result) const
+	{
+		const CallTreeNode &node = mNodes[nodeIdx];
+		String path = prefix.Empty() ? node.name : prefix + ";" + node.name;
+		if (node.selfSampleCount > 0)
+			result += path + " " + std::to_string(node.selfSampleCount) + "\n";
+		for (auto child : node.children)
+			CollapseNode(child, path, result);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include "Core/Marco.hpp"
+#include "Core/Common.hpp"
+#include "Core/String.hpp"
+namespace RealSix::Script
+{
+    struct FunctionObject;
+
+    // Sampling profiler for script execution.
+    // VM::Execute calls Sample() every sample interval instructions while the profiler is running,
+    // each sample walks the active call frames and is aggregated into a call tree keyed by function.
+    class REALSIX_API Profiler : public Singleton<Profiler>
+    {
+    public:
+        void Start(uint32_t sampleInterval);
+        void Stop();
+        void Reset();
+
+        bool IsRunning() const;
+        uint32_t GetSampleInterval() const;
+        uint64_t GetSampleCount() const;
+
+        void Sample();
+
+        // One "caller;callee;... selfSampleCount" line per call path, the input format of flamegraph tools
+        String ToCollapsedStacks() const;
+        void ExportCollapsedStacks(StringView path) const;
+
+        // Functions sorted by self samples together with their hottest instruction offset
+        String ToReport(size_t maxFunctionCount = 10) const;
+
+    private:
+        struct CallTreeNode
+        {
+            uint64_t functionId{0}; // FunctionObject::id, the GC may reuse the address of a freed function
+            String name;
+            uint64_t selfSampleCount{0};
+            uint64_t totalSampleCount{0};
+            std::unordered_map<uint32_t, uint64_t> ipSampleCounts; // self samples per instruction offset
+            std::vector<uint32_t> children;                        // indices into mNodes
+        };
+
+        uint32_t FindOrAddChild(uint32_t parent, const FunctionObject *function);
+        void CollapseNode(uint32_t nodeIdx, const String &prefix, String &result) const;
+
+        bool mIsRunning{false};
+        uint32_t mSampleInterval{0};
+        uint64_t mSampleCount{0};
+        std::vector<CallTreeNode> mNodes; // mNodes[0] is the root of every call path
+    };
+}
@@ -103,6 +103,8 @@ namespace RealSix::Script
 		VOID,				   // void
 		AS,					   // as
 		NEW,				   // new
+		YIELD,				   // yield
+		RESUME,				   // resume
 		END,
 	};
 
@@ -1,5 +1,6 @@
 #include "TypeCheckAndResolvePass.hpp"
 #include "Logger.hpp"
+#include "Object.hpp"
 namespace RealSix::Script
 {
     struct TypeInfo
@@ -34,9 +35,22 @@ namespace RealSix::Script
         {
             mTypeInfos[name] = result;
         }
+        // Updates the type of an assigned variable in the table defining it
+        void Assign(StringView name, const Type &type)
+        {
+            auto iter = mTypeInfos.find(name);
+            if (iter != mTypeInfos.end())
+                iter->second.type = type;
+            else if (mEnclosing)
+                mEnclosing->Assign(name, type);
+        }
+        TypeInfoTable *GetEnclosing() const
+        {
+            return mEnclosing;
+        }
 
     private:
-        TypeInfoTable *mEnclosing;
+        TypeInfoTable *mEnclosing{nullptr};
         std::unordered_map<StringView, TypeInfo> mTypeInfos;
     };
 
@@ -170,6 +184,8 @@ namespace RealSix::Script
 
     TypeCheckAndResolvePass::~TypeCheckAndResolvePass() noexcept
     {
+        while (mTypeInfoTable->GetEnclosing())
+            ExitTypeScope();
         SAFE_DELETE(mTypeInfoTable);
     }
 
@@ -184,6 +200,8 @@ namespace RealSix::Script
     {
         for (auto &[k, v] : decl->variables)
         {
+            v = ExecuteExpr(v);
+
             if (k->kind == AstKind::ARRAY)
             {
             }
@@ -195,11 +213,9 @@ namespace RealSix::Script
                 if (leftType.Is(TypeKind::UNDEFINED))
                 {
                     leftType = v->type;
-                    return decl;
                 }
                 else if (leftType.Is(TypeKind::ANY))
                 {
-                    return decl;
                 }
                 else if (leftType.IsPrimitiveType() && rightType.IsPrimitiveType())
                 {
@@ -208,6 +224,15 @@ namespace RealSix::Script
                         Log(info->logKind, k->tagToken, info->msg);
                     }
                 }
+
+                auto name = ((VarDescExpr *)k)->name;
+                if (name->kind == AstKind::IDENTIFIER)
+                {
+                    TypeInfo info;
+                    info.type = leftType;
+                    info.permission = decl->permission;
+                    mTypeInfoTable->Define(((IdentifierExpr *)name)->literal, info);
+                }
             }
         }
 
@@ -220,18 +245,32 @@ namespace RealSix::Script
     }
     Stmt *TypeCheckAndResolvePass::ExecuteReturnStmt(ReturnStmt *stmt)
     {
+        if (stmt->expr)
+            stmt->expr = ExecuteExpr(stmt->expr);
         return stmt;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteIfStmt(IfStmt *stmt)
     {
+        stmt->condition = ExecuteExpr(stmt->condition);
+        stmt->thenBranch = ExecuteStmt(stmt->thenBranch);
+        if (stmt->elseBranch)
+            stmt->elseBranch = ExecuteStmt(stmt->elseBranch);
         return stmt;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteScopeStmt(ScopeStmt *stmt)
     {
+        EnterTypeScope();
+        for (auto &s : stmt->stmts)
+            s = ExecuteStmt(s);
+        ExitTypeScope();
         return stmt;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteWhileStmt(WhileStmt *stmt)
     {
+        stmt->condition = ExecuteExpr(stmt->condition);
+        stmt->body = (ScopeStmt *)ExecuteScopeStmt(stmt->body);
+        if (stmt->increment)
+            stmt->increment = (ScopeStmt *)ExecuteScopeStmt(stmt->increment);
         return stmt;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteEnumDecl(EnumDecl *decl)
@@ -240,10 +279,70 @@ namespace RealSix::Script
     }
     Stmt *TypeCheckAndResolvePass::ExecuteFunctionDecl(FunctionDecl *decl)
     {
+        EnterTypeScope();
+        decl->body = (ScopeStmt *)ExecuteScopeStmt(decl->body);
+        ExitTypeScope();
         return decl;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteClassDecl(ClassDecl *decl)
     {
+        // Lay out the class like OP_CLASS does, a class with a parent or member that cannot be laid out is left unresolved
+        bool isResolvable = true;
+        std::vector<String> fieldNames, functionNames, enumNames;
+        auto appendVarNames = [&](const std::vector<std::pair<ClassDecl::MemberPrivilege, VarDecl *>> &varDecls)
+        {
+            for (const auto &[privilege, varDecl] : varDecls)
+            {
+                for (const auto &[k, v] : varDecl->variables)
+                {
+                    if (k->kind == AstKind::VAR_DESC && ((VarDescExpr *)k)->name->kind == AstKind::IDENTIFIER)
+                        fieldNames.emplace_back(((IdentifierExpr *)((VarDescExpr *)k)->name)->literal);
+                    else
+                        isResolvable = false;
+                }
+            }
+        };
+        appendVarNames(decl->variables);
+        appendVarNames(decl->constants);
+        for (const auto &[privilege, function] : decl->functions)
+        {
+            if (function.kind == ClassDecl::FunctionKind::MEMBER)
+                functionNames.emplace_back(function.decl->name->literal);
+        }
+        for (const auto &[privilege, enumDecl] : decl->enumerations)
+            enumNames.emplace_back(enumDecl->name->literal);
+
+        std::vector<std::pair<String, std::shared_ptr<ClassLayout>>> parentLayouts;
+        for (const auto &[privilege, parent] : decl->parents)
+        {
+            auto iter = mClassLayouts.find(parent->literal);
+            if (iter == mClassLayouts.end())
+                isResolvable = false;
+            else
+                parentLayouts.emplace_back(parent->literal, iter->second);
+        }
+        std::sort(parentLayouts.begin(), parentLayouts.end(), [](const auto &left, const auto &right)
+                  { return left.first < right.first; });
+
+        if (isResolvable)
+        {
+            decl->layout = ClassLayout::Create(std::move(fieldNames), std::move(functionNames), std::move(enumNames), parentLayouts);
+            mClassLayouts[decl->name] = decl->layout;
+        }
+        else
+            mClassLayouts.erase(decl->name);
+
+        auto prevClassName = mCurClassName;
+        mCurClassName = decl->name;
+
+        for (auto &varStmt : decl->variables)
+            varStmt.second = (VarDecl *)ExecuteVarDecl(varStmt.second);
+        for (auto &varStmt : decl->constants)
+            varStmt.second = (VarDecl *)ExecuteVarDecl(varStmt.second);
+        for (auto &fnStmt : decl->functions)
+            fnStmt.second.decl = (FunctionDecl *)ExecuteFunctionDecl(fnStmt.second.decl);
+
+        mCurClassName = prevClassName;
         return decl;
     }
     Stmt *TypeCheckAndResolvePass::ExecuteBreakStmt(BreakStmt *stmt)
@@ -264,26 +363,40 @@ namespace RealSix::Script
     }
     Expr *TypeCheckAndResolvePass::ExecuteInfixExpr(InfixExpr *expr)
     {
+        expr->left = ExecuteExpr(expr->left);
+        expr->right = ExecuteExpr(expr->right);
+
+        if (expr->op == "=" && expr->left->kind == AstKind::IDENTIFIER)
+            mTypeInfoTable->Assign(((IdentifierExpr *)expr->left)->literal, expr->right->type);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecutePrefixExpr(PrefixExpr *expr)
     {
+        expr->right = ExecuteExpr(expr->right);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecutePostfixExpr(PostfixExpr *expr)
     {
+        expr->left = ExecuteExpr(expr->left);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteConditionExpr(ConditionExpr *expr)
     {
+        expr->condition = ExecuteExpr(expr->condition);
+        expr->trueBranch = ExecuteExpr(expr->trueBranch);
+        expr->falseBranch = ExecuteExpr(expr->falseBranch);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteGroupExpr(GroupExpr *expr)
     {
+        expr->expr = ExecuteExpr(expr->expr);
+        expr->type = expr->expr->type;
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteArrayExpr(ArrayExpr *expr)
     {
+        for (auto &e : expr->elements)
+            e = ExecuteExpr(e);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteAppregateExpr(AppregateExpr *expr)
@@ -292,14 +405,32 @@ namespace RealSix::Script
     }
     Expr *TypeCheckAndResolvePass::ExecuteDictExpr(DictExpr *expr)
     {
+        for (auto &[k, v] : expr->elements)
+        {
+            k = ExecuteExpr(k);
+            v = ExecuteExpr(v);
+        }
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteIndexExpr(IndexExpr *expr)
     {
+        expr->ds = ExecuteExpr(expr->ds);
+        expr->index = ExecuteExpr(expr->index);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteNewExpr(NewExpr *expr)
     {
+        auto callee = (CallExpr *)expr->callee;
+        for (auto &arg : callee->arguments)
+            arg = ExecuteExpr(arg);
+
+        if (callee->callee->kind == AstKind::IDENTIFIER)
+        {
+            // Type keeps a view of its name, refer to the literal owned by the ast
+            const auto &className = ((IdentifierExpr *)callee->callee)->literal;
+            if (mClassLayouts.contains(className))
+                expr->type = Type(TypeKind::CLASS, className, expr->tagToken->sourceLocation);
+        }
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteThisExpr(ThisExpr *expr)
@@ -312,22 +443,38 @@ namespace RealSix::Script
     }
     Expr *TypeCheckAndResolvePass::ExecuteIdentifierExpr(IdentifierExpr *expr)
     {
+        TypeInfo info;
+        if (mTypeInfoTable->Find(expr->literal, info))
+            expr->type = info.type;
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteLambdaExpr(LambdaExpr *expr)
     {
+        EnterTypeScope();
+        expr->body = (ScopeStmt *)ExecuteScopeStmt(expr->body);
+        ExitTypeScope();
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteCompoundExpr(CompoundExpr *expr)
     {
+        EnterTypeScope();
+        for (auto &s : expr->stmts)
+            s = ExecuteStmt(s);
+        expr->endExpr = ExecuteExpr(expr->endExpr);
+        ExitTypeScope();
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteCallExpr(CallExpr *expr)
     {
+        expr->callee = ExecuteExpr(expr->callee);
+        for (auto &arg : expr->arguments)
+            arg = ExecuteExpr(arg);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteDotExpr(DotExpr *expr)
     {
+        expr->callee = ExecuteExpr(expr->callee);
+        ResolveMemberSlot(expr);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteRefExpr(RefExpr *expr)
@@ -336,6 +483,8 @@ namespace RealSix::Script
     }
     Expr *TypeCheckAndResolvePass::ExecuteStructExpr(StructExpr *expr)
     {
+        for (auto &[k, v] : expr->elements)
+            v = ExecuteExpr(v);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteVarArgExpr(VarArgExpr *expr)
@@ -344,10 +493,55 @@ namespace RealSix::Script
     }
     Expr *TypeCheckAndResolvePass::ExecuteFactorialExpr(FactorialExpr *expr)
     {
+        expr->expr = ExecuteExpr(expr->expr);
         return expr;
     }
     Expr *TypeCheckAndResolvePass::ExecuteVarDescExpr(VarDescExpr *expr)
     {
         return expr;
     }
-}
\ No newline at end of file
+    Expr *TypeCheckAndResolvePass::ExecuteYieldExpr(YieldExpr *expr)
+    {
+        if (expr->expr)
+            expr->expr = ExecuteExpr(expr->expr);
+        return expr;
+    }
+    Expr *TypeCheckAndResolvePass::ExecuteResumeExpr(ResumeExpr *expr)
+    {
+        expr->fiber = ExecuteExpr(expr->fiber);
+        if (expr->value)
+            expr->value = ExecuteExpr(expr->value);
+        return expr;
+    }
+
+    void TypeCheckAndResolvePass::EnterTypeScope()
+    {
+        mTypeInfoTable = new TypeInfoTable(mTypeInfoTable);
+    }
+    void TypeCheckAndResolvePass::ExitTypeScope()
+    {
+        auto enclosing = mTypeInfoTable->GetEnclosing();
+        SAFE_DELETE(mTypeInfoTable);
+        mTypeInfoTable = enclosing;
+    }
+
+    void TypeCheckAndResolvePass::ResolveMemberSlot(DotExpr *expr)
+    {
+        String className;
+        if (expr->callee->kind == AstKind::THIS)
+            className = mCurClassName;
+        else if (expr->callee->type.Is(TypeKind::CLASS))
+            className = String(expr->callee->type.GetName());
+
+        auto layoutIter = mClassLayouts.find(className);
+        if (layoutIter == mClassLayouts.end())
+            return;
+
+        auto slotIter = layoutIter->second->indices.find(expr->callMember->literal);
+        if (slotIter != layoutIter->second->indices.end())
+        {
+            expr->memberLayout = layoutIter->second.get();
+            expr->memberSlot = static_cast<int32_t>(slotIter->second);
+        }
+    }
+}
@@ -1,8 +1,11 @@
 #pragma once
+#include <memory>
+#include <unordered_map>
 #include "AstPass.hpp"
 namespace RealSix::Script
 {
     class TypeInfoTable;
+    struct ClassLayout;
     class REALSIX_API TypeCheckAndResolvePass : public AstPass
     {
     public:
@@ -49,8 +52,19 @@ namespace RealSix::Script
         virtual Expr *ExecuteVarArgExpr(VarArgExpr *expr) override;
         virtual Expr *ExecuteFactorialExpr(FactorialExpr *expr) override;
         virtual Expr *ExecuteVarDescExpr(VarDescExpr *expr) override;
+        virtual Expr *ExecuteYieldExpr(YieldExpr *expr) override;
+        virtual Expr *ExecuteResumeExpr(ResumeExpr *expr) override;
 
     private:
+        void EnterTypeScope();
+        void ExitTypeScope();
+
+        // Resolves the slot of a member read from a receiver whose class is known at compile time,
+        // the VM checks the slot against the layout of the actual receiver before using it
+        void ResolveMemberSlot(DotExpr *expr);
+
         TypeInfoTable* mTypeInfoTable{nullptr};
+        std::unordered_map<String, std::shared_ptr<ClassLayout>> mClassLayouts;
+        String mCurClassName;
     };
 }
\ No newline at end of file
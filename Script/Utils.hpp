@@ -7,7 +7,7 @@
 #include "Core/Marco.hpp"
 
 #define STACK_MAX 1024
-#define VARIABLE_MAX 512
+#define VARIABLE_MAX (UINT16_MAX + 1) // globals and statics are addressed by a 16 bit slot operand
 
 #define UINT8_COUNT (UINT8_MAX + 1)
 
@@ -5,6 +5,8 @@
 #include "Object.hpp"
 #include "Token.hpp"
 #include "Logger.hpp"
+#include "Profiler.hpp"
+#include "Instrument.hpp"
 
 namespace RealSix::Script
 {
@@ -12,7 +14,7 @@ namespace RealSix::Script
 #define OUTPUT_OPCODE_LOCATION()                                                                                                                                                                    \
 	do                                                                                                                                                                                              \
 	{                                                                                                                                                                                               \
-		REALSIX_LOG_INFO("<fn {}:0x{}>, ip: {}", frame->closure->function->name, PointerAddressToString(frame->closure->function), frame->ip - 2 - frame->closure->function->chunk.opCodes.data()); \
+		REALSIX_LOG_INFO("<fn {}:0x{}>, ip: {}", frame->closure->function->name, PointerAddressToString(frame->closure->function), frame->ip - 2 - frame->closure->function->chunk.GetOpCodes()); \
 	} while (false)
 #else
 #define OUTPUT_OPCODE_LOCATION()
@@ -33,9 +35,32 @@ namespace RealSix::Script
 
 		PUSH_CALL_FRAME(mainCallFrame);
 
-		Execute();
+		return Continue();
+	}
+
+	std::vector<Value> VM::Continue() noexcept
+	{
+		auto checkpointBudget = ScriptConfig::GetInstance().GetCheckpointBudget();
+		auto timeBudget = ScriptConfig::GetInstance().GetTimeBudget();
+		if (checkpointBudget > 0 || timeBudget > 0.0)
+		{
+			ExecutionBudget budget;
+			if (checkpointBudget > 0)
+				budget.checkpointCount = checkpointBudget;
+			if (timeBudget > 0.0)
+			{
+				budget.hasDeadline = true;
+				budget.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(timeBudget));
+			}
+			Execute(0, &budget);
+		}
+		else
+			Execute();
 
 		std::vector<Value> returnValues;
+		if (IsSuspended())
+			return returnValues;
+
 #ifndef NDEBUG
 		if (STACK_TOP() != STACK_BASE() + 1)
 			REALSIX_SCRIPT_LOG_ERROR(new Token(), "Stack occupancy exception.");
@@ -49,7 +74,174 @@ namespace RealSix::Script
 		return returnValues;
 	}
 
-	void VM::Execute()
+	bool VM::IsSuspended() const noexcept
+	{
+		return !IS_CALL_FRAME_STACK_EMPTY();
+	}
+
+	void VM::Call(const Value &callee, const Value *args, uint32_t argCount, const Token *relatedToken, Value &result)
+	{
+		// Callee and arguments go on the stack like for OP_CALL, that also keeps them alive across a gc
+		Value *slots = STACK_TOP();
+		PUSH_STACK(callee);
+		for (uint32_t i = 0; i < argCount; ++i)
+			PUSH_STACK(args[i]);
+
+		Value function = callee;
+		if (IS_CLASS_CLOSURE_BIND_VALUE(function))
+		{
+			auto binding = TO_CLASS_CLOSURE_BIND_VALUE(function);
+			*slots = binding->receiver;
+			function = binding->closure;
+		}
+
+		if (IS_CLOSURE_VALUE(function))
+		{
+			auto closure = TO_CLOSURE_VALUE(function);
+			if (closure->function->varArg != VarArg::NONE || argCount != closure->function->arity)
+				REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No matching argument count.");
+
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+			Instrument::GetInstance().RecordCall(closure->function);
+#endif
+			auto callFrameCount = CALL_FRAME_COUNT();
+			PUSH_CALL_FRAME(CallFrame(closure, slots));
+			Execute(callFrameCount);
+
+			// OP_RETURN left the return values from the callee slot on
+			result = *slots;
+		}
+		else if (IS_NATIVE_FUNCTION_VALUE(function))
+		{
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+			Instrument::GetInstance().RecordNativeCall();
+#endif
+			if (!TO_NATIVE_FUNCTION_VALUE(function)->Invoke(slots + 1, argCount, relatedToken, result))
+				result = Value();
+		}
+		else
+			REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid callee,Only function is available: {}", callee.ToString());
+
+		SET_STACK_TOP(slots);
+	}
+
+	void VM::Resume(FiberObject *fiber, const Value &value, const Token *relatedToken, Value &result)
+	{
+		if (fiber->status == FiberStatus::RUNNING)
+			REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot resume a running fiber.");
+		if (fiber->status == FiberStatus::DEAD)
+			REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot resume a dead fiber.");
+
+		auto &allocator = Allocator::GetInstance();
+
+		Value *bottom = STACK_TOP();
+		fiber->stackBottom = bottom;
+		fiber->callFrameBottom = CALL_FRAME_COUNT();
+
+		if (fiber->frames.empty()) // not started yet, the value is the argument of its function
+		{
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+			Instrument::GetInstance().RecordCall(fiber->closure->function);
+#endif
+			PUSH_STACK(fiber->closure);
+			if (fiber->closure->function->arity == 1)
+				PUSH_STACK(value);
+			PUSH_CALL_FRAME(CallFrame(fiber->closure, bottom));
+		}
+		else
+		{
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+			Instrument::GetInstance().RecordFiberResume();
+#endif
+			for (const auto &slot : fiber->stack)
+				PUSH_STACK(slot);
+			for (const auto &savedFrame : fiber->frames)
+			{
+				CallFrame frame;
+				frame.closure = savedFrame.closure;
+				frame.ip = savedFrame.ip;
+				frame.slots = bottom + savedFrame.slotOffset;
+				frame.argumentsHash = savedFrame.argumentsHash;
+				PUSH_CALL_FRAME(frame);
+			}
+
+			// The fiber slots are above every slot on the VM stack, so its upvalues go in front of the open list
+			if (fiber->openUpValues)
+			{
+				UpValueObject *last = nullptr;
+				for (auto upValue = fiber->openUpValues; upValue != nullptr; upValue = upValue->nextUpValue)
+				{
+					upValue->location = bottom + (upValue->location - fiber->stack.data());
+					upValue->fiber = nullptr;
+					last = upValue;
+				}
+				last->nextUpValue = allocator.mOpenUpValues;
+				allocator.mOpenUpValues = fiber->openUpValues;
+				fiber->openUpValues = nullptr;
+			}
+
+			fiber->stack.clear();
+			fiber->frames.clear();
+
+			// Result of the yield expression the fiber stopped at
+			PUSH_STACK(value);
+		}
+
+		fiber->status = FiberStatus::RUNNING;
+		fiber->caller = allocator.mCurrentFiber;
+		allocator.mCurrentFiber = fiber;
+
+		Execute(fiber->callFrameBottom);
+
+		allocator.mCurrentFiber = fiber->caller;
+		fiber->caller = nullptr;
+
+		if (fiber->status == FiberStatus::RUNNING) // returned, OP_RETURN left the return value at the bottom
+		{
+			result = *bottom;
+			fiber->status = FiberStatus::DEAD;
+			std::vector<Value>().swap(fiber->stack);
+			std::vector<FiberObject::Frame>().swap(fiber->frames);
+		}
+		else
+		{
+			result = fiber->transfer;
+			fiber->transfer = Value();
+		}
+
+		SET_STACK_TOP(bottom);
+	}
+
+	void VM::SuspendFiber(FiberObject *fiber)
+	{
+		auto &allocator = Allocator::GetInstance();
+		Value *bottom = fiber->stackBottom;
+
+		fiber->stack.assign(bottom, STACK_TOP());
+		for (CallFrame *frame = allocator.mCallFrameStack + fiber->callFrameBottom; frame < allocator.mCallFrameTop; ++frame)
+			fiber->frames.emplace_back(FiberObject::Frame{frame->closure, frame->ip, static_cast<size_t>(frame->slots - bottom), frame->argumentsHash});
+
+		// Open upvalues are sorted by location from the top, the ones into the fiber slots are a prefix of the list
+		UpValueObject *last = nullptr;
+		for (auto upValue = allocator.mOpenUpValues; upValue != nullptr && upValue->location >= bottom; upValue = upValue->nextUpValue)
+		{
+			upValue->location = fiber->stack.data() + (upValue->location - bottom);
+			upValue->fiber = fiber;
+			last = upValue;
+		}
+		if (last)
+		{
+			fiber->openUpValues = allocator.mOpenUpValues;
+			allocator.mOpenUpValues = last->nextUpValue;
+			last->nextUpValue = nullptr;
+		}
+
+		allocator.mCallFrameTop = allocator.mCallFrameStack + fiber->callFrameBottom;
+		SET_STACK_TOP(bottom);
+		fiber->status = FiberStatus::SUSPENDED;
+	}
+
+	void VM::Execute(size_t exitCallFrameCount, ExecutionBudget *budget)
 	{
 		//  - * /
 #define COMMON_BINARY(op)                                                                                                                                                                                           \
@@ -67,6 +259,8 @@ namespace RealSix::Script
 			PUSH_STACK(TO_INT_VALUE(left) op TO_FLOAT_VALUE(right));                                                                                                                                                \
 		else if (IS_FLOAT_VALUE(left) && IS_INT_VALUE(right))                                                                                                                                                       \
 			PUSH_STACK(TO_FLOAT_VALUE(left) op TO_INT_VALUE(right));                                                                                                                                                \
+		else if (Value mathResult; MathBinary(#op[0], left, right, mathResult))                                                                                                                                     \
+			PUSH_STACK(mathResult);                                                                                                                                                                                    \
 		else                                                                                                                                                                                                        \
 			REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid binary op:{}{}{},only (&)int-(&)int,(&)real-(&)real,(&)int-(&)real or (&)real-(&)int type pair is available.", left.ToString(), #op, right.ToString()); \
 	} while (0);
@@ -120,6 +314,27 @@ namespace RealSix::Script
 	} while (0);
 
 #define READ_INS() (*frame->ip++)
+#define READ_U16() (frame->ip += 2, (uint16_t)(frame->ip[-2] << 8 | frame->ip[-1]))
+#define READ_U24() (frame->ip += 3, (uint32_t)(frame->ip[-3] << 16 | frame->ip[-2] << 8 | frame->ip[-1]))
+#define READ_U32() (frame->ip += 4, (uint32_t)(frame->ip[-4] << 24 | frame->ip[-3] << 16 | frame->ip[-2] << 8 | frame->ip[-1]))
+
+// Narrow opcodes carry a 1 byte index, their _LONG variants share the handler with a 2 byte index
+#define READ_INDEX(narrowOpCode) (instruction == narrowOpCode ? (uint16_t)READ_INS() : READ_U16())
+
+// Loop back-edges and calls are the only places a budgeted Execute gives up control, a script needs one of them
+// to run for long. The frames stay on the stacks for the next Execute
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+#define PREEMPTION_CHECKPOINT()             \
+	if (budget && budget->Consume())        \
+	{                                       \
+		instrument.EndOpCode();             \
+		return;                             \
+	}
+#else
+#define PREEMPTION_CHECKPOINT()             \
+	if (budget && budget->Consume())        \
+		return;
+#endif
 
 #define CHECK_IDX_RANGE(size, idx) \
 	if (idx < 0 || idx >= size)    \
@@ -129,14 +344,35 @@ namespace RealSix::Script
 	if (!IS_INT_VALUE(idxValue))  \
 		REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid idx type for array or string,only integer is available.");
 
+		const bool isProfiling = Profiler::GetInstance().IsRunning();
+		uint32_t sampleCountdown = Profiler::GetInstance().GetSampleInterval();
+
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+		auto &instrument = Instrument::GetInstance();
+#endif
+
 		while (1)
 		{
-			if (IS_CALL_FRAME_STACK_EMPTY())
+			if (CALL_FRAME_COUNT() == exitCallFrameCount)
+			{
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+				instrument.EndOpCode();
+#endif
 				return;
+			}
 			CallFrame *frame = PEEK_CALL_FRAME(0);
 
+			if (isProfiling && --sampleCountdown == 0)
+			{
+				Profiler::GetInstance().Sample();
+				sampleCountdown = Profiler::GetInstance().GetSampleInterval();
+			}
+
 			auto instruction = READ_INS();
 			auto relatedToken = frame->closure->function->chunk.opCodeRelatedTokens[READ_INS()];
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+			instrument.BeginOpCode(instruction);
+#endif
 			switch (instruction)
 			{
 			case OP_RETURN:
@@ -146,7 +382,8 @@ namespace RealSix::Script
 				auto retCount = READ_INS();
 				Value *retValues = STACK_TOP() - retCount;
 
-				CLOSED_UPVALUES(frame->slots);
+				if (frame->closure->function->hasCapturedLocals)
+					CLOSED_UPVALUES(frame->slots);
 
 				if (IS_CALL_FRAME_STACK_EMPTY())
 					return;
@@ -185,10 +422,11 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_CONSTANT:
+			case OP_CONSTANT_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
-				auto v = frame->closure->function->chunk.constants[pos];
+				auto pos = instruction == OP_CONSTANT ? READ_INS() : READ_U24();
+				auto v = (*frame->closure->function->chunk.constants)[pos];
 				PUSH_STACK(v);
 				break;
 			}
@@ -199,9 +437,10 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_SET_GLOBAL:
+			case OP_SET_GLOBAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_SET_GLOBAL);
 				auto v = PEEK_STACK(0);
 
 				auto globalValue = GET_GLOBAL_VALUE_REF(pos);
@@ -211,16 +450,18 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_GET_GLOBAL:
+			case OP_GET_GLOBAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_GET_GLOBAL);
 				PUSH_STACK(*GET_GLOBAL_VALUE_REF(pos));
 				break;
 			}
 			case OP_DEF_STATIC:
+			case OP_DEF_STATIC_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_DEF_STATIC);
 				auto v = PEEK_STACK(0);
 				auto staticValue = GET_STATIC_VALUE_REF(pos);
 
@@ -232,9 +473,10 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_SET_STATIC:
+			case OP_SET_STATIC_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_SET_STATIC);
 				auto v = PEEK_STACK(0);
 
 				auto staticValue = GET_STATIC_VALUE_REF(pos);
@@ -244,16 +486,18 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_GET_STATIC:
+			case OP_GET_STATIC_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_GET_STATIC);
 				PUSH_STACK(GET_STATIC_VALUE_REF(pos)->value);
 				break;
 			}
 			case OP_SET_LOCAL:
+			case OP_SET_LOCAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_SET_LOCAL);
 				auto v = PEEK_STACK(0);
 
 				auto slot = frame->slots + pos;
@@ -262,9 +506,10 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_GET_LOCAL:
+			case OP_GET_LOCAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
+				auto pos = READ_INDEX(OP_GET_LOCAL);
 				PUSH_STACK(frame->slots[pos]); // now assume base ptr on the stack bottom
 				break;
 			}
@@ -273,14 +518,14 @@ namespace RealSix::Script
 				OUTPUT_OPCODE_LOCATION();
 				auto pos = READ_INS();
 				auto v = PEEK_STACK(0);
-				*frame->closure->upvalues[pos]->location = PEEK_STACK(0);
+				*frame->closure->GetUpValues()[pos]->location = PEEK_STACK(0);
 				break;
 			}
 			case OP_GET_UPVALUE:
 			{
 				OUTPUT_OPCODE_LOCATION();
 				auto pos = READ_INS();
-				PUSH_STACK(*frame->closure->upvalues[pos]->location);
+				PUSH_STACK(*frame->closure->GetUpValues()[pos]->location);
 				break;
 			}
 			case OP_CLOSE_UPVALUE:
@@ -298,8 +543,8 @@ namespace RealSix::Script
 				Value right;
 				Value result;
 
-				GetActualValueIfIsRefValue(PEEK_STACK(0), left);
-				GetActualValueIfIsRefValue(PEEK_STACK(1), right);
+				GetActualValueIfIsRefValue(PEEK_STACK(1), left);
+				GetActualValueIfIsRefValue(PEEK_STACK(0), right);
 
 				if (IS_INT_VALUE(left) && IS_INT_VALUE(right))
 					result = TO_INT_VALUE(left) + TO_INT_VALUE(right);
@@ -310,8 +555,8 @@ namespace RealSix::Script
 				else if (IS_FLOAT_VALUE(left) && IS_INT_VALUE(right))
 					result = TO_FLOAT_VALUE(left) + TO_INT_VALUE(right);
 				else if (IS_STR_VALUE(left) && IS_STR_VALUE(right))
-					result = Allocator::GetInstance().CreateObject<StrObject>(TO_STR_VALUE(left)->value + TO_STR_VALUE(right)->value);
-				else
+					result = Allocator::GetInstance().CreateObject<StrObject>(TO_STR_VALUE(left), TO_STR_VALUE(right));
+				else if (!MathBinary('+', left, right, result))
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid binary op:{}+{},only (&)int-(&)int,(&)real-(&)real,(&)int-(&)real or (&)real-(&)int type pair is available.", left.ToString(), right.ToString());
 
 				MOVE_STACK_TOP(-2);
@@ -408,6 +653,8 @@ namespace RealSix::Script
 					PUSH_STACK(-TO_INT_VALUE(value));
 				else if (IS_FLOAT_VALUE(value))
 					PUSH_STACK(-TO_FLOAT_VALUE(value));
+				else if (Value mathResult; MathNegate(value, mathResult))
+					PUSH_STACK(mathResult);
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid op:-{}, only -(int||real expr) is available.", value.ToString());
 				break;
@@ -430,12 +677,10 @@ namespace RealSix::Script
 				OUTPUT_OPCODE_LOCATION();
 				auto count = READ_INS();
 
-				std::vector<Value> elements(count);
-				size_t i = 0;
-				for (auto e = STACK_TOP() - count; e < STACK_TOP(); ++e, ++i)
-					elements[i] = *e;
-
-				auto arrayObject = Allocator::GetInstance().CreateObject<ArrayObject>(elements);
+				auto arrayObject = Allocator::GetInstance().CreateObject<ArrayObject>();
+				arrayObject->elements.Reserve(count);
+				for (auto e = STACK_TOP() - count; e < STACK_TOP(); ++e)
+					arrayObject->elements.Push(*e);
 
 				MOVE_STACK_TOP(-count);
 
@@ -446,16 +691,11 @@ namespace RealSix::Script
 			{
 				OUTPUT_OPCODE_LOCATION();
 				auto count = READ_INS();
-				ValueUnorderedMap elements;
-
-				auto dict = Allocator::GetInstance().CreateObject<DictObject>(elements);
+				auto dict = Allocator::GetInstance().CreateObject<DictObject>();
+				dict->elements.Reserve(count);
 
 				for (auto e = STACK_TOP() - count * 2; e < STACK_TOP(); e += 2)
-				{
-					auto key = *e;
-					auto value = *(e + 1);
-					dict->elements[key] = value;
-				}
+					dict->elements.Set(*e, *(e + 1));
 
 				MOVE_STACK_TOP(-count * 2);
 
@@ -472,27 +712,27 @@ namespace RealSix::Script
 					auto array = TO_ARRAY_VALUE(dsValue);
 					CHECK_IDX_VALID(idxValue);
 
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.size());
-					CHECK_IDX_RANGE(array->elements.size(), intIdx);
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.Size());
+					CHECK_IDX_RANGE(array->elements.Size(), intIdx);
 
-					PUSH_STACK(array->elements[intIdx]);
+					PUSH_STACK(array->elements.Get(intIdx));
 				}
 				else if (IS_STR_VALUE(dsValue))
 				{
 					auto strObj = TO_STR_VALUE(dsValue);
 					CHECK_IDX_VALID(idxValue)
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), strObj->value.Size());
-					CHECK_IDX_RANGE(strObj->value.Size(), intIdx);
-					PUSH_STACK(Allocator::GetInstance().CreateObject<StrObject>(strObj->value.SubStr(intIdx, 1)));
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), strObj->GetValue().Size());
+					CHECK_IDX_RANGE(strObj->GetValue().Size(), intIdx);
+					PUSH_STACK(Allocator::GetInstance().CreateObject<StrObject>(strObj->GetValue().SubStr(intIdx, 1)));
 				}
 				else if (IS_DICT_VALUE(dsValue))
 				{
 					auto dict = TO_DICT_VALUE(dsValue);
 
-					auto iter = dict->elements.find(idxValue);
+					auto value = dict->elements.Find(idxValue);
 
-					if (iter != dict->elements.end())
-						PUSH_STACK(iter->second);
+					if (value != nullptr)
+						PUSH_STACK(*value);
 					else
 						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No key in dict");
 				}
@@ -508,26 +748,27 @@ namespace RealSix::Script
 				{
 					auto array = TO_ARRAY_VALUE(dsValue);
 					CHECK_IDX_VALID(idxValue);
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.size());
-					CHECK_IDX_RANGE(array->elements.size(), intIdx);
-					array->elements[intIdx] = newValue;
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.Size());
+					CHECK_IDX_RANGE(array->elements.Size(), intIdx);
+					array->elements.Set(intIdx, newValue);
 				}
 				else if (IS_STR_VALUE(dsValue))
 				{
 					auto strObj = TO_STR_VALUE(dsValue);
 					CHECK_IDX_VALID(idxValue)
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), strObj->value.Size());
-					CHECK_IDX_RANGE(strObj->value.Size(), intIdx)
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), strObj->GetValue().Size());
+					CHECK_IDX_RANGE(strObj->GetValue().Size(), intIdx)
 
 					if (!IS_STR_VALUE(newValue))
-						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot insert a non string clip:{} to string:{}", newValue.ToString(), strObj->value);
+						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot insert a non string clip:{} to string:{}", newValue.ToString(), strObj->GetValue());
 
-					strObj->value.Append(TO_STR_VALUE(newValue)->value, intIdx, TO_STR_VALUE(newValue)->value.Size());
+					String clip = TO_STR_VALUE(newValue)->GetValue(); // copied, the clip can be the string itself
+					strObj->GetMutableValue().Append(clip, intIdx, clip.Size());
 				}
 				else if (IS_DICT_VALUE(dsValue))
 				{
 					auto dict = TO_DICT_VALUE(dsValue);
-					dict->elements[idxValue] = newValue;
+					dict->elements.Set(idxValue, newValue);
 				}
 				break;
 			}
@@ -538,38 +779,44 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_JUMP_IF_FALSE:
+			case OP_JUMP_IF_FALSE_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				uint16_t address = (*(frame->ip++) << 8) | (*(frame->ip++));
+				uint32_t address = instruction == OP_JUMP_IF_FALSE ? READ_U16() : READ_U32();
 				if (IsFalsey(PEEK_STACK(0)))
 					frame->ip += address;
 				break;
 			}
 			case OP_JUMP:
+			case OP_JUMP_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				uint16_t address = (*(frame->ip++) << 8) | (*(frame->ip++));
+				uint32_t address = instruction == OP_JUMP ? READ_U16() : READ_U32();
 				frame->ip += address;
 				break;
 			}
 			case OP_LOOP:
+			case OP_LOOP_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				uint16_t address = (*(frame->ip++) << 8) | (*(frame->ip++));
+				uint32_t address = instruction == OP_LOOP ? READ_U16() : READ_U32();
 				frame->ip -= address;
+				PREEMPTION_CHECKPOINT();
 				break;
 			}
 			case OP_REF_GLOBAL:
+			case OP_REF_GLOBAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto index = READ_INS();
+				auto index = READ_INDEX(OP_REF_GLOBAL);
 				PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(GET_GLOBAL_VALUE_REF(index)));
 				break;
 			}
 			case OP_REF_LOCAL:
+			case OP_REF_LOCAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto index = READ_INS();
+				auto index = READ_INDEX(OP_REF_LOCAL);
 				PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(frame->slots + index));
 				break;
 			}
@@ -577,13 +824,14 @@ namespace RealSix::Script
 			{
 				OUTPUT_OPCODE_LOCATION();
 				auto index = READ_INS();
-				PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(frame->closure->upvalues[index]->location));
+				PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(frame->closure->GetUpValues()[index]->location));
 				break;
 			}
 			case OP_REF_INDEX_GLOBAL:
+			case OP_REF_INDEX_GLOBAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto index = READ_INS();
+				auto index = READ_INDEX(OP_REF_INDEX_GLOBAL);
 				auto idxValue = POP_STACK();
 
 				auto globalValue = GET_GLOBAL_VALUE_REF(index);
@@ -594,18 +842,19 @@ namespace RealSix::Script
 				{
 					auto array = TO_ARRAY_VALUE(*globalValue);
 					CHECK_IDX_VALID(idxValue)
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.size());
-					CHECK_IDX_RANGE(array->elements.size(), intIdx);
-					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(&(array->elements[intIdx])));
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.Size());
+					CHECK_IDX_RANGE(array->elements.Size(), intIdx);
+					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(array->elements.GetRef(intIdx)));
 				}
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid indexed reference type:{} not a dict or array value.", globalValue->ToString());
 				break;
 			}
 			case OP_REF_INDEX_LOCAL:
+			case OP_REF_INDEX_LOCAL_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto index = READ_INS();
+				auto index = READ_INDEX(OP_REF_INDEX_LOCAL);
 				auto idxValue = POP_STACK();
 				Value *v = frame->slots + index;
 				if (IS_DICT_VALUE((*v)))
@@ -614,9 +863,9 @@ namespace RealSix::Script
 				{
 					auto array = TO_ARRAY_VALUE((*v));
 					CHECK_IDX_VALID(idxValue)
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.size());
-					CHECK_IDX_RANGE(array->elements.size(), intIdx);
-					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(&array->elements[intIdx]));
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.Size());
+					CHECK_IDX_RANGE(array->elements.Size(), intIdx);
+					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(array->elements.GetRef(intIdx)));
 				}
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid indexed reference type:{} not a dict or array value.", v->ToString());
@@ -628,16 +877,16 @@ namespace RealSix::Script
 
 				auto index = READ_INS();
 				auto idxValue = POP_STACK();
-				Value *v = frame->closure->upvalues[index]->location;
+				Value *v = frame->closure->GetUpValues()[index]->location;
 				if (IS_DICT_VALUE((*v)))
 					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(&TO_DICT_VALUE((*v))->elements[idxValue]));
 				else if (IS_ARRAY_VALUE((*v)))
 				{
 					auto array = TO_ARRAY_VALUE((*v));
 					CHECK_IDX_VALID(idxValue)
-					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.size());
-					CHECK_IDX_RANGE(array->elements.size(), intIdx)
-					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(&array->elements[intIdx]));
+					auto intIdx = NormalizeIdx(TO_INT_VALUE(idxValue), array->elements.Size());
+					CHECK_IDX_RANGE(array->elements.Size(), intIdx)
+					PUSH_STACK(Allocator::GetInstance().CreateObject<RefObject>(array->elements.GetRef(intIdx)));
 				}
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid indexed reference type: {}  not a dict or array value.", v->ToString());
@@ -699,13 +948,17 @@ namespace RealSix::Script
 					else if (argCount != TO_CLOSURE_VALUE(callee)->function->arity)
 						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No matching argument count.");
 
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+					instrument.RecordCall(TO_CLOSURE_VALUE(callee)->function);
+#endif
+
 					auto argsHash = HashValueList(STACK_TOP() - argCount, STACK_TOP());
 					std::vector<Value> rets;
 					// ++ Function cache relative
 					if (ScriptConfig::GetInstance().IsUseFunctionCache() && TO_CLOSURE_VALUE(callee)->function->GetCache(argsHash, rets))
 					{
 						MOVE_STACK_TOP(-(argCount + 1));
-						for (int32_t i = 0; i < rets.size(); ++i)
+						for (size_t i = 0; i < rets.size(); ++i)
 							PUSH_STACK(rets[i]);
 					}
 					else
@@ -731,15 +984,20 @@ namespace RealSix::Script
 						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Not matching argument count of class: {}'s constructors.", klass->name);
 
 					auto constructor = iter->second;
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+					instrument.RecordCall(constructor->function);
+#endif
 					// init a new frame
 					CallFrame newframe(constructor, STACK_TOP() - argCount - 1);
 					PUSH_CALL_FRAME(newframe);
 				}
 				else if (IS_NATIVE_FUNCTION_VALUE(callee)) // native function
 				{
-
+#if defined(REALSIX_SCRIPT_INSTRUMENT)
+					instrument.RecordNativeCall();
+#endif
 					Value result;
-					auto hasRetV = TO_NATIVE_FUNCTION_VALUE(callee)->fn(STACK_TOP() - argCount, argCount, relatedToken, result);
+					auto hasRetV = TO_NATIVE_FUNCTION_VALUE(callee)->Invoke(STACK_TOP() - argCount, argCount, relatedToken, result);
 
 					MOVE_STACK_TOP(-(argCount + 1));
 
@@ -750,6 +1008,7 @@ namespace RealSix::Script
 				}
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid callee,Only function is available: {}", callee.ToString());
+				PREEMPTION_CHECKPOINT();
 				break;
 			}
 			case OP_CLASS:
@@ -765,7 +1024,7 @@ namespace RealSix::Script
 
 				auto classObj = Allocator::GetInstance().CreateObject<ClassObject>();
 
-				classObj->name = TO_STR_VALUE(name)->value;
+				classObj->name = TO_STR_VALUE(name)->GetValue();
 				POP_STACK(); // pop name strobject
 
 				for (int32_t i = 0; i < constructorCount; ++i)
@@ -774,44 +1033,9 @@ namespace RealSix::Script
 					classObj->constructors[v->function->arity] = v;
 				}
 
-				for (int32_t i = 0; i < parentClassCount; ++i)
-				{
-					name = POP_STACK();
-					auto parentClass = POP_STACK();
-					classObj->parents[TO_STR_VALUE(name)->value] = TO_CLASS_VALUE(parentClass);
-				}
-
-				for (int32_t i = 0; i < varCount; ++i)
-				{
-					name = POP_STACK();
-					auto v = POP_STACK();
-					v.permission = Permission::MUTABLE;
-					classObj->members[TO_STR_VALUE(name)->value] = v;
-				}
-
-				for (int32_t i = 0; i < constCount; ++i)
-				{
-					name = POP_STACK();
-					auto v = POP_STACK();
-					v.permission = Permission::IMMUTABLE;
-					classObj->members[TO_STR_VALUE(name)->value] = v;
-				}
-
-				for (int32_t i = 0; i < fnCount; ++i)
-				{
-					name = POP_STACK();
-					auto v = POP_STACK();
-					v.permission = Permission::IMMUTABLE;
-					classObj->functions[TO_STR_VALUE(name)->value] = v;
-				}
-
-				for (int32_t i = 0; i < enumCount; ++i)
-				{
-					name = POP_STACK();
-					auto v = POP_STACK();
-					v.permission = Permission::IMMUTABLE;
-					classObj->enums[TO_STR_VALUE(name)->value] = v;
-				}
+				ClassBody body{STACK_TOP(), parentClassCount, varCount, constCount, fnCount, enumCount};
+				classObj->Build(frame->closure->function, body);
+				MOVE_STACK_TOP(-2 * static_cast<int32_t>(body.GetPairCount())); // pop name,value pairs
 
 				PUSH_STACK(classObj);
 				break;
@@ -823,20 +1047,41 @@ namespace RealSix::Script
 				auto structObj = Allocator::GetInstance().CreateObject<StructObject>();
 				for (int64_t i = 0; i < (int64_t)eCount; ++i)
 				{
-					auto key = TO_STR_VALUE(POP_STACK())->value;
+					auto key = TO_STR_VALUE(POP_STACK())->GetValue();
 					auto value = POP_STACK();
 					structObj->elements[key] = value;
 				}
 				PUSH_STACK(structObj);
 				break;
 			}
+			case OP_GET_PROPERTY_SLOT:
+			{
+				OUTPUT_OPCODE_LOCATION();
+				auto classBody = TO_FUNCTION_VALUE((*frame->closure->function->chunk.constants)[READ_U24()]);
+				auto slot = READ_U16();
+				auto fallbackSize = READ_INS();
+
+				Value peekValue;
+				GetActualValueIfIsRefValue(PEEK_STACK(0), peekValue);
+				if (IS_CLASS_VALUE(peekValue) && TO_CLASS_VALUE(peekValue)->layout.get() == classBody->classLayout.get())
+				{
+					Value member;
+					TO_CLASS_VALUE(peekValue)->GetSlotMember(slot, member);
+					if (IS_CLOSURE_VALUE(member))
+						member = Allocator::GetInstance().CreateObject<ClassClosureBindObject>(TO_CLASS_VALUE(peekValue), TO_CLOSURE_VALUE(member));
+					SET_VALUE_FROM_STACK_TOP_OFFSET(-1, member); // replace class object
+					frame->ip += fallbackSize; // skip the member name and OP_GET_PROPERTY
+				}
+				// Otherwise the receiver is not laid out as resolved at compile time, the following OP_GET_PROPERTY looks the member up by name
+				break;
+			}
 			case OP_GET_PROPERTY:
 			{
 				OUTPUT_OPCODE_LOCATION();
 				Value peekValue;
 				GetActualValueIfIsRefValue(PEEK_STACK(1), peekValue);
 
-				auto propName = TO_STR_VALUE(POP_STACK())->value;
+				auto propName = TO_STR_VALUE(POP_STACK())->GetValue();
 
 				if (IS_CLASS_VALUE(peekValue))
 				{
@@ -892,6 +1137,18 @@ namespace RealSix::Script
 					else
 						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No member: {} in module: {}", propName, moduleObj->name);
 				}
+				else if (IS_VEC3_VALUE(peekValue) || IS_QUAT_VALUE(peekValue))
+				{
+					// vec3 and quat share the x,y,z layout, quat adds w
+					const float *components = IS_VEC3_VALUE(peekValue) ? TO_VEC3_VALUE(peekValue)->value.values.data() : TO_QUAT_VALUE(peekValue)->value.values.data();
+					size_t componentCount = IS_VEC3_VALUE(peekValue) ? 3 : 4;
+					size_t idx = propName == "x" ? 0 : propName == "y" ? 1 : propName == "z" ? 2 : propName == "w" ? 3 : 4;
+					if (idx >= componentCount)
+						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No component: {} in {}", propName, peekValue.ToString());
+					POP_STACK(); // pop math value
+					PUSH_STACK(Value(static_cast<double>(components[idx])));
+					break;
+				}
 				else
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid call:not a valid class,enum or struct object instance: {}", peekValue.ToString());
 
@@ -904,19 +1161,21 @@ namespace RealSix::Script
 				Value peekValue;
 				GetActualValueIfIsRefValue(PEEK_STACK(1), peekValue);
 
-				auto propName = TO_STR_VALUE(POP_STACK())->value;
+				auto propName = TO_STR_VALUE(POP_STACK())->GetValue();
 				if (IS_CLASS_VALUE(peekValue))
 				{
 					auto klass = TO_CLASS_VALUE(peekValue);
 					POP_STACK(); // pop class value
 
-					Value member;
-					if (klass->GetMember(propName, member))
+					auto slot = klass->FindSlot(propName);
+					if (slot != ClassLayout::NO_SLOT)
 					{
+						Value member;
+						klass->GetSlotMember(slot, member);
 						if (member.permission == Permission::IMMUTABLE)
 							REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Constant cannot be assigned twice: {}'s member: {} is a constant value", klass->name, propName);
 						else
-							klass->members[propName] = PEEK_STACK(0);
+							klass->SetSlotMember(slot, PEEK_STACK(0));
 					}
 					else
 						REALSIX_SCRIPT_LOG_ERROR(relatedToken, "No member named: {} in class: {}", propName, klass->name);
@@ -942,7 +1201,7 @@ namespace RealSix::Script
 				OUTPUT_OPCODE_LOCATION();
 				if (!IS_CLASS_VALUE(PEEK_STACK(1)))
 					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid class call:not a valid class instance.");
-				auto propName = TO_STR_VALUE(POP_STACK())->value;
+				auto propName = TO_STR_VALUE(POP_STACK())->GetValue();
 				auto klass = TO_CLASS_VALUE(POP_STACK());
 				Value member;
 				bool hasValue = klass->GetParentMember(propName, member);
@@ -952,10 +1211,11 @@ namespace RealSix::Script
 				break;
 			}
 			case OP_CLOSURE:
+			case OP_CLOSURE_LONG:
 			{
 				OUTPUT_OPCODE_LOCATION();
-				auto pos = READ_INS();
-				auto func = TO_FUNCTION_VALUE(frame->closure->function->chunk.constants[pos]);
+				auto pos = instruction == OP_CLOSURE ? READ_INS() : READ_U24();
+				auto func = TO_FUNCTION_VALUE((*frame->closure->function->chunk.constants)[pos]);
 
 				PUSH_STACK(func); // push function object for avoiding gc
 				auto closure = Allocator::GetInstance().CreateObject<ClosureObject>(func);
@@ -963,17 +1223,22 @@ namespace RealSix::Script
 
 				PUSH_STACK(closure);
 
-				for (int32_t i = 0; i < closure->upvalues.size(); ++i)
+				for (int32_t i = 0; i < closure->GetUpValueCount(); ++i)
 				{
-					auto index = READ_INS();
-					auto depth = READ_INS();
-					if (depth == CALL_FRAME_COUNT() - 1)
+					auto index = READ_INDEX(OP_CLOSURE);
+					auto kind = READ_INS();
+					if (kind == UPVALUE_LOCAL)
+						closure->GetUpValues()[i] = CAPTURE_UPVALUE(frame->slots + index);
+					else if (kind == UPVALUE_LOCAL_VALUE)
 					{
-						auto captured = CAPTURE_UPVALUE(frame->slots + index);
-						closure->upvalues[i] = captured;
+						// The slot is immutable, the copy never has to be closed and stays off the open upvalue list
+						auto captured = Allocator::GetInstance().CreateObject<UpValueObject>();
+						captured->closed = frame->slots[index];
+						captured->location = &captured->closed;
+						closure->GetUpValues()[i] = captured;
 					}
 					else
-						closure->upvalues[i] = frame->closure->upvalues[index];
+						closure->GetUpValues()[i] = frame->closure->GetUpValues()[index];
 				}
 
 				break;
@@ -986,21 +1251,21 @@ namespace RealSix::Script
 				if (IS_ARRAY_VALUE(value))
 				{
 					auto arrayObj = TO_ARRAY_VALUE(value);
-					if (count >= arrayObj->elements.size())
+					if (count >= arrayObj->elements.Size())
 					{
-						auto diff = count - arrayObj->elements.size();
+						auto diff = count - arrayObj->elements.Size();
 						while (diff > 0)
 						{
 							PUSH_STACK(Value());
 							diff--;
 						}
-						for (int32_t i = static_cast<int32_t>(arrayObj->elements.size() - 1); i >= 0; --i)
-							PUSH_STACK(arrayObj->elements[i]);
+						for (int32_t i = static_cast<int32_t>(arrayObj->elements.Size() - 1); i >= 0; --i)
+							PUSH_STACK(arrayObj->elements.Get(i));
 					}
 					else
 					{
 						for (int32_t i = count - 1; i >= 0; --i)
-							PUSH_STACK(arrayObj->elements[i]);
+							PUSH_STACK(arrayObj->elements.Get(i));
 					}
 				}
 				else
@@ -1024,14 +1289,14 @@ namespace RealSix::Script
 				if (IS_ARRAY_VALUE(value))
 				{
 					auto arrayObj = TO_ARRAY_VALUE(value);
-					if (count >= arrayObj->elements.size())
+					if (count >= arrayObj->elements.Size())
 					{
 						ArrayObject *varArgArray = Allocator::GetInstance().CreateObject<ArrayObject>();
 
 						POP_STACK(); // pop value object
 
-						auto diff = count - arrayObj->elements.size();
-						for (int32_t i = static_cast<int32_t>(diff); i > 0; --i)
+						auto diff = static_cast<int32_t>(count - arrayObj->elements.Size());
+						for (int32_t i = diff; i > 0; --i)
 						{
 							if (i == diff)
 								PUSH_STACK(varArgArray);
@@ -1039,8 +1304,8 @@ namespace RealSix::Script
 								PUSH_STACK(Value());
 						}
 
-						for (int32_t i = static_cast<int32_t>(arrayObj->elements.size() - 1); i >= 0; --i)
-							PUSH_STACK(arrayObj->elements[i]);
+						for (int32_t i = static_cast<int32_t>(arrayObj->elements.Size() - 1); i >= 0; --i)
+							PUSH_STACK(arrayObj->elements.Get(i));
 					}
 					else
 					{
@@ -1048,12 +1313,12 @@ namespace RealSix::Script
 
 						POP_STACK(); // pop value object
 
-						for (int32_t i = count - 1; i < arrayObj->elements.size(); ++i)
-							varArgArray->elements.emplace_back(arrayObj->elements[i]);
+						for (size_t i = count - 1; i < arrayObj->elements.Size(); ++i)
+							varArgArray->elements.Push(arrayObj->elements.Get(i));
 						PUSH_STACK(varArgArray);
 
 						for (int32_t i = count - 2; i >= 0; --i)
-							PUSH_STACK(arrayObj->elements[i]);
+							PUSH_STACK(arrayObj->elements.Get(i));
 					}
 				}
 				else
@@ -1078,7 +1343,7 @@ namespace RealSix::Script
 			{
 				OUTPUT_OPCODE_LOCATION();
 				auto name = PEEK_STACK(0);
-				auto nameStr = TO_STR_VALUE(name)->value;
+				auto nameStr = TO_STR_VALUE(name)->GetValue();
 
 				auto varCount = READ_INS();
 				auto constCount = READ_INS();
@@ -1093,7 +1358,7 @@ namespace RealSix::Script
 				for (int32_t i = 0; i < constCount; ++i)
 				{
 					name = POP_STACK();
-					nameStr = TO_STR_VALUE(name)->value;
+					nameStr = TO_STR_VALUE(name)->GetValue();
 					auto v = POP_STACK();
 					v.permission = Permission::IMMUTABLE;
 					moduleObj->members[nameStr] = v;
@@ -1102,7 +1367,7 @@ namespace RealSix::Script
 				for (int32_t i = 0; i < varCount; ++i)
 				{
 					name = POP_STACK();
-					nameStr = TO_STR_VALUE(name)->value;
+					nameStr = TO_STR_VALUE(name)->GetValue();
 					auto v = POP_STACK();
 					v.permission = Permission::MUTABLE;
 					moduleObj->members[nameStr] = v;
@@ -1129,6 +1394,35 @@ namespace RealSix::Script
 				}
 				break;
 			}
+			case OP_YIELD:
+			{
+				OUTPUT_OPCODE_LOCATION();
+				auto fiber = Allocator::GetInstance().mCurrentFiber;
+				if (fiber == nullptr)
+					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot yield outside of a fiber.");
+				// Only this Execute owns the fiber frames, below a native call there is C++ state in between
+				if (exitCallFrameCount != fiber->callFrameBottom)
+					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Cannot yield across a native function call.");
+
+				fiber->transfer = POP_STACK();
+				SuspendFiber(fiber);
+				break;
+			}
+			case OP_RESUME:
+			{
+				OUTPUT_OPCODE_LOCATION();
+				Value fiber;
+				GetActualValueIfIsRefValue(PEEK_STACK(1), fiber);
+				if (!IS_FIBER_VALUE(fiber))
+					REALSIX_SCRIPT_LOG_ERROR(relatedToken, "Invalid resume target: {},only fiber is available.", fiber.ToString());
+
+				// Fiber and value stay on the stack below the fiber frames while it runs
+				Value result;
+				Resume(TO_FIBER_VALUE(fiber), PEEK_STACK(0), relatedToken, result);
+				MOVE_STACK_TOP(-2);
+				PUSH_STACK(result);
+				break;
+			}
 			default:
 				break;
 			}
@@ -1139,4 +1433,134 @@ namespace RealSix::Script
 	{
 		return IS_NULL_VALUE(v) || (IS_BOOL_VALUE(v) && !TO_BOOL_VALUE(v));
 	}
+
+	bool VM::MathBinary(char op, const Value &left, const Value &right, Value &result)
+	{
+		auto isScalar = [](const Value &v)
+		{ return IS_INT_VALUE(v) || IS_FLOAT_VALUE(v); };
+		auto toScalar = [](const Value &v)
+		{ return static_cast<float>(IS_INT_VALUE(v) ? TO_INT_VALUE(v) : TO_FLOAT_VALUE(v)); };
+
+		// Operands are read before allocating, a gc may run in CreateObject and they are off the stack already
+		auto &allocator = Allocator::GetInstance();
+		if (IS_VEC3_VALUE(left))
+		{
+			const Vector3f &l = TO_VEC3_VALUE(left)->value;
+			if (IS_VEC3_VALUE(right))
+			{
+				const Vector3f &r = TO_VEC3_VALUE(right)->value;
+				switch (op)
+				{
+				case '+':
+					result = allocator.CreateObject<Vec3Object>(l + r);
+					return true;
+				case '-':
+					result = allocator.CreateObject<Vec3Object>(l - r);
+					return true;
+				case '*':
+					result = allocator.CreateObject<Vec3Object>(l * r);
+					return true;
+				case '/':
+					result = allocator.CreateObject<Vec3Object>(l / r);
+					return true;
+				}
+			}
+			else if (isScalar(right) && (op == '*' || op == '/'))
+			{
+				result = allocator.CreateObject<Vec3Object>(op == '*' ? l * toScalar(right) : l / toScalar(right));
+				return true;
+			}
+		}
+		else if (IS_QUAT_VALUE(left))
+		{
+			const Quaternionf &l = TO_QUAT_VALUE(left)->value;
+			if (IS_QUAT_VALUE(right))
+			{
+				const Quaternionf &r = TO_QUAT_VALUE(right)->value;
+				switch (op)
+				{
+				case '+':
+					result = allocator.CreateObject<QuatObject>(l + r);
+					return true;
+				case '-':
+					result = allocator.CreateObject<QuatObject>(l - r);
+					return true;
+				case '*':
+					result = allocator.CreateObject<QuatObject>(l * r);
+					return true;
+				}
+			}
+			else if (IS_VEC3_VALUE(right) && op == '*')
+			{
+				result = allocator.CreateObject<Vec3Object>(l * TO_VEC3_VALUE(right)->value);
+				return true;
+			}
+			else if (isScalar(right) && (op == '*' || op == '/'))
+			{
+				result = allocator.CreateObject<QuatObject>(op == '*' ? l * toScalar(right) : l / toScalar(right));
+				return true;
+			}
+		}
+		else if (IS_MAT4_VALUE(left))
+		{
+			const Matrix4f &l = TO_MAT4_VALUE(left)->value;
+			if (IS_MAT4_VALUE(right))
+			{
+				const Matrix4f &r = TO_MAT4_VALUE(right)->value;
+				switch (op)
+				{
+				case '+':
+					result = allocator.CreateObject<Mat4Object>(l + r);
+					return true;
+				case '-':
+					result = allocator.CreateObject<Mat4Object>(l - r);
+					return true;
+				case '*':
+					result = allocator.CreateObject<Mat4Object>(l * r);
+					return true;
+				}
+			}
+			else if (IS_VEC3_VALUE(right) && op == '*')
+			{
+				// Transforms a point, w is 1
+				result = allocator.CreateObject<Vec3Object>(Vector3f(l * Vector4f(TO_VEC3_VALUE(right)->value, 1.0f)));
+				return true;
+			}
+			else if (isScalar(right) && (op == '*' || op == '/'))
+			{
+				result = allocator.CreateObject<Mat4Object>(op == '*' ? l * toScalar(right) : l / toScalar(right));
+				return true;
+			}
+		}
+		else if (isScalar(left) && op == '*')
+		{
+			if (IS_VEC3_VALUE(right))
+			{
+				result = allocator.CreateObject<Vec3Object>(TO_VEC3_VALUE(right)->value * toScalar(left));
+				return true;
+			}
+			else if (IS_QUAT_VALUE(right))
+			{
+				result = allocator.CreateObject<QuatObject>(TO_QUAT_VALUE(right)->value * toScalar(left));
+				return true;
+			}
+			else if (IS_MAT4_VALUE(right))
+			{
+				result = allocator.CreateObject<Mat4Object>(TO_MAT4_VALUE(right)->value * toScalar(left));
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool VM::MathNegate(const Value &value, Value &result)
+	{
+		if (IS_VEC3_VALUE(value))
+			result = Allocator::GetInstance().CreateObject<Vec3Object>(-TO_VEC3_VALUE(value)->value);
+		else if (IS_QUAT_VALUE(value))
+			result = Allocator::GetInstance().CreateObject<QuatObject>(-TO_QUAT_VALUE(value)->value);
+		else
+			return false;
+		return true;
+	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include "Chunk.hpp"
@@ -11,11 +12,56 @@ namespace RealSix::Script
         constexpr VM() noexcept = default;
         constexpr ~VM() noexcept = default;
 
+        // Runs mainFunc within the execution budget of ScriptConfig. When the budget is used up the script stays
+        // suspended on the VM stacks and IsSuspended() is true, Continue() runs it further, typically once per frame.
+        // The return values come from the call which finishes the script
         std::vector<Value> Run(FunctionObject *mainFunc) noexcept;
+        std::vector<Value> Continue() noexcept;
+        bool IsSuspended() const noexcept;
 
-    private:
-        void Execute();
+        // Calls a script closure, bound class function or native function from native code while the VM is running,
+        // result receives the first return value
+        void Call(const Value &callee, const Value *args, uint32_t argCount, const Token *relatedToken, Value &result);
+
+        // Runs fiber until it yields or returns, result receives the yielded or returned value.
+        // value is the argument of a fiber which has not started yet, else the result of the yield it is suspended at
+        void Resume(FiberObject *fiber, const Value &value, const Token *relatedToken, Value &result);
 
         bool IsFalsey(const Value &v) noexcept;
+
+    private:
+        struct ExecutionBudget
+        {
+            static constexpr uint32_t CLOCK_CHECK_INTERVAL = 64;
+
+            // Called at every checkpoint, true once the budget is used up
+            inline bool Consume()
+            {
+                if (--checkpointCount == 0)
+                    return true;
+                if (hasDeadline && --clockCountdown == 0)
+                {
+                    clockCountdown = CLOCK_CHECK_INTERVAL;
+                    return std::chrono::steady_clock::now() >= deadline;
+                }
+                return false;
+            }
+
+            uint64_t checkpointCount{UINT64_MAX};
+            bool hasDeadline{false};
+            uint32_t clockCountdown{CLOCK_CHECK_INTERVAL};
+            std::chrono::steady_clock::time_point deadline{};
+        };
+
+        // Runs until the call frame count drops back to exitCallFrameCount.
+        // With a budget it may also return early at a loop back-edge or call, leaving the frames for the next Execute
+        void Execute(size_t exitCallFrameCount = 0, ExecutionBudget *budget = nullptr);
+
+        // Moves the frames, values and open upvalues of the running fiber off the VM stacks into the fiber
+        void SuspendFiber(FiberObject *fiber);
+
+        // + - * / and unary - on vec3, quat and mat4 values, false when the operands are no such pair
+        bool MathBinary(char op, const Value &left, const Value &right, Value &result);
+        bool MathNegate(const Value &value, Value &result);
     };
 }
\ No newline at end of file
@@ -118,7 +118,7 @@ namespace RealSix::Script
         case ValueKind::OBJECT:
         {
             if (IS_OBJECT_VALUE(right))
-                return TO_OBJECT_VALUE(left)->IsEqualTo(TO_OBJECT_VALUE(right));
+                return TO_OBJECT_VALUE(left) == TO_OBJECT_VALUE(right) || TO_OBJECT_VALUE(left)->IsEqualTo(TO_OBJECT_VALUE(right));
             else
                 return false;
         }
@@ -133,19 +133,42 @@ namespace RealSix::Script
         return !(left == right);
     }
 
+    // Math values compare by content, std::hash<float> also maps -0 and 0 to the same hash
+    static size_t HashFloats(const float *values, size_t count)
+    {
+        size_t seed = count;
+        for (size_t i = 0; i < count; ++i)
+            seed ^= std::hash<float>()(values[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+
     size_t ValueHash::operator()(const Value *v) const
     {
         switch (v->kind)
         {
         case ValueKind::NIL:
             return std::hash<ValueKind>()(v->kind);
+        // Keep consistent with operator==: integral floats hash as the equal integer, strings by content
         case ValueKind::INT:
-            return std::hash<ValueKind>()(v->kind) ^ std::hash<int64_t>()(v->integer);
+            return std::hash<int64_t>()(v->integer);
         case ValueKind::FLOAT:
-            return std::hash<ValueKind>()(v->kind) ^ std::hash<double>()(v->floating);
+        {
+            if (v->floating >= static_cast<double>(INT64_MIN) && v->floating < static_cast<double>(INT64_MAX) &&
+                static_cast<double>(static_cast<int64_t>(v->floating)) == v->floating)
+                return std::hash<int64_t>()(static_cast<int64_t>(v->floating));
+            return std::hash<double>()(v->floating);
+        }
         case ValueKind::BOOL:
             return std::hash<ValueKind>()(v->kind) ^ std::hash<bool>()(v->boolean);
         case ValueKind::OBJECT:
+            if (IS_STR_OBJ(v->object))
+                return TO_STR_OBJ(v->object)->GetValue().GetHash();
+            if (IS_VEC3_OBJ(v->object))
+                return HashFloats(TO_VEC3_OBJ(v->object)->value.values.data(), 3);
+            if (IS_QUAT_OBJ(v->object))
+                return HashFloats(TO_QUAT_OBJ(v->object)->value.values.data(), 4);
+            if (IS_MAT4_OBJ(v->object))
+                return HashFloats(TO_MAT4_OBJ(v->object)->value.elements.data(), 16);
             return std::hash<ValueKind>()(v->kind) ^ std::hash<Object *>()(v->object);
         default:
             return std::hash<ValueKind>()(v->kind);
@@ -0,0 +1,139 @@
+#include "ValueArray.hpp"
+#include <algorithm>
+#include <cmath>
+namespace RealSix::Script
+{
+	ValueArray::ValueArray(const Value *values, size_t count)
+	{
+		Reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			Push(values[i]);
+	}
+
+	ValueArray::ValueArray(const std::vector<Value> &values)
+		: ValueArray(values.data(), values.size())
+	{
+	}
+
+	void ValueArray::Push(const Value &value)
+	{
+		PrepareFor(value);
+		if (mKind == ArrayElementKind::GENERIC)
+			mValues.emplace_back(value);
+		else
+			mPacked.emplace_back(Pack(value));
+	}
+
+	void ValueArray::Insert(size_t idx, const Value &value)
+	{
+		PrepareFor(value);
+		if (mKind == ArrayElementKind::GENERIC)
+			mValues.insert(mValues.begin() + idx, value);
+		else
+			mPacked.insert(mPacked.begin() + idx, Pack(value));
+	}
+
+	void ValueArray::Erase(size_t idx)
+	{
+		if (mKind == ArrayElementKind::GENERIC)
+			mValues.erase(mValues.begin() + idx);
+		else
+			mPacked.erase(mPacked.begin() + idx);
+	}
+
+	void ValueArray::Reserve(size_t count)
+	{
+		if (mKind == ArrayElementKind::GENERIC)
+			mValues.reserve(count);
+		else
+			mPacked.reserve(count);
+	}
+
+	void ValueArray::Append(const ValueArray &other, size_t begin, size_t end)
+	{
+		if (begin >= end)
+			return;
+
+		if (other.mKind != ArrayElementKind::GENERIC && (mKind == other.mKind || mKind == ArrayElementKind::EMPTY || (mKind != ArrayElementKind::GENERIC && mPacked.empty())))
+		{
+			mKind = other.mKind;
+			mPacked.insert(mPacked.end(), other.mPacked.begin() + begin, other.mPacked.begin() + end);
+			return;
+		}
+
+		Reserve(Size() + end - begin);
+		for (size_t i = begin; i < end; ++i)
+			Push(other.Get(i));
+	}
+
+	bool ValueArray::SortPacked()
+	{
+		switch (mKind)
+		{
+		case ArrayElementKind::INT:
+			std::sort(mPacked.begin(), mPacked.end(), [](uint64_t left, uint64_t right)
+					  { return std::bit_cast<int64_t>(left) < std::bit_cast<int64_t>(right); });
+			return true;
+		case ArrayElementKind::FLOAT:
+			std::sort(mPacked.begin(), mPacked.end(), [](uint64_t left, uint64_t right)
+					  {
+						  // NaN sorts last, a plain < is no strict weak ordering with NaN around
+						  double l = std::bit_cast<double>(left), r = std::bit_cast<double>(right);
+						  return l < r || (!std::isnan(l) && std::isnan(r)); });
+			return true;
+		case ArrayElementKind::BOOL:
+			std::sort(mPacked.begin(), mPacked.end());
+			return true;
+		case ArrayElementKind::EMPTY:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	Value *ValueArray::GetRef(size_t idx)
+	{
+		TransitionToGeneric();
+		return &mValues[idx];
+	}
+
+	const uint64_t *ValueArray::GetPackedData() const
+	{
+		return mPacked.data();
+	}
+
+	const Value *ValueArray::GetValueData() const
+	{
+		return mValues.data();
+	}
+
+	void ValueArray::PrepareFor(const Value &value)
+	{
+		auto kind = GetPackedKind(value);
+		if (kind == mKind || mKind == ArrayElementKind::GENERIC)
+			return;
+
+		// An array emptied by erasing may pick a new packed kind
+		if (mKind == ArrayElementKind::EMPTY || (kind != ArrayElementKind::GENERIC && mPacked.empty()))
+		{
+			if (kind == ArrayElementKind::GENERIC)
+				mValues.reserve(mPacked.capacity());
+			mKind = kind;
+			return;
+		}
+
+		TransitionToGeneric();
+	}
+
+	void ValueArray::TransitionToGeneric()
+	{
+		if (mKind == ArrayElementKind::GENERIC)
+			return;
+
+		mValues.reserve(mPacked.capacity());
+		for (size_t i = 0; i < mPacked.size(); ++i)
+			mValues.emplace_back(Get(i));
+		std::vector<uint64_t>().swap(mPacked);
+		mKind = ArrayElementKind::GENERIC;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <bit>
+#include <vector>
+#include "Value.hpp"
+namespace RealSix::Script
+{
+    enum class ArrayElementKind : uint8_t
+    {
+        EMPTY,   // no element written yet, the first one decides the kind
+        INT,     // packed int64_t
+        FLOAT,   // packed double
+        BOOL,    // packed 0/1
+        GENERIC, // Value
+    };
+
+    // The storage of ArrayObject.
+    // Arrays whose elements all share one primitive kind are stored packed as raw 64 bit words, half the size
+    // of a Value and without per element tag checks. Writing an element of another kind, or taking a
+    // reference to an element (RefObject needs a Value *), transitions the array to generic Value storage
+    // for the rest of its life.
+    class REALSIX_API ValueArray
+    {
+    public:
+        ValueArray() = default;
+        ValueArray(const Value *values, size_t count);
+        ValueArray(const std::vector<Value> &values);
+        ~ValueArray() = default;
+
+        inline size_t Size() const
+        {
+            return mKind == ArrayElementKind::GENERIC ? mValues.size() : mPacked.size();
+        }
+
+        inline bool Empty() const
+        {
+            return Size() == 0;
+        }
+
+        inline ArrayElementKind GetKind() const
+        {
+            return mKind;
+        }
+
+        inline Value Get(size_t idx) const
+        {
+            switch (mKind)
+            {
+            case ArrayElementKind::INT:
+                return Value(std::bit_cast<int64_t>(mPacked[idx]));
+            case ArrayElementKind::FLOAT:
+                return Value(std::bit_cast<double>(mPacked[idx]));
+            case ArrayElementKind::BOOL:
+                return Value(mPacked[idx] != 0);
+            default:
+                return mValues[idx];
+            }
+        }
+
+        inline void Set(size_t idx, const Value &value)
+        {
+            if (mKind == ArrayElementKind::GENERIC)
+                mValues[idx] = value;
+            else if (GetPackedKind(value) == mKind)
+                mPacked[idx] = Pack(value);
+            else
+            {
+                TransitionToGeneric();
+                mValues[idx] = value;
+            }
+        }
+
+        void Push(const Value &value);
+        void Insert(size_t idx, const Value &value);
+        void Erase(size_t idx);
+        void Reserve(size_t count);
+        // Appends the elements in [begin, end) of other, a packed range of the same kind is copied as raw words
+        void Append(const ValueArray &other, size_t begin, size_t end);
+        // Sorts packed storage in ascending order, returns false for generic storage which needs a comparison
+        bool SortPacked();
+
+        // Pointer to the element for RefObject, transitions the array to generic storage
+        Value *GetRef(size_t idx);
+
+        // Packed storage when GetKind() is INT, FLOAT or BOOL
+        const uint64_t *GetPackedData() const;
+        // Generic storage when GetKind() is GENERIC
+        const Value *GetValueData() const;
+
+    private:
+        // The packed kind value can be stored as, GENERIC when it has to stay a Value
+        static inline ArrayElementKind GetPackedKind(const Value &value)
+        {
+            // Packing drops the permission, keep anything but plain mutable values generic
+            if (value.permission != Permission::MUTABLE)
+                return ArrayElementKind::GENERIC;
+
+            switch (value.kind)
+            {
+            case ValueKind::INT:
+                return ArrayElementKind::INT;
+            case ValueKind::FLOAT:
+                return ArrayElementKind::FLOAT;
+            case ValueKind::BOOL:
+                return ArrayElementKind::BOOL;
+            default:
+                return ArrayElementKind::GENERIC;
+            }
+        }
+
+        static inline uint64_t Pack(const Value &value)
+        {
+            switch (value.kind)
+            {
+            case ValueKind::INT:
+                return std::bit_cast<uint64_t>(value.integer);
+            case ValueKind::FLOAT:
+                return std::bit_cast<uint64_t>(value.floating);
+            default:
+                return value.boolean ? 1 : 0;
+            }
+        }
+
+        // Make value storable at the current kind, picking or transitioning the kind as needed
+        void PrepareFor(const Value &value);
+        void TransitionToGeneric();
+
+        ArrayElementKind mKind{ArrayElementKind::EMPTY};
+        std::vector<uint64_t> mPacked;
+        std::vector<Value> mValues;
+    };
+}
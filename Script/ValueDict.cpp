@@ -0,0 +1,206 @@
+#include "ValueDict.hpp"
+#include <algorithm>
+#include <bit>
+namespace RealSix::Script
+{
+	ValueDict::ValueDict(const ValueDict &other)
+	{
+		Reserve(other.Size());
+		for (const auto &[key, value] : other)
+			Set(key, value);
+	}
+
+	ValueDict &ValueDict::operator=(const ValueDict &other)
+	{
+		if (this != &other)
+		{
+			ValueDict copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	Value *ValueDict::Find(const Value &key)
+	{
+		auto hash = Hash(key);
+		auto slotIdx = FindSlot(key, hash);
+		if (slotIdx == mSlots.size())
+			return nullptr;
+		return &GetEntry(mSlots[slotIdx].entry)->value;
+	}
+
+	const Value *ValueDict::Find(const Value &key) const
+	{
+		return const_cast<ValueDict *>(this)->Find(key);
+	}
+
+	bool ValueDict::Contains(const Value &key) const
+	{
+		return Find(key) != nullptr;
+	}
+
+	Value &ValueDict::operator[](const Value &key)
+	{
+		auto hash = Hash(key);
+		auto slotIdx = FindSlot(key, hash);
+		if (slotIdx != mSlots.size())
+			return GetEntry(mSlots[slotIdx].entry)->value;
+		return Insert(key, Value(), hash);
+	}
+
+	bool ValueDict::Set(const Value &key, const Value &value)
+	{
+		auto hash = Hash(key);
+		auto slotIdx = FindSlot(key, hash);
+		if (slotIdx != mSlots.size())
+		{
+			GetEntry(mSlots[slotIdx].entry)->value = value;
+			return false;
+		}
+		Insert(key, value, hash);
+		return true;
+	}
+
+	bool ValueDict::Erase(const Value &key)
+	{
+		auto hash = Hash(key);
+		auto slotIdx = FindSlot(key, hash);
+		if (slotIdx == mSlots.size())
+			return false;
+
+		uint32_t entryIdx = mSlots[slotIdx].entry;
+		mSlots[slotIdx].entry = ERASED_SLOT;
+		mErasedSlotCount++;
+		mSize--;
+
+		// The page stays, a RefObject may still point into it
+		auto &page = mPages[entryIdx >> PAGE_SHIFT];
+		page->entries[entryIdx & (PAGE_SIZE - 1)] = Entry();
+		page->aliveMask &= ~(1u << (entryIdx & (PAGE_SIZE - 1)));
+		mFreeEntries.emplace_back(entryIdx);
+		return true;
+	}
+
+	void ValueDict::Reserve(size_t count)
+	{
+		if ((mSize + mErasedSlotCount + count) * 4 > mSlots.size() * 3)
+			Rehash(std::bit_ceil(std::max<size_t>(8, (mSize + count) * 2)));
+	}
+
+	void ValueDict::Clear()
+	{
+		std::vector<Slot>().swap(mSlots);
+		mPages.clear();
+		mFreeEntries.clear();
+		mEntryCount = 0;
+		mSize = 0;
+		mErasedSlotCount = 0;
+	}
+
+	size_t ValueDict::Size() const
+	{
+		return mSize;
+	}
+
+	bool ValueDict::Empty() const
+	{
+		return mSize == 0;
+	}
+
+	uint64_t ValueDict::Hash(const Value &key)
+	{
+		// ValueHash is mostly identity for integers, mix the bits so that low slot bits are well distributed
+		uint64_t hash = ValueHash()(key);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	size_t ValueDict::FindSlot(const Value &key, uint64_t hash) const
+	{
+		if (mSlots.empty())
+			return 0;
+
+		size_t mask = mSlots.size() - 1;
+		for (size_t slotIdx = hash & mask;; slotIdx = (slotIdx + 1) & mask)
+		{
+			const Slot &slot = mSlots[slotIdx];
+			if (slot.entry == EMPTY_SLOT)
+				return mSlots.size();
+			if (slot.entry != ERASED_SLOT && slot.hash == static_cast<uint32_t>(hash) && GetEntry(slot.entry)->key == key)
+				return slotIdx;
+		}
+	}
+
+	Value &ValueDict::Insert(const Value &key, const Value &value, uint64_t hash)
+	{
+		Reserve(1);
+
+		uint32_t entryIdx;
+		if (!mFreeEntries.empty())
+		{
+			entryIdx = mFreeEntries.back();
+			mFreeEntries.pop_back();
+		}
+		else
+		{
+			if ((mEntryCount & (PAGE_SIZE - 1)) == 0)
+				mPages.emplace_back(std::make_unique<Page>());
+			entryIdx = mEntryCount++;
+		}
+
+		auto &page = mPages[entryIdx >> PAGE_SHIFT];
+		auto &entry = page->entries[entryIdx & (PAGE_SIZE - 1)];
+		entry.key = key;
+		entry.value = value;
+		page->aliveMask |= 1u << (entryIdx & (PAGE_SIZE - 1));
+
+		size_t mask = mSlots.size() - 1;
+		size_t slotIdx = hash & mask;
+		while (mSlots[slotIdx].entry != EMPTY_SLOT)
+			slotIdx = (slotIdx + 1) & mask;
+		mSlots[slotIdx].hash = static_cast<uint32_t>(hash);
+		mSlots[slotIdx].entry = entryIdx;
+
+		mSize++;
+		return entry.value;
+	}
+
+	void ValueDict::Rehash(size_t capacity)
+	{
+		// Slots keep the low hash bits, so keys are moved over without hashing them again
+		std::vector<Slot> oldSlots(capacity);
+		oldSlots.swap(mSlots);
+		mErasedSlotCount = 0;
+
+		size_t mask = capacity - 1;
+		for (const auto &oldSlot : oldSlots)
+		{
+			if (oldSlot.entry == EMPTY_SLOT || oldSlot.entry == ERASED_SLOT)
+				continue;
+			size_t slotIdx = oldSlot.hash & mask;
+			while (mSlots[slotIdx].entry != EMPTY_SLOT)
+				slotIdx = (slotIdx + 1) & mask;
+			mSlots[slotIdx].hash = oldSlot.hash;
+			mSlots[slotIdx].entry = oldSlot.entry;
+		}
+	}
+
+	ValueDict::Entry *ValueDict::GetEntry(uint64_t entryIdx) const
+	{
+		return &mPages[entryIdx >> PAGE_SHIFT]->entries[entryIdx & (PAGE_SIZE - 1)];
+	}
+
+	uint64_t ValueDict::NextAliveEntry(uint64_t entryIdx) const
+	{
+		while (entryIdx < mEntryCount)
+		{
+			uint32_t aliveMask = mPages[entryIdx >> PAGE_SHIFT]->aliveMask >> (entryIdx & (PAGE_SIZE - 1));
+			if (aliveMask != 0)
+				return entryIdx + std::countr_zero(aliveMask);
+			entryIdx = ((entryIdx >> PAGE_SHIFT) + 1) << PAGE_SHIFT;
+		}
+		return mEntryCount;
+	}
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "Value.hpp"
+namespace RealSix::Script
+{
+    // Open addressing hash table from Value to Value, the storage of DictObject.
+    // Entries live in fixed size pages which are never moved or released before the table goes away, the slot
+    // table only holds entry indices, so a Value * into the table (RefObject) stays valid across inserts, erases
+    // and rehashes. Entries are iterated in insertion order until a key is erased, the next insert reuses its entry.
+    class REALSIX_API ValueDict
+    {
+    public:
+        struct Entry
+        {
+            Value key;
+            Value value;
+        };
+
+        template <typename DictType, typename EntryType>
+        class EntryIterator
+        {
+        public:
+            EntryIterator(DictType *dict, uint64_t entryIdx)
+                : mDict(dict), mEntryIdx(entryIdx)
+            {
+                SkipDead();
+            }
+
+            EntryType &operator*() const { return *mDict->GetEntry(mEntryIdx); }
+            EntryType *operator->() const { return mDict->GetEntry(mEntryIdx); }
+
+            EntryIterator &operator++()
+            {
+                ++mEntryIdx;
+                SkipDead();
+                return *this;
+            }
+
+            bool operator==(const EntryIterator &other) const { return mEntryIdx == other.mEntryIdx; }
+            bool operator!=(const EntryIterator &other) const { return mEntryIdx != other.mEntryIdx; }
+
+        private:
+            void SkipDead()
+            {
+                mEntryIdx = mDict->NextAliveEntry(mEntryIdx);
+            }
+
+            DictType *mDict;
+            uint64_t mEntryIdx;
+        };
+
+        using Iterator = EntryIterator<ValueDict, Entry>;
+        using ConstIterator = EntryIterator<const ValueDict, const Entry>;
+
+        ValueDict() = default;
+        ValueDict(const ValueDict &other);
+        ValueDict(ValueDict &&other) noexcept = default;
+        ~ValueDict() = default;
+
+        ValueDict &operator=(const ValueDict &other);
+        ValueDict &operator=(ValueDict &&other) noexcept = default;
+
+        Value *Find(const Value &key);
+        const Value *Find(const Value &key) const;
+        bool Contains(const Value &key) const;
+
+        // Return the value of key, inserting a null value first when key is absent
+        Value &operator[](const Value &key);
+
+        // Insert or overwrite, returns false when the key was already present
+        bool Set(const Value &key, const Value &value);
+        bool Erase(const Value &key);
+
+        void Reserve(size_t count);
+        void Clear();
+
+        size_t Size() const;
+        bool Empty() const;
+
+        Iterator begin() { return Iterator(this, 0); }
+        Iterator end() { return Iterator(this, mEntryCount); }
+        ConstIterator begin() const { return ConstIterator(this, 0); }
+        ConstIterator end() const { return ConstIterator(this, mEntryCount); }
+
+    private:
+        template <typename DictType, typename EntryType>
+        friend class EntryIterator;
+
+        static constexpr uint32_t PAGE_SHIFT = 5;
+        static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+        static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+        static constexpr uint32_t ERASED_SLOT = UINT32_MAX - 1;
+
+        struct Page
+        {
+            Entry entries[PAGE_SIZE];
+            uint32_t aliveMask{0};
+        };
+
+        struct Slot
+        {
+            uint32_t hash{0};           // low bits of the key hash, the slot table never exceeds 2^32 slots
+            uint32_t entry{EMPTY_SLOT}; // entry index, or EMPTY_SLOT/ERASED_SLOT
+        };
+
+        static uint64_t Hash(const Value &key);
+
+        // Slot index holding key, or the slot table capacity when key is absent
+        size_t FindSlot(const Value &key, uint64_t hash) const;
+        // Store an absent key in a free entry, or append one when none is free, so the entry count is
+        // bounded by the largest size the table had
+        Value &Insert(const Value &key, const Value &value, uint64_t hash);
+        void Rehash(size_t capacity);
+
+        Entry *GetEntry(uint64_t entryIdx) const;
+        uint64_t NextAliveEntry(uint64_t entryIdx) const;
+
+        std::vector<Slot> mSlots;
+        std::vector<std::unique_ptr<Page>> mPages;
+        std::vector<uint32_t> mFreeEntries; // erased entries, reused by the next inserts
+        uint32_t mEntryCount{0};            // entries handed out so far, alive or free
+        size_t mSize{0};
+        size_t mErasedSlotCount{0};
+    };
+}
@@ -0,0 +1,266 @@
+#include <chrono>
+#include <format>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Core/Logger.hpp"
+#include "Core/FlatMap.hpp"
+#include "Core/HashMap.hpp"
+#include "Core/Memory.hpp"
+#include "Core/SmallVector.hpp"
+
+using namespace RealSix;
+
+// Compare the Core containers with the std ones they replace on hot paths
+
+volatile int64_t gSink; // keeps the measured loops from being optimized away
+
+template <typename Fn>
+double Measure(uint32_t iterations, Fn &&fn)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+// A frame graph like pattern: every task collects a handful of resource pointers and walks them once
+template <typename List>
+double RunSmallLists(const std::vector<int64_t *> &resources, size_t tasks, size_t listSize, uint32_t iterations)
+{
+	return Measure(iterations, [&]()
+				   {
+					   int64_t checksum = 0;
+					   for (size_t task = 0; task < tasks; ++task)
+					   {
+						   List reads;
+						   for (size_t i = 0; i < listSize; ++i)
+							   reads.push_back(resources[(task + i * 7) % resources.size()]);
+						   for (auto resource : reads)
+							   checksum += *resource;
+					   }
+					   gSink = checksum; });
+}
+
+// Transient lists of a known size on the heap, the frame arena and the scratch arena. Grown memory of
+// a frame arena list is only released with the frame, so the lists reserve up front like real users would
+std::vector<double> RunTransientLists(const std::vector<int64_t *> &resources, size_t lists, size_t listSize, uint32_t iterations)
+{
+	int64_t checksum = 0;
+	auto fill = [&](auto &values, size_t list)
+	{
+		values.reserve(listSize);
+		for (size_t i = 0; i < listSize; ++i)
+			values.push_back(resources[(list + i * 7) % resources.size()]);
+		for (auto resource : values)
+			checksum += *resource;
+	};
+
+	std::vector<double> result;
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t list = 0; list < lists; ++list)
+									{
+										std::vector<int64_t *> values;
+										fill(values, list);
+									} }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									FrameAllocator::GetInstance().BeginFrame();
+									for (size_t list = 0; list < lists; ++list)
+									{
+										FrameVector<int64_t *> values(FrameAllocator::GetInstance());
+										fill(values, list);
+									} }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t list = 0; list < lists; ++list)
+									{
+										ScratchScope scratch;
+										ScratchVector<int64_t *> values(scratch.GetAllocator<int64_t *>());
+										fill(values, list);
+									} }));
+
+	gSink = checksum;
+	return result;
+}
+
+// Best time of each workload in milliseconds: build, lookup hit, lookup miss, iterate
+template <typename Map, typename Key>
+std::vector<double> RunMapWorkloads(const std::vector<Key> &keys, const std::vector<Key> &missKeys, size_t rounds, uint32_t iterations)
+{
+	std::vector<double> result;
+	int64_t checksum = 0;
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t round = 0; round < rounds; ++round)
+									{
+										Map map;
+										for (size_t i = 0; i < keys.size(); ++i)
+											map[keys[i]] = static_cast<int64_t>(i);
+										checksum += map.size();
+									} }));
+
+	Map map;
+	for (size_t i = 0; i < keys.size(); ++i)
+		map[keys[i]] = static_cast<int64_t>(i);
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t round = 0; round < rounds; ++round)
+										for (const auto &key : keys)
+											checksum += map.find(key)->second; }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t round = 0; round < rounds; ++round)
+										for (const auto &key : missKeys)
+											checksum += map.find(key) != map.end(); }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (size_t round = 0; round < rounds; ++round)
+										for (const auto &[k, v] : map)
+											checksum += v; }));
+
+	gSink = checksum;
+	return result;
+}
+
+// Insert, erase and insert/erase churn, the workloads where the node maps allocate
+template <typename Map, typename Key>
+std::vector<double> RunChurnWorkloads(const std::vector<Key> &keys, uint32_t iterations)
+{
+	std::vector<double> result;
+	int64_t checksum = 0;
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									Map map;
+									for (size_t i = 0; i < keys.size(); ++i)
+										map[keys[i]] = static_cast<int64_t>(i);
+									for (const auto &key : keys)
+										map.erase(key);
+									checksum += map.size(); }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									Map window;
+									size_t windowSize = std::max<size_t>(keys.size() / 16, 1);
+									for (size_t i = 0; i < keys.size(); ++i)
+									{
+										window[keys[i]] = static_cast<int64_t>(i);
+										if (i >= windowSize)
+											window.erase(keys[i - windowSize]);
+									}
+									checksum += window.size(); }));
+
+	gSink = checksum;
+	return result;
+}
+
+int32_t main(int32_t argc, const char *argv[])
+{
+	size_t count = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 200000;
+	uint32_t iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 5;
+
+	std::mt19937_64 random(20240601);
+
+	// SmallVector against std::vector for the per task lists of a frame graph
+	std::vector<int64_t> storage(64);
+	std::vector<int64_t *> resources;
+	for (auto &value : storage)
+	{
+		value = static_cast<int64_t>(random() & 0xff);
+		resources.push_back(&value);
+	}
+
+	Logger::Println("{} lists per run, best of {} runs, milliseconds", count, iterations);
+	Logger::Println("{}", std::format("{:<10}{:>14}{:>14}{:>10}", "elements", "std::vector", "SmallVector", "speedup"));
+	for (size_t listSize : {2, 4, 8, 16})
+	{
+		double vector = RunSmallLists<std::vector<int64_t *>>(resources, count, listSize, iterations);
+		double small = RunSmallLists<SmallVector<int64_t *, 8>>(resources, count, listSize, iterations);
+		Logger::Println("{}", std::format("{:<10}{:>14.3f}{:>14.3f}{:>9.2f}x", listSize, vector, small, vector / small));
+	}
+
+	// Frame and scratch arenas against the heap for lists too long for inline storage
+	Logger::Println("");
+	Logger::Println("{} transient lists per run, best of {} runs, milliseconds", count / 64, iterations);
+	Logger::Println("{}", std::format("{:<10}{:>14}{:>14}{:>14}{:>10}", "elements", "std::vector", "FrameVector", "ScratchVector", "speedup"));
+	for (size_t listSize : {16, 64, 256})
+	{
+		auto times = RunTransientLists(resources, count / 64, listSize, iterations);
+		Logger::Println("{}", std::format("{:<10}{:>14.3f}{:>14.3f}{:>14.3f}{:>9.2f}x", listSize, times[0], times[1], times[2], times[0] / std::min(times[1], times[2])));
+	}
+
+	// FlatMap against the node maps for small, mostly read tables like the descriptor bindings of a shader
+	const char *mapWorkloadNames[] = {"build", "lookup", "miss", "iterate"};
+	for (size_t tableSize : {8, 32, 128})
+	{
+		std::vector<uint32_t> keys, missKeys;
+		for (size_t i = 0; i < tableSize; ++i)
+		{
+			keys.emplace_back(static_cast<uint32_t>(random()));
+			missKeys.emplace_back(static_cast<uint32_t>(random()));
+		}
+		size_t rounds = std::max<size_t>(count / tableSize, 1);
+
+		auto map = RunMapWorkloads<std::map<uint32_t, int64_t>>(keys, missKeys, rounds, iterations);
+		auto unorderedMap = RunMapWorkloads<std::unordered_map<uint32_t, int64_t>>(keys, missKeys, rounds, iterations);
+		auto flatMap = RunMapWorkloads<FlatMap<uint32_t, int64_t>>(keys, missKeys, rounds, iterations);
+		auto hashMap = RunMapWorkloads<HashMap<uint32_t, int64_t>>(keys, missKeys, rounds, iterations);
+
+		Logger::Println("");
+		Logger::Println("{} entries, {} rounds, milliseconds", tableSize, rounds);
+		Logger::Println("{}", std::format("{:<10}{:>12}{:>15}{:>12}{:>12}", "workload", "std::map", "unordered_map", "FlatMap", "HashMap"));
+		for (size_t i = 0; i < std::size(mapWorkloadNames); ++i)
+			Logger::Println("{}", std::format("{:<10}{:>12.3f}{:>15.3f}{:>12.3f}{:>12.3f}", mapWorkloadNames[i], map[i], unorderedMap[i], flatMap[i], hashMap[i]));
+	}
+
+	// HashMap against std::unordered_map for large tables
+	std::vector<uint64_t> intKeys, intMissKeys;
+	std::vector<std::string> strKeys, strMissKeys;
+	for (size_t i = 0; i < count; ++i)
+	{
+		intKeys.emplace_back(random() >> 1);
+		intMissKeys.emplace_back(random() >> 1);
+		strKeys.emplace_back(std::format("key_{}", i));
+		strMissKeys.emplace_back(std::format("miss_{}", i));
+	}
+
+	auto intMap = RunMapWorkloads<std::unordered_map<uint64_t, int64_t>>(intKeys, intMissKeys, 1, iterations);
+	auto intHash = RunMapWorkloads<HashMap<uint64_t, int64_t>>(intKeys, intMissKeys, 1, iterations);
+	auto strMap = RunMapWorkloads<std::unordered_map<std::string, int64_t>>(strKeys, strMissKeys, 1, iterations);
+	auto strHash = RunMapWorkloads<HashMap<std::string, int64_t>>(strKeys, strMissKeys, 1, iterations);
+	auto intMapChurn = RunChurnWorkloads<std::unordered_map<uint64_t, int64_t>>(intKeys, iterations);
+	auto intHashChurn = RunChurnWorkloads<HashMap<uint64_t, int64_t>>(intKeys, iterations);
+	auto strMapChurn = RunChurnWorkloads<std::unordered_map<std::string, int64_t>>(strKeys, iterations);
+	auto strHashChurn = RunChurnWorkloads<HashMap<std::string, int64_t>>(strKeys, iterations);
+	intMap.insert(intMap.end(), intMapChurn.begin(), intMapChurn.end());
+	intHash.insert(intHash.end(), intHashChurn.begin(), intHashChurn.end());
+	strMap.insert(strMap.end(), strMapChurn.begin(), strMapChurn.end());
+	strHash.insert(strHash.end(), strHashChurn.begin(), strHashChurn.end());
+
+	const char *hashWorkloadNames[] = {"insert", "lookup", "miss", "iterate", "erase", "churn"};
+
+	Logger::Println("");
+	Logger::Println("{} keys, unordered_map against HashMap, milliseconds", count);
+	Logger::Println("{}", std::format("{:<10}{:>12}{:>12}{:>10}{:>12}{:>12}{:>10}", "workload", "int map", "int hash", "speedup", "str map", "str hash", "speedup"));
+	for (size_t i = 0; i < std::size(hashWorkloadNames); ++i)
+		Logger::Println("{}", std::format("{:<10}{:>12.3f}{:>12.3f}{:>9.2f}x{:>12.3f}{:>12.3f}{:>9.2f}x", hashWorkloadNames[i],
+										  intMap[i], intHash[i], intMap[i] / intHash[i],
+										  strMap[i], strHash[i], strMap[i] / strHash[i]));
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Core/Logger.hpp"
+#include "Core/JobSystem.hpp"
+#include "Animation/Pose.hpp"
+
+using namespace RealSix;
+
+// Scaling of the job system over the matrix palettes of a crowd, and its per job overhead
+
+volatile float gSink; // keeps the measured loops from being optimized away
+
+template <typename Fn>
+double Measure(uint32_t iterations, Fn &&fn)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+// Dependent jobs must see everything their dependency wrote, main thread jobs must run on the main thread
+bool CheckDependencies(uint32_t jobCount)
+{
+	std::atomic<uint32_t> produced{0};
+	uint32_t consumed = 0;
+	bool onMainThread = false;
+
+	JobCounter producers, consumer, mainThread;
+	for (uint32_t i = 0; i < jobCount; ++i)
+		JobSystem::GetInstance().Schedule([&]()
+										  { produced.fetch_add(1, std::memory_order_relaxed); }, &producers);
+	JobSystem::GetInstance().Schedule([&]()
+									  { consumed = produced.load(std::memory_order_relaxed); }, &consumer, &producers);
+	JobSystem::GetInstance().ScheduleOnMainThread([&]()
+												  { onMainThread = JobSystem::GetInstance().IsMainThread(); }, &mainThread, &consumer);
+	JobSystem::GetInstance().Wait(mainThread);
+	JobSystem::GetInstance().Wait(consumer);
+	JobSystem::GetInstance().Wait(producers);
+
+	return consumed == jobCount && onMainThread;
+}
+
+int32_t main(int32_t argc, const char *argv[])
+{
+	size_t characterCount = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 2000;
+	uint32_t iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 5;
+	constexpr uint32_t BONE_COUNT = 64;
+
+	std::mt19937 random(20240601);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	std::vector<Pose> poses(characterCount, Pose(BONE_COUNT));
+	for (auto &pose : poses)
+	{
+		for (uint32_t i = 0; i < BONE_COUNT; ++i)
+		{
+			pose.SetParent(i, i == 0 ? -1 : static_cast<int>(random() % i));
+			Quaternionf rotation = Quaternionf::Normalize(Quaternionf(distribution(random), distribution(random), distribution(random), distribution(random)));
+			pose.SetLocalTransform(i, Transform3f(Vector3f(distribution(random), distribution(random), distribution(random)), rotation, Vector3f(1.0f)));
+		}
+	}
+	std::vector<Matrix4f> palettes(characterCount * BONE_COUNT);
+
+	auto sample = [&](size_t character)
+	{
+		poses[character].GetMatrixPalette(std::span<Matrix4f>(palettes.data() + character * BONE_COUNT, BONE_COUNT));
+	};
+
+	double serial = Measure(iterations, [&]()
+							{
+								for (size_t character = 0; character < characterCount; ++character)
+									sample(character);
+								gSink = palettes.back().elements[12]; });
+
+	uint32_t maxThreads = argc > 3 ? std::max(std::atoi(argv[3]), 1) : JobSystem::GetDefaultWorkerCount() + 1;
+	Logger::Println("{} characters of {} bones, best of {} runs, milliseconds", characterCount, BONE_COUNT, iterations);
+	Logger::Println("{}", std::format("{:<10}{:>12}{:>12}{:>10}{:>16}{:>14}", "threads", "serial", "ParallelFor", "speedup", "empty job (us)", "dependencies"));
+	for (uint32_t threads = 1; threads <= maxThreads; threads = threads == maxThreads ? threads + 1 : std::min(threads * 2, maxThreads))
+	{
+		JobSystem::GetInstance().Init(threads - 1);
+
+		double parallel = Measure(iterations, [&]()
+								  {
+									  JobSystem::GetInstance().ParallelFor(characterCount, sample);
+									  gSink = palettes.back().elements[12]; });
+
+		constexpr uint32_t EMPTY_JOB_COUNT = 100000;
+		double overhead = Measure(iterations, [&]()
+								  {
+									  JobCounter counter;
+									  for (uint32_t i = 0; i < EMPTY_JOB_COUNT; ++i)
+										  JobSystem::GetInstance().Schedule([]() {}, &counter);
+									  JobSystem::GetInstance().Wait(counter); });
+
+		bool dependencies = CheckDependencies(256);
+		Logger::Println("{}", std::format("{:<10}{:>12.3f}{:>12.3f}{:>9.2f}x{:>16.3f}{:>14}", threads, serial, parallel, serial / parallel,
+										  overhead * 1000.0 / EMPTY_JOB_COUNT, dependencies ? "ok" : "FAILED"));
+
+		JobSystem::GetInstance().Shutdown();
+	}
+
+	return EXIT_SUCCESS;
+}
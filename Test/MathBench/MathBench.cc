@@ -0,0 +1,492 @@
+#include <chrono>
+#include <format>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Core/Logger.hpp"
+#include "Math/BatchMath.hpp"
+#include "Math/DualQuaternion.hpp"
+#include "Math/FastMath.hpp"
+#include "Math/Matrix4.hpp"
+#include "Math/Matrix3.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/Random.hpp"
+#include "Math/Transform.hpp"
+#include "Math/Vector3.hpp"
+#include "Math/Vector4.hpp"
+
+using namespace RealSix;
+
+// Compare the SIMD Matrix4f kernels with the scalar code they replaced
+
+volatile float gSink; // keeps the measured loops from being optimized away
+
+namespace Scalar
+{
+	Matrix4f Mul(const Matrix4f &left, const Matrix4f &right)
+	{
+		Matrix4f tmp;
+		for (uint8_t i = 0; i < 4; ++i)
+			for (uint8_t j = 0; j < 4; ++j)
+				tmp.elements[i * 4 + j] = left.elements[j] * right.elements[i * 4] + left.elements[4 + j] * right.elements[i * 4 + 1] + left.elements[8 + j] * right.elements[i * 4 + 2] + left.elements[12 + j] * right.elements[i * 4 + 3];
+		return tmp;
+	}
+
+	Vector4f Mul(const Matrix4f &matrix, const Vector4f &vec)
+	{
+		return Vector4f(matrix.elements[0] * vec.x + matrix.elements[4] * vec.y + matrix.elements[8] * vec.z + matrix.elements[12] * vec.w,
+						matrix.elements[1] * vec.x + matrix.elements[5] * vec.y + matrix.elements[9] * vec.z + matrix.elements[13] * vec.w,
+						matrix.elements[2] * vec.x + matrix.elements[6] * vec.y + matrix.elements[10] * vec.z + matrix.elements[14] * vec.w,
+						matrix.elements[3] * vec.x + matrix.elements[7] * vec.y + matrix.elements[11] * vec.z + matrix.elements[15] * vec.w);
+	}
+
+	Matrix4f Transpose(const Matrix4f &right)
+	{
+		Matrix4f tmp;
+		for (uint8_t i = 0; i < 4; ++i)
+			for (uint8_t j = 0; j < 4; ++j)
+				tmp.elements[i * 4 + j] = right.elements[j * 4 + i];
+		return tmp;
+	}
+
+	// Cofactor expansion through 16 3x3 determinants
+	Matrix4f Inverse(const Matrix4f &right)
+	{
+		Matrix4f tmp = Transpose(Matrix4f::Adjoint(right));
+		float invDet = 1.0f / Matrix4f::Determinant(right);
+		for (uint8_t i = 0; i < 16; ++i)
+			tmp.elements[i] *= invDet;
+		return tmp;
+	}
+}
+
+template <typename Fn>
+double Measure(uint32_t iterations, Fn &&fn)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+// Accuracy against the double precision std library and the time of std float, FastMath float and FastMath Float4
+// over the same inputs for every precision, fast is called with the precision as an integral_constant
+template <typename Standard, typename Reference, typename Fast>
+void ReportFastMath(const char *name, bool relative, const std::vector<float> &x, const std::vector<float> &y, uint32_t iterations, Standard standard, Reference reference, Fast fast)
+{
+	std::vector<float> out(x.size());
+	double standardTime = Measure(iterations, [&]()
+								  { for (size_t i = 0; i < x.size(); ++i) out[i] = standard(x[i], y[i]); gSink = out[0]; });
+
+	auto report = [&](auto precision, const char *precisionName)
+	{
+		double scalarTime = Measure(iterations, [&]()
+									{ for (size_t i = 0; i < x.size(); ++i) out[i] = fast(precision, x[i], y[i]); gSink = out[0]; });
+
+		double error = 0.0;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			double expected = reference(static_cast<double>(x[i]), static_cast<double>(y[i]));
+			double difference = std::abs(static_cast<double>(out[i]) - expected);
+			error = std::max(error, relative ? difference / std::abs(expected) : difference);
+		}
+
+		double simdTime = Measure(iterations, [&]()
+								  { for (size_t i = 0; i + 4 <= x.size(); i += 4) Simd::Store(out.data() + i, fast(precision, Simd::Load(x.data() + i), Simd::Load(y.data() + i))); gSink = out[0]; });
+
+		// The Float4 variant has to agree with the scalar one up to the hardware estimates
+		float laneError = 0.0f;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			float expected = fast(precision, x[i], y[i]);
+			laneError = std::max(laneError, Math::Abs(out[i] - expected) / std::max(1.0f, Math::Abs(expected)));
+		}
+
+		Logger::Println("{}", std::format("{:<8}{:>8}{:>10}{:>12.2e}{:>10.3f}{:>10.3f}{:>10.3f}{:>9.2f}x{:>9.2f}x{:>11.1e}", name, precisionName, relative ? "rel" : "abs", error,
+										  standardTime, scalarTime, simdTime, standardTime / scalarTime, standardTime / simdTime, laneError));
+	};
+	report(std::integral_constant<FastMathPrecision, FastMathPrecision::LOW>(), "low");
+	report(std::integral_constant<FastMathPrecision, FastMathPrecision::MEDIUM>(), "medium");
+	report(std::integral_constant<FastMathPrecision, FastMathPrecision::HIGH>(), "high");
+}
+
+float MaxError(const Matrix4f &left, const Matrix4f &right)
+{
+	float result = 0.0f;
+	for (uint8_t i = 0; i < 16; ++i)
+		result = std::max(result, Math::Abs(left.elements[i] - right.elements[i]) / (1.0f + Math::Abs(right.elements[i])));
+	return result;
+}
+
+int32_t main(int32_t argc, const char *argv[])
+{
+	size_t count = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 4096;
+	uint32_t iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 50;
+
+	// Affine matrices like the ones of a pose palette: rotation, non uniform scale and translation
+	std::mt19937 random(20240601);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	std::vector<Matrix4f> matrices(count), results(count);
+	std::vector<Vector4f> vectors(count), vectorResults(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		Vector3f axis = Vector3f::Normalize(Vector3f(distribution(random), distribution(random), distribution(random) + 2.0f));
+		matrices[i] = Matrix4f::Translate(Vector3f(distribution(random), distribution(random), distribution(random)) * 10.0f) *
+					  Matrix4f::Rotate(axis, distribution(random) * Math::PI) *
+					  Matrix4f::Scale(Vector3f(1.5f + distribution(random), 1.5f + distribution(random), 1.5f + distribution(random)));
+		vectors[i] = Vector4f(distribution(random), distribution(random), distribution(random), 1.0f);
+	}
+
+	struct Workload
+	{
+		const char *name;
+		double scalar;
+		double simd;
+		float error;
+	};
+	std::vector<Workload> workloads;
+
+	auto checksum = [&]()
+	{
+		float sum = 0.0f;
+		for (const auto &m : results)
+			sum += m.elements[0] + m.elements[13];
+		for (const auto &v : vectorResults)
+			sum += v.x + v.w;
+		gSink = sum;
+	};
+
+	auto compare = [&](const char *name, auto &&scalarFn, auto &&simdFn)
+	{
+		Workload workload{name, 0.0, 0.0, 0.0f};
+		workload.scalar = Measure(iterations, [&]()
+								  { scalarFn(); checksum(); });
+		std::vector<Matrix4f> expected = results;
+		std::vector<Vector4f> expectedVectors = vectorResults;
+		workload.simd = Measure(iterations, [&]()
+								{ simdFn(); checksum(); });
+		for (size_t i = 0; i < count; ++i)
+		{
+			workload.error = std::max(workload.error, MaxError(results[i], expected[i]));
+			for (uint8_t j = 0; j < 4; ++j)
+				workload.error = std::max(workload.error, Math::Abs(vectorResults[i].values[j] - expectedVectors[i].values[j]) / (1.0f + Math::Abs(expectedVectors[i].values[j])));
+		}
+		workloads.emplace_back(workload);
+	};
+
+	compare("mul", [&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Scalar::Mul(matrices[i], matrices[count - 1 - i]); },
+			[&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = matrices[i] * matrices[count - 1 - i]; });
+
+	compare("mul-vec", [&]()
+			{ for (size_t i = 0; i < count; ++i) vectorResults[i] = Scalar::Mul(matrices[i], vectors[i]); },
+			[&]()
+			{ for (size_t i = 0; i < count; ++i) vectorResults[i] = matrices[i] * vectors[i]; });
+
+	compare("transpose", [&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Scalar::Transpose(matrices[i]); },
+			[&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Matrix4f::Transpose(matrices[i]); });
+
+	compare("inverse", [&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Scalar::Inverse(matrices[i]); },
+			[&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Matrix4f::Inverse(matrices[i]); });
+
+	compare("inv-affine", [&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Scalar::Inverse(matrices[i]); },
+			[&]()
+			{ for (size_t i = 0; i < count; ++i) results[i] = Matrix4f::InverseAffine(matrices[i]); });
+
+	Logger::Println("{} matrices, best of {} runs, milliseconds", count, iterations);
+	Logger::Println("{}", std::format("{:<12}{:>12}{:>12}{:>10}{:>14}", "workload", "scalar", "simd", "speedup", "max rel error"));
+	for (const auto &workload : workloads)
+		Logger::Println("{}", std::format("{:<12}{:>12.3f}{:>12.3f}{:>9.2f}x{:>14.2e}", workload.name, workload.scalar, workload.simd, workload.scalar / workload.simd, workload.error));
+
+	// BatchMath over structure of arrays streams, every supported path against one AoS call per element
+	std::vector<float> xs(count), ys(count), zs(count), outXs(count), outYs(count), outZs(count), factors(count);
+	std::vector<float> quatA[4], quatB[4], quatOut[4];
+	std::vector<Quaternionf> quatsA(count), quatsB(count), quatResults(count);
+	std::vector<Vector3f> points(count), pointResults(count);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		quatA[i].resize(count);
+		quatB[i].resize(count);
+		quatOut[i].resize(count);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		points[i] = Vector3f(distribution(random), distribution(random), distribution(random)) * 10.0f;
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+		zs[i] = points[i].z;
+		quatsA[i] = Quaternionf::Normalize(Quaternionf(distribution(random), distribution(random), distribution(random), distribution(random)));
+		quatsB[i] = Quaternionf::Normalize(Quaternionf(distribution(random), distribution(random), distribution(random), distribution(random)));
+		factors[i] = distribution(random) * 0.5f + 0.5f;
+		for (size_t j = 0; j < 4; ++j)
+		{
+			quatA[j][i] = quatsA[i].values[j];
+			quatB[j][i] = quatsB[i].values[j];
+		}
+	}
+
+	const Matrix4f &matrix = matrices[0];
+	double transformAoS = Measure(iterations, [&]()
+								  { for (size_t i = 0; i < count; ++i) pointResults[i] = Matrix4f::TransformPoint(matrix, points[i]); gSink = pointResults[count - 1].x; });
+	double normalizeAoS = Measure(iterations, [&]()
+								  { for (size_t i = 0; i < count; ++i) pointResults[i] = Vector3f::Normalize(points[i]); gSink = pointResults[count - 1].x; });
+	double slerpAoS = Measure(iterations, [&]()
+							  { for (size_t i = 0; i < count; ++i) quatResults[i] = Quaternionf::Slerp(quatsA[i], quatsB[i], factors[i]); gSink = quatResults[count - 1].x; });
+
+	Logger::Println("");
+	Logger::Println("{} elements, batch path against AoS, milliseconds", count);
+	Logger::Println("{}", std::format("{:<12}{:>8}{:>12}{:>12}{:>10}", "workload", "path", "aos", "batch", "speedup"));
+	BatchMathPath bestPath = BatchMath::GetPath();
+	for (BatchMathPath path : {BatchMathPath::SCALAR, BatchMathPath::SSE4, BatchMathPath::AVX2, BatchMathPath::AVX512})
+	{
+		if (!BatchMath::SetPath(path))
+			continue;
+		double transformBatch = Measure(iterations, [&]()
+										{ BatchMath::TransformPoints(matrix, {xs, ys, zs}, {outXs, outYs, outZs}); gSink = outXs[count - 1]; });
+		double normalizeBatch = Measure(iterations, [&]()
+										{ outXs = xs; outYs = ys; outZs = zs; BatchMath::Normalize(Vector3fStream{outXs, outYs, outZs}); gSink = outXs[count - 1]; });
+		double slerpBatch = Measure(iterations, [&]()
+									{ BatchMath::Slerp({quatA[0], quatA[1], quatA[2], quatA[3]}, {quatB[0], quatB[1], quatB[2], quatB[3]}, factors, {quatOut[0], quatOut[1], quatOut[2], quatOut[3]}); gSink = quatOut[0][count - 1]; });
+
+		const char *pathName = BatchMath::GetPathName(path);
+		Logger::Println("{}", std::format("{:<12}{:>8}{:>12.3f}{:>12.3f}{:>9.2f}x", "transform", pathName, transformAoS, transformBatch, transformAoS / transformBatch));
+		Logger::Println("{}", std::format("{:<12}{:>8}{:>12.3f}{:>12.3f}{:>9.2f}x", "normalize", pathName, normalizeAoS, normalizeBatch, normalizeAoS / normalizeBatch));
+		Logger::Println("{}", std::format("{:<12}{:>8}{:>12.3f}{:>12.3f}{:>9.2f}x", "slerp", pathName, slerpAoS, slerpBatch, slerpAoS / slerpBatch));
+	}
+	BatchMath::SetPath(bestPath);
+
+	// Skinning palettes, the batch quaternion and dual quaternion routines against the scalar operators
+	std::vector<DualQuaternionf> dualsA(count), dualsB(count), dualResults(count);
+	std::vector<float> dualA[8], dualB[8], dualOut[8];
+	for (size_t i = 0; i < 8; ++i)
+	{
+		dualA[i].resize(count);
+		dualB[i].resize(count);
+		dualOut[i].resize(count);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		dualsA[i] = Transform3f::ToDualQuaternion(Transform3f(points[i], quatsA[i], Vector3f(1.0f)));
+		dualsB[i] = Transform3f::ToDualQuaternion(Transform3f(points[count - 1 - i], quatsB[i], Vector3f(1.0f)));
+		for (size_t j = 0; j < 8; ++j)
+		{
+			dualA[j][i] = dualsA[i].v[j];
+			dualB[j][i] = dualsB[i].v[j];
+		}
+	}
+	ConstQuaternionfStream streamA{quatA[0], quatA[1], quatA[2], quatA[3]};
+	ConstQuaternionfStream streamB{quatB[0], quatB[1], quatB[2], quatB[3]};
+	QuaternionfStream streamOut{quatOut[0], quatOut[1], quatOut[2], quatOut[3]};
+	ConstDualQuaternionfStream dualStreamA{{dualA[0], dualA[1], dualA[2], dualA[3]}, {dualA[4], dualA[5], dualA[6], dualA[7]}};
+	ConstDualQuaternionfStream dualStreamB{{dualB[0], dualB[1], dualB[2], dualB[3]}, {dualB[4], dualB[5], dualB[6], dualB[7]}};
+	DualQuaternionfStream dualStreamOut{{dualOut[0], dualOut[1], dualOut[2], dualOut[3]}, {dualOut[4], dualOut[5], dualOut[6], dualOut[7]}};
+
+	auto quatError = [&]()
+	{
+		float error = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+			for (size_t j = 0; j < 4; ++j)
+				error = std::max(error, Math::Abs(quatOut[j][i] - quatResults[i].values[j]));
+		return error;
+	};
+	auto dualError = [&]()
+	{
+		float error = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+			for (size_t j = 0; j < 8; ++j)
+				error = std::max(error, Math::Abs(dualOut[j][i] - dualResults[i].v[j]));
+		return error;
+	};
+	auto matrixError = [&]()
+	{
+		float error = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+			error = std::max(error, MaxError(results[i], matrices[i]));
+		return error;
+	};
+
+	struct SkinningWorkload
+	{
+		const char *name;
+		std::function<void()> scalar;
+		std::function<void()> batch;
+		std::function<float()> error;
+	};
+	std::vector<SkinningWorkload> skinningWorkloads = {
+		{"quat-mul", [&]()
+		 { for (size_t i = 0; i < count; ++i) quatResults[i] = quatsA[i] * quatsB[i]; },
+		 [&]()
+		 { BatchMath::Multiply(streamA, streamB, streamOut); },
+		 quatError},
+		{"nlerp", [&]()
+		 { for (size_t i = 0; i < count; ++i) quatResults[i] = Quaternionf::NLerp(quatsA[i], quatsB[i], factors[i]); },
+		 [&]()
+		 { BatchMath::NLerp(streamA, streamB, factors, streamOut); },
+		 quatError},
+		{"dq-mul", [&]()
+		 { for (size_t i = 0; i < count; ++i) dualResults[i] = dualsA[i] * dualsB[i]; },
+		 [&]()
+		 { BatchMath::Multiply(dualStreamA, dualStreamB, dualStreamOut); },
+		 dualError},
+		{"dq-normalize", [&]()
+		 { for (size_t i = 0; i < count; ++i) dualResults[i] = DualQuaternionf::Normalize(dualsA[i]); },
+		 [&]()
+		 { for (size_t j = 0; j < 8; ++j) dualOut[j] = dualA[j]; BatchMath::Normalize(dualStreamOut); },
+		 dualError},
+		{"dq-to-matrix", [&]()
+		 { for (size_t i = 0; i < count; ++i)
+		   {
+			   Transform3f transform;
+			   transform.rotation = dualsA[i].real;
+			   transform.position = (Quaternionf::Conjugate(dualsA[i].real) * (dualsA[i].dual * 2.0f)).vec;
+			   matrices[i] = Transform3f::ToMatrix4(transform);
+		   } },
+		 [&]()
+		 { BatchMath::ToMatrices(dualStreamA, results); },
+		 matrixError},
+	};
+
+	Logger::Println("");
+	Logger::Println("{} bones, batch path against the scalar operators, milliseconds", count);
+	Logger::Println("{}", std::format("{:<14}{:>8}{:>12}{:>12}{:>10}{:>12}", "workload", "path", "scalar", "batch", "speedup", "max error"));
+	for (const auto &workload : skinningWorkloads)
+	{
+		double scalar = Measure(iterations, [&]()
+								{ workload.scalar(); gSink = quatResults[0].x + dualResults[0].v[0] + matrices[0].elements[0]; });
+		for (BatchMathPath path : {BatchMathPath::SCALAR, BatchMathPath::SSE4, BatchMathPath::AVX2, BatchMathPath::AVX512})
+		{
+			if (!BatchMath::SetPath(path))
+				continue;
+			double batch = Measure(iterations, [&]()
+								   { workload.batch(); gSink = quatOut[0][0] + dualOut[0][0] + results[0].elements[0]; });
+			Logger::Println("{}", std::format("{:<14}{:>8}{:>12.3f}{:>12.3f}{:>9.2f}x{:>12.2e}", workload.name, BatchMath::GetPathName(path), scalar, batch, scalar / batch, workload.error()));
+		}
+	}
+	BatchMath::SetPath(bestPath);
+
+	// FastMath accuracy and speed, inputs spread over the ranges the engine feeds these functions
+	size_t fastCount = Math::RoundUp<size_t>(count, 4);
+	std::vector<float> angles(fastCount), units(fastCount), slopes(fastCount), exponents(fastCount), positives(fastCount), abscissas(fastCount);
+	std::uniform_real_distribution<float> exponentDistribution(-20.0f, 20.0f);
+	for (size_t i = 0; i < fastCount; ++i)
+	{
+		angles[i] = distribution(random) * Math::TWO_PI * 2.0f;
+		units[i] = distribution(random);
+		slopes[i] = distribution(random) * 16.0f;
+		exponents[i] = exponentDistribution(random);
+		positives[i] = std::exp(exponents[i]);
+		abscissas[i] = distribution(random);
+	}
+
+	Logger::Println("");
+	Logger::Println("{} values, FastMath against std, milliseconds, std time over FastMath time", fastCount);
+	Logger::Println("{}", std::format("{:<8}{:>8}{:>10}{:>12}{:>10}{:>10}{:>10}{:>10}{:>10}{:>11}", "function", "level", "error", "max error", "std", "scalar", "float4", "scalar", "float4", "lane diff"));
+	ReportFastMath("sin", false, angles, angles, iterations, [](float x, float) { return Math::Sin(x); }, [](double x, double) { return std::sin(x); }, [](auto precision, auto x, auto) { return FastMath::Sin<decltype(precision)::value>(x); });
+	ReportFastMath("cos", false, angles, angles, iterations, [](float x, float) { return Math::Cos(x); }, [](double x, double) { return std::cos(x); }, [](auto precision, auto x, auto) { return FastMath::Cos<decltype(precision)::value>(x); });
+	ReportFastMath("acos", false, units, units, iterations, [](float x, float) { return Math::ArcCos(x); }, [](double x, double) { return std::acos(x); }, [](auto precision, auto x, auto) { return FastMath::ArcCos<decltype(precision)::value>(x); });
+	ReportFastMath("atan", false, slopes, slopes, iterations, [](float x, float) { return Math::ArcTan(x); }, [](double x, double) { return std::atan(x); }, [](auto precision, auto x, auto) { return FastMath::ArcTan<decltype(precision)::value>(x); });
+	ReportFastMath("atan2", false, units, abscissas, iterations, [](float y, float x) { return Math::ArcTan2(y, x); }, [](double y, double x) { return std::atan2(y, x); }, [](auto precision, auto y, auto x) { return FastMath::ArcTan2<decltype(precision)::value>(y, x); });
+	ReportFastMath("exp", true, exponents, exponents, iterations, [](float x, float) { return std::exp(x); }, [](double x, double) { return std::exp(x); }, [](auto precision, auto x, auto) { return FastMath::Exp<decltype(precision)::value>(x); });
+	ReportFastMath("log", false, positives, positives, iterations, [](float x, float) { return std::log(x); }, [](double x, double) { return std::log(x); }, [](auto precision, auto x, auto) { return FastMath::Log<decltype(precision)::value>(x); });
+	ReportFastMath("rsqrt", true, positives, positives, iterations, [](float x, float) { return 1.0f / Math::Sqrt(x); }, [](double x, double) { return 1.0 / std::sqrt(x); }, [](auto precision, auto x, auto) { return FastMath::RSqrt<decltype(precision)::value>(x); });
+
+	// Random numbers, the per call std distributions the old Random used against the stream fills
+	std::vector<float> randomFloats(count), randomX(count), randomY(count), randomZ(count);
+	std::vector<int32_t> randomInts(count);
+	RandomStream stream(20240601, 0);
+	Vector3fStream randomVectors{randomX, randomY, randomZ};
+
+	struct RandomWorkload
+	{
+		const char *name;
+		std::function<void()> baseline;
+		std::function<void()> stream;
+	};
+	std::vector<RandomWorkload> randomWorkloads = {
+		{"float", [&]()
+		 { std::uniform_real_distribution<float> dis(-1.0f, 1.0f); for (size_t i = 0; i < count; ++i) randomFloats[i] = dis(random); },
+		 [&]()
+		 { stream.FillFloat(randomFloats, -1.0f, 1.0f); }},
+		{"float-call", [&]()
+		 { std::uniform_real_distribution<float> dis(-1.0f, 1.0f); for (size_t i = 0; i < count; ++i) randomFloats[i] = dis(random); },
+		 [&]()
+		 { for (size_t i = 0; i < count; ++i) randomFloats[i] = Random::GetFloat(-1.0f, 1.0f); }},
+		{"int", [&]()
+		 { std::uniform_int_distribution<int32_t> dis(-100, 100); for (size_t i = 0; i < count; ++i) randomInts[i] = dis(random); },
+		 [&]()
+		 { stream.FillInt(randomInts, -100, 100); }},
+		{"unit-vector", [&]()
+		 {
+			 std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+			 for (size_t i = 0; i < count; ++i)
+			 {
+				 Vector3f v;
+				 do
+					 v = Vector3f(dis(random), dis(random), dis(random));
+				 while (v.SquareLength() > 1.0f || v.SquareLength() < 1e-6f);
+				 v = v / v.Length();
+				 randomX[i] = v.x;
+				 randomY[i] = v.y;
+				 randomZ[i] = v.z;
+			 } },
+		 [&]()
+		 { stream.FillUnitVectors(randomVectors); }},
+	};
+
+	Logger::Println("");
+	Logger::Println("{} values, std::mt19937 distributions against RandomStream, milliseconds", count);
+	Logger::Println("{}", std::format("{:<14}{:>12}{:>12}{:>10}", "workload", "mt19937", "stream", "speedup"));
+	for (const auto &workload : randomWorkloads)
+	{
+		double baseline = Measure(iterations, [&]()
+								  { workload.baseline(); gSink = randomFloats[0] + randomX[0] + static_cast<float>(randomInts[0]); });
+		double fill = Measure(iterations, [&]()
+							  { workload.stream(); gSink = randomFloats[0] + randomX[0] + static_cast<float>(randomInts[0]); });
+		Logger::Println("{}", std::format("{:<14}{:>12.3f}{:>12.3f}{:>9.2f}x", workload.name, baseline, fill, baseline / fill));
+	}
+
+	// Fills and single draws consume the same sequence, and every thread owns its stream
+	RandomStream single(7, 3), bulk(7, 3);
+	bulk.NextUInt32();
+	bulk.FillFloat01(randomFloats);
+	single.NextUInt32();
+	bool sequenceMatches = true;
+	float mean = 0.0f, lengthError = 0.0f;
+	for (size_t i = 0; i < count; ++i)
+	{
+		sequenceMatches = sequenceMatches && single.NextFloat01() == randomFloats[i];
+		mean += randomFloats[i] / static_cast<float>(count);
+	}
+	stream.FillUnitVectors(randomVectors);
+	for (size_t i = 0; i < count; ++i)
+		lengthError = std::max(lengthError, Math::Abs(Vector3f(randomX[i], randomY[i], randomZ[i]).Length() - 1.0f));
+	Logger::Println("{}", std::format("fill matches single draws: {}, float01 mean {:.4f}, unit vector length error {:.2e}", sequenceMatches ? "yes" : "no", mean, lengthError));
+
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	double threaded = Measure(iterations, [&]()
+							  {
+								  std::vector<std::thread> threads;
+								  for (uint32_t t = 0; t < threadCount; ++t)
+									  threads.emplace_back([&]()
+														   {
+															   std::vector<float> values(count * 16);
+															   Random::GetThreadStream().FillFloat01(values);
+															   gSink = values[0]; });
+								  for (auto &thread : threads)
+									  thread.join(); });
+	Logger::Println("{}", std::format("{} threads filling {} floats each from their thread streams: {:.3f} ms, {:.0f} M floats/s", threadCount, count * 16, threaded, threadCount * count * 16 / threaded / 1000.0));
+
+	return EXIT_SUCCESS;
+}
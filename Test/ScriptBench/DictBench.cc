@@ -0,0 +1,145 @@
+#include <chrono>
+#include <format>
+#include <random>
+#include <vector>
+#include "Core/String.hpp"
+#include "Core/Logger.hpp"
+#include "Script/Value.hpp"
+#include "Script/ValueDict.hpp"
+#include "Script/Object.hpp"
+
+using namespace RealSix;
+using namespace RealSix::Script;
+
+// Compare ValueDict, the DictObject storage, with the std::unordered_map it replaced
+
+volatile int64_t gSink; // keeps the measured loops from being optimized away
+
+struct MapAdapter
+{
+	void Set(const Value &key, const Value &value) { elements[key] = value; }
+	const Value *Find(const Value &key) const
+	{
+		auto iter = elements.find(key);
+		return iter == elements.end() ? nullptr : &iter->second;
+	}
+	void Erase(const Value &key) { elements.erase(key); }
+	size_t Size() const { return elements.size(); }
+
+	ValueUnorderedMap elements;
+};
+
+struct DictAdapter
+{
+	void Set(const Value &key, const Value &value) { elements.Set(key, value); }
+	const Value *Find(const Value &key) const { return elements.Find(key); }
+	void Erase(const Value &key) { elements.Erase(key); }
+	size_t Size() const { return elements.Size(); }
+
+	ValueDict elements;
+};
+
+template <typename Fn>
+double Measure(uint32_t iterations, Fn &&fn)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+// Best time of each workload in milliseconds: insert, lookup hit, lookup miss, erase, insert/erase churn, iterate
+template <typename Table>
+std::vector<double> RunWorkloads(const std::vector<Value> &keys, const std::vector<Value> &missKeys, uint32_t iterations)
+{
+	std::vector<double> result;
+	int64_t checksum = 0;
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									Table table;
+									for (size_t i = 0; i < keys.size(); ++i)
+										table.Set(keys[i], Value((int64_t)i));
+									checksum += table.Size(); }));
+
+	Table table;
+	for (size_t i = 0; i < keys.size(); ++i)
+		table.Set(keys[i], Value((int64_t)i));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (const auto &key : keys)
+										checksum += table.Find(key)->integer; }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (const auto &key : missKeys)
+										checksum += table.Find(key) != nullptr; }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									Table copy;
+									for (size_t i = 0; i < keys.size(); ++i)
+										copy.Set(keys[i], Value((int64_t)i));
+									for (const auto &key : keys)
+										copy.Erase(key);
+									checksum += copy.Size(); }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									Table window;
+									size_t windowSize = std::max<size_t>(keys.size() / 16, 1);
+									for (size_t i = 0; i < keys.size(); ++i)
+									{
+										window.Set(keys[i], Value((int64_t)i));
+										if (i >= windowSize)
+											window.Erase(keys[i - windowSize]);
+									}
+									checksum += window.Size(); }));
+
+	result.emplace_back(Measure(iterations, [&]()
+								{
+									for (const auto &[k, v] : table.elements)
+										checksum += v.integer; }));
+
+	gSink = checksum;
+	return result;
+}
+
+int32_t main(int32_t argc, const char *argv[])
+{
+	size_t count = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 200000;
+	uint32_t iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 5;
+
+	std::mt19937_64 random(20240601);
+	std::vector<Value> intKeys, intMissKeys, strKeys, strMissKeys;
+	for (size_t i = 0; i < count; ++i)
+	{
+		intKeys.emplace_back(Value((int64_t)(random() >> 1)));
+		intMissKeys.emplace_back(Value((int64_t)(random() >> 1)));
+		strKeys.emplace_back(Value(new StrObject(String(std::format("key_{}", i)))));
+		strMissKeys.emplace_back(Value(new StrObject(String(std::format("miss_{}", i)))));
+	}
+
+	const char *workloadNames[] = {"insert", "lookup", "miss", "erase", "churn", "iterate"};
+
+	Logger::Println("{} keys, best of {} runs, milliseconds", count, iterations);
+	Logger::Println("{}", std::format("{:<10}{:>12}{:>12}{:>10}{:>12}{:>12}{:>10}", "workload", "int map", "int dict", "speedup", "str map", "str dict", "speedup"));
+
+	auto intMap = RunWorkloads<MapAdapter>(intKeys, intMissKeys, iterations);
+	auto intDict = RunWorkloads<DictAdapter>(intKeys, intMissKeys, iterations);
+	auto strMap = RunWorkloads<MapAdapter>(strKeys, strMissKeys, iterations);
+	auto strDict = RunWorkloads<DictAdapter>(strKeys, strMissKeys, iterations);
+
+	for (size_t i = 0; i < std::size(workloadNames); ++i)
+		Logger::Println("{}", std::format("{:<10}{:>12.3f}{:>12.3f}{:>9.2f}x{:>12.3f}{:>12.3f}{:>9.2f}x", workloadNames[i],
+										  intMap[i], intDict[i], intMap[i] / intDict[i],
+										  strMap[i], strDict[i], strMap[i] / strDict[i]));
+
+	return EXIT_SUCCESS;
+}
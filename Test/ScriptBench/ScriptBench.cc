@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <vector>
+#include "Version.hpp"
+#include "Core/String.hpp"
+#include "Core/Logger.hpp"
+#include "Resource/FileSystem.hpp"
+#include "Script/Token.hpp"
+#include "Script/Ast.hpp"
+#include "Script/Lexer.hpp"
+#include "Script/Parser.hpp"
+#include "Script/AstPass.hpp"
+#include "Script/ConstantFoldPass.hpp"
+#include "Script/TypeCheckAndResolvePass.hpp"
+#include "Script/SyntaxCheckPass.hpp"
+#include "Script/Compiler.hpp"
+#include "Script/VM.hpp"
+#include "Script/Context.hpp"
+
+using namespace RealSix;
+
+#if defined(_WIN32) || defined(_WIN64)
+#pragma warning(disable : 4996)
+#endif
+
+enum Phase
+{
+	PHASE_LEX = 0,
+	PHASE_PARSE,
+	PHASE_PASS,
+	PHASE_COMPILE,
+	PHASE_EXECUTE,
+	PHASE_TOTAL,
+	PHASE_COUNT,
+};
+
+constexpr const char *gPhaseNames[PHASE_COUNT] = {"lex", "parse", "pass", "compile", "execute", "total"};
+
+struct PhaseStats
+{
+	double min{0.0};
+	double mean{0.0};
+	double max{0.0};
+};
+
+struct BenchResult
+{
+	String name;
+	PhaseStats phases[PHASE_COUNT];
+};
+
+struct BenchConfig
+{
+	uint32_t iterations{5};
+	uint32_t warmup{1};
+	String scriptDir{BENCH_SCRIPT_DIR};
+	String outputPath{"ScriptBench.json"};
+	String filter;
+};
+
+BenchConfig gConfig;
+
+Script::Lexer *gLexer{nullptr};
+Script::Parser *gParser{nullptr};
+
+Script::AstPassManager *gAstPassManager{nullptr};
+
+Script::Compiler *gCompiler{nullptr};
+Script::VM *gVm{nullptr};
+
+int32_t PrintUsage()
+{
+	REALSIX_LOG_INFO("Usage: ScriptBench [option]:");
+	REALSIX_LOG_INFO("-h or --help:show usage info.");
+	REALSIX_LOG_INFO("-n or --iterations <count>:timed runs per script, 5 by default.");
+	REALSIX_LOG_INFO("-w or --warmup <count>:untimed runs per script before timing, 1 by default.");
+	REALSIX_LOG_INFO("-d or --dir <path>:directory of the .r6 benchmark scripts, the bundled scripts directory by default.");
+	REALSIX_LOG_INFO("-f or --filter <text>:only run scripts whose file name contains <text>.");
+	REALSIX_LOG_INFO("-o or --output <file>:write the json results to <file>, ScriptBench.json by default.");
+	return EXIT_FAILURE;
+}
+
+int32_t ParseArgs(int32_t argc, const char *argv[])
+{
+	for (int32_t i = 1; i < argc; ++i)
+	{
+		StringView arg = argv[i];
+		if (arg == "-n" || arg == "--iterations")
+		{
+			if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+				gConfig.iterations = static_cast<uint32_t>(std::atoi(argv[++i]));
+			else
+				return PrintUsage();
+		}
+		else if (arg == "-w" || arg == "--warmup")
+		{
+			if (i + 1 < argc && std::atoi(argv[i + 1]) >= 0)
+				gConfig.warmup = static_cast<uint32_t>(std::atoi(argv[++i]));
+			else
+				return PrintUsage();
+		}
+		else if (arg == "-d" || arg == "--dir")
+		{
+			if (i + 1 < argc)
+				gConfig.scriptDir = argv[++i];
+			else
+				return PrintUsage();
+		}
+		else if (arg == "-f" || arg == "--filter")
+		{
+			if (i + 1 < argc)
+				gConfig.filter = argv[++i];
+			else
+				return PrintUsage();
+		}
+		else if (arg == "-o" || arg == "--output")
+		{
+			if (i + 1 < argc)
+				gConfig.outputPath = argv[++i];
+			else
+				return PrintUsage();
+		}
+		else
+			return PrintUsage();
+	}
+
+	return EXIT_SUCCESS;
+}
+
+std::vector<String> CollectScripts()
+{
+	std::vector<String> result;
+	std::error_code error;
+	for (const auto &entry : std::filesystem::directory_iterator(gConfig.scriptDir.CString(), error))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() != ".r6")
+			continue;
+
+		auto fileName = entry.path().filename().string();
+		if (!gConfig.filter.Empty() && fileName.find(gConfig.filter.CString()) == std::string::npos)
+			continue;
+
+		result.emplace_back(String(entry.path().string()));
+	}
+
+	if (error)
+		REALSIX_LOG_ERROR("Failed to open benchmark script directory: {}", gConfig.scriptDir);
+
+	std::sort(result.begin(), result.end(), [](const String &left, const String &right)
+			  { return std::strcmp(left.CString(), right.CString()) < 0; });
+	return result;
+}
+
+// Run every front end and back end stage once, storing each stage's wall time in milliseconds
+void RunOnce(StringView content, StringView path, double (&timings)[PHASE_COUNT])
+{
+	using Clock = std::chrono::steady_clock;
+	auto elapsed = [](Clock::time_point begin)
+	{ return std::chrono::duration<double, std::milli>(Clock::now() - begin).count(); };
+
+	auto begin = Clock::now();
+	const auto &tokens = gLexer->ScanTokens(content, path);
+	timings[PHASE_LEX] = elapsed(begin);
+
+	begin = Clock::now();
+	auto stmt = gParser->Parse(tokens);
+	timings[PHASE_PARSE] = elapsed(begin);
+
+	begin = Clock::now();
+	stmt = gAstPassManager->Execute(stmt);
+	timings[PHASE_PASS] = elapsed(begin);
+
+	begin = Clock::now();
+	auto mainFunc = gCompiler->Compile(stmt);
+	timings[PHASE_COMPILE] = elapsed(begin);
+
+	begin = Clock::now();
+	gVm->Run(mainFunc);
+	timings[PHASE_EXECUTE] = elapsed(begin);
+
+	timings[PHASE_TOTAL] = 0.0;
+	for (int32_t phase = PHASE_LEX; phase < PHASE_TOTAL; ++phase)
+		timings[PHASE_TOTAL] += timings[phase];
+}
+
+BenchResult RunBench(StringView path)
+{
+	BenchResult result;
+	result.name = String(std::filesystem::path(path.CString()).stem().string());
+
+	String content = FileSystem::ReadUnicodeTextFile(path);
+
+	double timings[PHASE_COUNT];
+	for (uint32_t i = 0; i < gConfig.warmup; ++i)
+		RunOnce(content, path, timings);
+
+	for (uint32_t i = 0; i < gConfig.iterations; ++i)
+	{
+		RunOnce(content, path, timings);
+		for (int32_t phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			auto &stats = result.phases[phase];
+			stats.min = i == 0 ? timings[phase] : std::min(stats.min, timings[phase]);
+			stats.max = i == 0 ? timings[phase] : std::max(stats.max, timings[phase]);
+			stats.mean += timings[phase] / gConfig.iterations;
+		}
+	}
+
+	return result;
+}
+
+String ToJson(const std::vector<BenchResult> &results)
+{
+	String json = std::format("{{\n  \"version\": \"{}\",\n  \"iterations\": {},\n  \"warmup\": {},\n  \"unit\": \"ms\",\n  \"benchmarks\": [", REALSIX_VERSION, gConfig.iterations, gConfig.warmup);
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		json += std::format("{}\n    {{\n      \"name\": \"{}\",\n      \"phases\": {{", i == 0 ? "" : ",", results[i].name);
+		for (int32_t phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			const auto &stats = results[i].phases[phase];
+			json += std::format("{}\n        \"{}\": {{ \"min\": {:.6f}, \"mean\": {:.6f}, \"max\": {:.6f} }}", phase == 0 ? "" : ",", gPhaseNames[phase], stats.min, stats.mean, stats.max);
+		}
+		json += "\n      }\n    }";
+	}
+	json += "\n  ]\n}\n";
+	return json;
+}
+
+void PrintTable(const std::vector<BenchResult> &results)
+{
+	String header = std::format("{:<20}", "benchmark (mean ms)");
+	for (int32_t phase = 0; phase < PHASE_COUNT; ++phase)
+		header += std::format("{:>12}", gPhaseNames[phase]);
+	Logger::Println("{}", header);
+
+	for (const auto &result : results)
+	{
+		String line = std::format("{:<20}", result.name.CString());
+		for (int32_t phase = 0; phase < PHASE_COUNT; ++phase)
+			line += std::format("{:>12.3f}", result.phases[phase].mean);
+		Logger::Println("{}", line);
+	}
+}
+
+int32_t main(int32_t argc, const char *argv[])
+{
+#if defined(_WIN32) || defined(_WIN64)
+	system("chcp 65001");
+#endif
+	if (ParseArgs(argc, argv) == EXIT_FAILURE)
+		return EXIT_FAILURE;
+
+	Script::Context::GetInstance().Init();
+
+	gLexer = new Script::Lexer();
+	gParser = new Script::Parser();
+	gAstPassManager = new Script::AstPassManager();
+	gCompiler = new Script::Compiler();
+	gVm = new Script::VM();
+
+	gAstPassManager
+		->Add<Script::ConstantFoldPass>()
+		->Add<Script::SyntaxCheckPass>()
+		->Add<Script::TypeCheckAndResolvePass>();
+
+	std::vector<BenchResult> results;
+	for (const auto &path : CollectScripts())
+		results.emplace_back(RunBench(path));
+
+	PrintTable(results);
+	FileSystem::WriteBinaryFile(gConfig.outputPath, ToJson(results));
+	REALSIX_LOG_INFO("Wrote {} benchmark results to {}", results.size(), gConfig.outputPath);
+
+	SAFE_DELETE(gLexer);
+	SAFE_DELETE(gParser);
+	SAFE_DELETE(gAstPassManager);
+	SAFE_DELETE(gCompiler);
+	SAFE_DELETE(gVm);
+
+	Script::Context::GetInstance().CleanUp();
+
+	return EXIT_SUCCESS;
+}
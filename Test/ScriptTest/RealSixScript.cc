@@ -44,7 +44,12 @@ int32_t PrintUsage()
 	REALSIX_LOG_INFO("-v or --version:show current RealSix version");
 	REALSIX_LOG_INFO("-s or --serialize: serialize source file as bytecode binary file");
 	REALSIX_LOG_INFO("-f or --file:run source file with a valid file path,like : RealSix -f examples/array.cd.");
+	REALSIX_LOG_INFO("-b or --binary:run a serialized bytecode binary file in place through memory mapping.");
 	REALSIX_LOG_INFO("--function-cache:use function cache optimize.");
+	REALSIX_LOG_INFO("-p or --profile <file>:sample the running script and write collapsed call stacks for flamegraph tools.");
+	REALSIX_LOG_INFO("--profile-interval <count>:take a profile sample every <count> instructions, 1000 by default.");
+	REALSIX_LOG_INFO("--budget <count>:suspend the script every <count> loop back-edges and calls, then continue it like on the next frame.");
+	REALSIX_LOG_INFO("--time-budget <ms>:suspend the script after running for <ms> milliseconds, then continue it like on the next frame.");
 #ifndef NDEBUG
 	REALSIX_LOG_INFO("--gc-debug:debug gc.");
 	REALSIX_LOG_INFO("--gc-stress:stressing gc.");
@@ -53,6 +58,17 @@ int32_t PrintUsage()
 	return EXIT_FAILURE;
 }
 
+// A script suspended by its execution budget continues slice by slice, like a game continuing it once per frame
+void RunToEnd()
+{
+	uint64_t sliceCount = 1;
+	for (; gVm->IsSuspended(); ++sliceCount)
+		gVm->Continue();
+
+	if (ScriptConfig::GetInstance().GetCheckpointBudget() > 0 || ScriptConfig::GetInstance().GetTimeBudget() > 0.0)
+		REALSIX_LOG_INFO("Finished in {} slices.", sliceCount);
+}
+
 void Run( StringView content)
 {
 	auto tokens = gLexer->ScanTokens(content);
@@ -87,6 +103,7 @@ void Run( StringView content)
 	else
 	{
 		gVm->Run(mainFunc);
+		RunToEnd();
 	}
 }
 
@@ -125,6 +142,19 @@ void RunFile(StringView path)
 	Run(content);
 }
 
+void RunBinaryFile(StringView path)
+{
+	FileSystem::MappedFile file(path);
+	if (!file.IsValid())
+		return;
+
+	// The bytecode executes directly from the mapping, which stays alive until the vm returns
+	auto mainFunc = new Script::FunctionObject(MAIN_ENTRY_FUNCTION_NAME);
+	mainFunc->chunk.Deserialize(file.GetData(), file.GetSize());
+	gVm->Run(mainFunc);
+	RunToEnd();
+}
+
 int32_t ParseArgs(int32_t argc, const char *argv[])
 {
 	for (size_t i = 0; i < argc; ++i)
@@ -138,6 +168,17 @@ int32_t ParseArgs(int32_t argc, const char *argv[])
 				return PrintUsage();
 		}
 
+		if (arg == "-b" || arg == "--binary")
+		{
+			if (i + 1 < argc)
+			{
+				ScriptConfig::GetInstance().SetExecuteBinaryChunk(true);
+				ScriptConfig::GetInstance().SetExecuteFilePath(argv[++i]);
+			}
+			else
+				return PrintUsage();
+		}
+
 		if (arg == "-s" || arg == "--serialize")
 		{
 			if (i + 1 < argc)
@@ -151,6 +192,41 @@ int32_t ParseArgs(int32_t argc, const char *argv[])
 		if (arg == "--function-cache")
 			ScriptConfig::GetInstance().SetUseFunctionCache(true);
 
+		if (arg == "-p" || arg == "--profile")
+		{
+			if (i + 1 < argc)
+			{
+				ScriptConfig::GetInstance().SetProfile(true);
+				ScriptConfig::GetInstance().SetProfileFilePath(argv[++i]);
+			}
+			else
+				return PrintUsage();
+		}
+
+		if (arg == "--profile-interval")
+		{
+			if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+				ScriptConfig::GetInstance().SetProfileSampleInterval(static_cast<uint32_t>(std::atoi(argv[++i])));
+			else
+				return PrintUsage();
+		}
+
+		if (arg == "--budget")
+		{
+			if (i + 1 < argc && std::atoll(argv[i + 1]) > 0)
+				ScriptConfig::GetInstance().SetCheckpointBudget(static_cast<uint64_t>(std::atoll(argv[++i])));
+			else
+				return PrintUsage();
+		}
+
+		if (arg == "--time-budget")
+		{
+			if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0)
+				ScriptConfig::GetInstance().SetTimeBudget(std::atof(argv[++i]));
+			else
+				return PrintUsage();
+		}
+
 		if (arg == "-h" || arg == "--help")
 			return PrintUsage();
 
@@ -182,7 +258,9 @@ int32_t main(int32_t argc, const char *argv[])
 		->Add<Script::SyntaxCheckPass>()
 		->Add<Script::TypeCheckAndResolvePass>();
 
-	if (!ScriptConfig::GetInstance().GetExecuteFilePath().Empty())
+	if (ScriptConfig::GetInstance().IsExecuteBinaryChunk())
+		RunBinaryFile(ScriptConfig::GetInstance().GetExecuteFilePath());
+	else if (!ScriptConfig::GetInstance().GetExecuteFilePath().Empty())
 		RunFile(ScriptConfig::GetInstance().GetExecuteFilePath());
 	else
 		Repl();